@@ -0,0 +1,266 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ae
+{
+// Identifies one subscription. Handles are unique across all delegates and 0 is never handed out.
+using DelegateHandle = uint64_t;
+
+inline DelegateHandle NextDelegateHandle()
+{
+    static std::atomic<DelegateHandle> s_NextHandle = 1;
+    return s_NextHandle.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename Signature> class Delegate;
+
+// Multicast callback list. Callables live in a fixed buffer inside their subscription, so neither subscribing nor
+// invoking allocates for the callable; callables that do not fit fail to compile. Subscriptions added or removed
+// from within Invoke take effect once the outermost Invoke returns. Not thread-safe.
+template <typename R, typename... Args> class Delegate<R(Args...)>
+{
+  public:
+    static constexpr size_t s_StorageSize = 48;
+
+    Delegate() = default;
+    Delegate(const Delegate &) = delete;
+    Delegate &operator=(const Delegate &) = delete;
+    ~Delegate() = default;
+
+    template <typename F> DelegateHandle Add(F &&callable)
+    {
+        Slot slot(std::forward<F>(callable));
+        DelegateHandle handle = slot.handle;
+
+        (m_InvokeDepth > 0 ? m_PendingSlots : m_Slots).push_back(std::move(slot));
+
+        return handle;
+    }
+
+    // Replaces every subscription; nullptr only clears
+    template <typename F> DelegateHandle Set(F &&callable)
+    {
+        Clear();
+
+        if constexpr (std::is_null_pointer_v<std::remove_cvref_t<F>>)
+        {
+            return 0;
+        }
+        else
+        {
+            return Add(std::forward<F>(callable));
+        }
+    }
+
+    bool Remove(DelegateHandle handle)
+    {
+        auto matches = [handle](const Slot &slot) { return slot.handle == handle; };
+
+        if (std::erase_if(m_PendingSlots, matches) > 0)
+        {
+            return true;
+        }
+
+        auto it = std::find_if(m_Slots.begin(), m_Slots.end(), matches);
+
+        if (it == m_Slots.end() || handle == 0)
+        {
+            return false;
+        }
+
+        if (m_InvokeDepth > 0)
+        {
+            it->handle = 0;
+        }
+        else
+        {
+            m_Slots.erase(it);
+        }
+
+        return true;
+    }
+
+    void Clear()
+    {
+        m_PendingSlots.clear();
+
+        if (m_InvokeDepth > 0)
+        {
+            for (Slot &slot : m_Slots)
+            {
+                slot.handle = 0;
+            }
+        }
+        else
+        {
+            m_Slots.clear();
+        }
+    }
+
+    [[nodiscard]] inline bool IsEmpty() const
+    {
+        return m_PendingSlots.empty() &&
+               std::none_of(m_Slots.begin(), m_Slots.end(), [](const Slot &slot) { return slot.handle != 0; });
+    }
+
+    void Invoke(Args... args)
+    {
+        if (m_Slots.empty())
+        {
+            return;
+        }
+
+        InvokeScope scope(*this);
+
+        // Adds go to the pending list meanwhile, so the slots do not move under a running callable
+        for (Slot &slot : m_Slots)
+        {
+            if (slot.handle != 0)
+            {
+                slot.invoke(slot.storage, args...);
+            }
+        }
+    }
+
+    // Invokes every subscription and returns whether all of them returned true, which an empty delegate does
+    bool InvokeAll(Args... args)
+        requires std::is_same_v<R, bool>
+    {
+        bool all = true;
+
+        if (m_Slots.empty())
+        {
+            return all;
+        }
+
+        InvokeScope scope(*this);
+
+        for (Slot &slot : m_Slots)
+        {
+            if (slot.handle != 0 && !slot.invoke(slot.storage, args...))
+            {
+                all = false;
+            }
+        }
+
+        return all;
+    }
+
+  private:
+    struct Slot
+    {
+        template <typename F> explicit Slot(F &&callable) : handle(NextDelegateHandle())
+        {
+            using Callable = std::decay_t<F>;
+
+            static_assert(sizeof(Callable) <= s_StorageSize,
+                          "Callable does not fit in Delegate storage, capture less or capture by reference");
+            static_assert(alignof(Callable) <= alignof(std::max_align_t), "Callable is over-aligned for Delegate");
+            static_assert(std::is_nothrow_move_constructible_v<Callable>,
+                          "Delegate callables must move without throwing");
+            static_assert(std::is_invocable_r_v<R, Callable &, Args &...>,
+                          "Callable does not match the Delegate signature");
+
+            new (storage) Callable(std::forward<F>(callable));
+
+            invoke = [](void *pCallable, Args &...invokeArgs) -> R
+            { return static_cast<R>((*static_cast<Callable *>(pCallable))(invokeArgs...)); };
+
+            relocate = [](void *pDestination, void *pSource)
+            {
+                Callable *pCallable = static_cast<Callable *>(pSource);
+
+                if (pDestination)
+                {
+                    new (pDestination) Callable(std::move(*pCallable));
+                }
+
+                pCallable->~Callable();
+            };
+        }
+
+        Slot(Slot &&other) noexcept : invoke(other.invoke), relocate(other.relocate), handle(other.handle)
+        {
+            relocate(storage, other.storage);
+            other.relocate = nullptr;
+        }
+
+        Slot &operator=(Slot &&other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+
+                invoke = other.invoke;
+                relocate = other.relocate;
+                handle = other.handle;
+
+                relocate(storage, other.storage);
+                other.relocate = nullptr;
+            }
+
+            return *this;
+        }
+
+        ~Slot()
+        {
+            Reset();
+        }
+
+        void Reset()
+        {
+            if (relocate)
+            {
+                relocate(nullptr, storage);
+                relocate = nullptr;
+            }
+        }
+
+        alignas(std::max_align_t) std::byte storage[s_StorageSize];
+        R (*invoke)(void *, Args &...) = nullptr;
+        void (*relocate)(void *, void *) = nullptr;
+        DelegateHandle handle = 0;
+    };
+
+    // Applies removals and pending adds once the outermost invocation is done, even if a callable throws
+    struct InvokeScope
+    {
+        explicit InvokeScope(Delegate &delegate) : delegate(delegate)
+        {
+            delegate.m_InvokeDepth++;
+        }
+
+        ~InvokeScope()
+        {
+            if (--delegate.m_InvokeDepth > 0)
+            {
+                return;
+            }
+
+            std::erase_if(delegate.m_Slots, [](const Slot &slot) { return slot.handle == 0; });
+
+            for (Slot &slot : delegate.m_PendingSlots)
+            {
+                delegate.m_Slots.push_back(std::move(slot));
+            }
+
+            delegate.m_PendingSlots.clear();
+        }
+
+        Delegate &delegate;
+    };
+
+  private:
+    std::vector<Slot> m_Slots;
+    std::vector<Slot> m_PendingSlots;
+    uint32_t m_InvokeDepth = 0;
+};
+} // namespace ae
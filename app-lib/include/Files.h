@@ -5,6 +5,7 @@
 #include <cstdio>
 #include <memory>
 #include <nlohmann/json.hpp>
+#include <span>
 #include <stdint.h>
 #include <string>
 #include <string_view>
@@ -123,12 +124,29 @@ class BinaryFile : public File
 
     void SetData(std::vector<uint8_t> data);
 
+    // Maps the file read-only instead of copying it. The contents are then only available through GetView,
+    // which stays valid while this BinaryFile (or a copy of it, which shares the mapping) exists.
+    BinaryFile &Map();
+
+    // The mapped contents after Map, the data otherwise
+    [[nodiscard]] inline std::span<const uint8_t> GetView() const
+    {
+        return m_pMapping ? m_MappedView : std::span<const uint8_t>(m_Data);
+    }
+
+    [[nodiscard]] inline bool IsMapped() const
+    {
+        return m_pMapping != nullptr;
+    }
+
   protected:
     void ReadImpl() override;
     void WriteImpl() override;
 
   private:
     std::vector<uint8_t> m_Data;
+    std::shared_ptr<const void> m_pMapping;
+    std::span<const uint8_t> m_MappedView;
 };
 
 template <typename T> class ImageFile : public File
@@ -141,6 +159,7 @@ template <typename T> class ImageFile : public File
     ImageFile(const std::string &path);
     ImageFile(T *pData, uint32_t width, uint32_t height, uint32_t channels);
     ImageFile(const std::vector<T> &data, uint32_t width, uint32_t height, uint32_t channels);
+    ImageFile(std::vector<T> &&data, uint32_t width, uint32_t height, uint32_t channels);
     ~ImageFile() override = default;
 
     [[nodiscard]] inline uint32_t GetWidth() const
@@ -10,11 +10,60 @@
 
 #include <vulkan/vulkan.h>
 
+#include <array>
 #include <cstdint>
+#include <vector>
 #include <vk_mem_alloc.h>
 
 namespace ae
 {
+enum class VulkanMemoryCategory : uint8_t
+{
+    BUFFER = 0,
+    IMAGE,
+    STAGING,
+    OTHER,
+    COUNT
+};
+
+struct VulkanMemoryCategoryStats
+{
+    uint64_t allocationCount;
+    uint64_t allocationBytes;
+};
+
+// Live allocations made through the VulkanCreate* helpers, grouped by the category they were tagged with
+struct VulkanMemoryStats
+{
+    std::array<VulkanMemoryCategoryStats, static_cast<size_t>(VulkanMemoryCategory::COUNT)> categories;
+    uint64_t totalAllocationCount;
+    uint64_t totalAllocationBytes;
+};
+
+// Per-heap usage as reported by VMA. Usage and budget come from VK_EXT_memory_budget when the device
+// supports it, otherwise they are estimates based on the heap size.
+struct VulkanHeapBudget
+{
+    uint32_t heapIndex;
+    VkMemoryHeapFlags flags;
+    uint64_t blockCount;
+    uint64_t allocationCount;
+    uint64_t blockBytes;
+    uint64_t allocationBytes;
+    uint64_t usage;
+    uint64_t budget;
+};
+
+// Hardware queues created by the library. Compute and transfer fall back to a queue of a more general
+// family when the device has no dedicated one, in which case the types share a VkQueue and its lock.
+enum class VulkanQueueType : uint8_t
+{
+    GRAPHICS = 0,
+    COMPUTE,
+    TRANSFER,
+    COUNT
+};
+
 struct VulkanResources
 {
     VkInstance instance;
@@ -22,6 +71,16 @@ struct VulkanResources
     VkDevice device;
     VkQueue graphicsQueue;
     uint32_t graphicsQueueFamilyIndex;
+    VkQueue computeQueue;
+    uint32_t computeQueueFamilyIndex;
+    VkQueue transferQueue;
+    uint32_t transferQueueFamilyIndex;
+    VkPipelineCache pipelineCache;
+    VmaAllocator allocator;
+    // Null unless the window requested DeviceFeature::TimelineSemaphore. The frame timeline reaches frame
+    // number N once frame N's GPU work has completed.
+    VkSemaphore frameTimelineSemaphore;
+    VkSemaphore hostTimelineSemaphore;
 
     VkFormat swapchainFormat;
     VkExtent2D swapchainExtent;
@@ -32,6 +91,22 @@ struct VulkanResources
 
 uint32_t VulkanFindMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties);
 
+// Allocation helpers over the library-wide VmaAllocator (VulkanResources::allocator). The allocation's
+// pUserData is used to track the category and must not be overwritten.
+VkResult VulkanCreateBuffer(VmaAllocator allocator, const VkBufferCreateInfo &bufferInfo,
+                            const VmaAllocationCreateInfo &allocationInfo, VulkanMemoryCategory category,
+                            VkBuffer *pBuffer, VmaAllocation *pAllocation,
+                            VmaAllocationInfo *pAllocationInfo = nullptr);
+void VulkanDestroyBuffer(VmaAllocator allocator, VkBuffer buffer, VmaAllocation allocation);
+
+VkResult VulkanCreateImage(VmaAllocator allocator, const VkImageCreateInfo &imageInfo,
+                           const VmaAllocationCreateInfo &allocationInfo, VulkanMemoryCategory category,
+                           VkImage *pImage, VmaAllocation *pAllocation, VmaAllocationInfo *pAllocationInfo = nullptr);
+void VulkanDestroyImage(VmaAllocator allocator, VkImage image, VmaAllocation allocation);
+
+VulkanMemoryStats VulkanGetMemoryStats();
+std::vector<VulkanHeapBudget> VulkanGetMemoryBudgets(VmaAllocator allocator);
+
 void VulkanCheckResult(VkResult result, const std::string &call, const std::string &file, uint32_t line);
 } // namespace ae
 
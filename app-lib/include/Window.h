@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Delegate.h"
 #include "Event.h"
 #include "Layer.h"
 #include "Log.h"
@@ -8,17 +9,27 @@
 #include <glad/glad.h>
 
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <bitset>
 #include <cstdint>
 #include <functional>
 #include <glm.hpp>
 #include <memory>
-#include <sstream>
+#include <mutex>
+#include <span>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace ae
 {
 
+// HEADLESS windows are never shown. With Vulkan they have no surface or swapchain and render into offscreen
+// targets, so they also run without a display server (GLFW then uses its null platform).
 enum class WindowType : uint8_t
 {
     WINDOWED = 0,
@@ -32,6 +43,33 @@ enum class GraphicsAPI : uint8_t
     VULKAN
 };
 
+// Vulkan presentation modes, in the order of WindowDesc::presentModes preference. FIFO is always supported
+// and is used when none of the preferred modes are.
+enum class PresentMode : uint8_t
+{
+    IMMEDIATE = 0,
+    MAILBOX,
+    FIFO,
+    FIFO_RELAXED
+};
+
+// Where queued input is dispatched. GLFW callbacks only record input into a per-window queue; with BEGIN_FRAME
+// the records are dispatched right after polling in BeginFrame, with MANUAL whenever DispatchInput is called,
+// for example once per fixed simulation step. MANUAL still dispatches on the thread that runs BeginFrame.
+enum class InputDispatch : uint8_t
+{
+    BEGIN_FRAME = 0,
+    MANUAL
+};
+
+// How fast a replayed input recording is played back. FIXED paces every frame to the delta time it had when it
+// was recorded, AS_FAST_AS_POSSIBLE runs frames back to back while the app still sees the recorded delta times.
+enum class ReplayTiming : uint8_t
+{
+    FIXED = 0,
+    AS_FAST_AS_POSSIBLE
+};
+
 enum class DeviceFeature : uint64_t
 {
     None = 0,
@@ -68,6 +106,9 @@ enum class DeviceFeature : uint64_t
     DescriptorIndexing = 1ull << 24,
     BufferDeviceAddress = 1ull << 25,
     ScalarBlockLayout = 1ull << 26,
+
+    // Presentation (VK_KHR_present_id + VK_KHR_present_wait)
+    PresentWait = 1ull << 27,
 };
 
 // Type-safe set of DeviceFeature flags. Combined values are held as a plain integer here, never
@@ -133,10 +174,21 @@ struct WindowDesc
     GraphicsAPI graphicsAPI;
     DeviceFeatures features;
 
+    // Vulkan only. Present modes are tried in order; empty means MAILBOX, then FIFO. A swapchain image count
+    // of 0 picks one more than the surface minimum. With DeviceFeature::PresentWait, a non-zero
+    // maxQueuedPresents makes BeginFrame wait until at most that many presents are still pending, which caps
+    // how far the CPU runs ahead of the display and enables present latency measurement.
+    std::vector<PresentMode> presentModes;
+    uint32_t swapchainImageCount;
+    uint32_t maxQueuedPresents;
+
+    InputDispatch inputDispatch;
+
     constexpr WindowDesc()
         : title("Untitled"), width(1280), height(720), resizable(true), minimizable(true), minimized(false),
           maximizable(true), maximized(false), monitor(0), vsync(true), fps(60), framesInFlight(2),
-          type(WindowType::WINDOWED), graphicsAPI(GraphicsAPI::OPENGL)
+          type(WindowType::WINDOWED), graphicsAPI(GraphicsAPI::OPENGL), swapchainImageCount(0), maxQueuedPresents(0),
+          inputDispatch(InputDispatch::BEGIN_FRAME)
     {
     }
 
@@ -145,7 +197,8 @@ struct WindowDesc
                uint32_t framesInFlight, WindowType type, GraphicsAPI graphicsAPI, DeviceFeatures features = {})
         : title(title), width(width), height(height), resizable(resizable), minimizable(minimizable),
           minimized(minimized), maximizable(maximizable), maximized(maximized), monitor(monitor), vsync(vsync),
-          fps(fps), framesInFlight(framesInFlight), type(type), graphicsAPI(graphicsAPI), features(features)
+          fps(fps), framesInFlight(framesInFlight), type(type), graphicsAPI(graphicsAPI), features(features),
+          swapchainImageCount(0), maxQueuedPresents(0), inputDispatch(InputDispatch::BEGIN_FRAME)
     {
     }
 
@@ -153,7 +206,8 @@ struct WindowDesc
                uint32_t framesInFlight, WindowType type, GraphicsAPI graphicsAPI, DeviceFeatures features = {})
         : title(title), width(width), height(height), resizable(false), minimizable(false), minimized(false),
           maximizable(false), maximized(false), monitor(monitor), vsync(vsync), fps(fps),
-          framesInFlight(framesInFlight), type(type), graphicsAPI(graphicsAPI), features(features)
+          framesInFlight(framesInFlight), type(type), graphicsAPI(graphicsAPI), features(features),
+          swapchainImageCount(0), maxQueuedPresents(0), inputDispatch(InputDispatch::BEGIN_FRAME)
     {
     }
 };
@@ -442,17 +496,33 @@ class Keyboard
         return m_Keys[AE_KEYBOARD_LEFT_SUPER] || m_Keys[AE_KEYBOARD_RIGHT_SUPER];
     }
 
-    std::string GetTyped();
+    // Text typed since the current frame began, as codepoints and as UTF-8. Both live in fixed buffers that are
+    // reset every frame, so typing never allocates; the views stay valid until the next frame begins. Text typed
+    // beyond s_TypedCapacity codepoints in one frame is dropped.
+    [[nodiscard]] inline std::u32string_view GetTyped() const
+    {
+        return { m_Typed.data(), m_TypedCount };
+    }
+
+    [[nodiscard]] inline std::string_view GetTypedUtf8() const
+    {
+        return { m_TypedUtf8.data(), m_TypedUtf8Size };
+    }
 
   private:
     void SetKeyPressed(int32_t key, bool pressed);
-    void SetKeyTyped(int32_t key);
+    void SetKeyTyped(char32_t codepoint);
     void UpdatePreviousState();
 
   private:
     std::bitset<GLFW_KEY_LAST + 1> m_Keys;
     std::bitset<GLFW_KEY_LAST + 1> m_PreviousKeys;
-    std::ostringstream m_Typed;
+
+    static constexpr uint32_t s_TypedCapacity = 256;
+    std::array<char32_t, s_TypedCapacity> m_Typed = {};
+    std::array<char, s_TypedCapacity * 4> m_TypedUtf8 = {}; // Up to four bytes per codepoint
+    uint32_t m_TypedCount = 0;
+    uint32_t m_TypedUtf8Size = 0;
 
     friend class Window;
 };
@@ -482,6 +552,15 @@ enum class MouseButton : uint8_t
     BUTTON_8 = AE_MOUSE_BUTTON_8
 };
 
+// One cursor motion report. time is the glfwGetTime() at which GLFW reported it.
+struct MouseMotionSample
+{
+    float deltaX;
+    float deltaY;
+    double time;
+};
+
+// Positions are cached from the cursor callbacks, so reading them never queries the window system
 class Mouse
 {
   public:
@@ -496,9 +575,20 @@ class Mouse
     [[nodiscard]] bool WasButtonReleased(int32_t button) const;
     [[nodiscard]] bool WasButtonReleased(MouseButton button) const;
 
-    [[nodiscard]] float GetX() const;
-    [[nodiscard]] float GetY() const;
-    [[nodiscard]] glm::vec2 GetPosition() const;
+    [[nodiscard]] inline float GetX() const
+    {
+        return m_X;
+    }
+
+    [[nodiscard]] inline float GetY() const
+    {
+        return m_Y;
+    }
+
+    [[nodiscard]] inline glm::vec2 GetPosition() const
+    {
+        return { m_X, m_Y };
+    }
 
     void SetX(float x);
     void SetY(float y);
@@ -553,9 +643,19 @@ class Mouse
         return m_Entered;
     }
 
+    // Motion reported since the current frame began, oldest first. High polling rate mice report many times per
+    // frame; when more than s_MotionSampleCapacity reports arrive, only the newest are kept, while GetDelta
+    // still sums all of them.
+    [[nodiscard]] inline uint32_t GetMotionSampleCount() const
+    {
+        return std::min(m_MotionSampleCount, s_MotionSampleCapacity);
+    }
+    [[nodiscard]] const MouseMotionSample &GetMotionSample(uint32_t index) const;
+
   private:
     void SetPressed(int32_t button, bool pressed);
-    void SetMoved(float x, float y);
+    void SetMoved(float x, float y, double time);
+    void SetCachedPosition(float x, float y);
     void SetScrolled(float x, float y);
     void SetEntered(bool entered);
     void UpdatePreviousState();
@@ -564,12 +664,18 @@ class Mouse
     Window *m_pWindow;
     std::bitset<GLFW_MOUSE_BUTTON_LAST + 1> m_Buttons;
     std::bitset<GLFW_MOUSE_BUTTON_LAST + 1> m_PreviousButtons;
+    float m_X;
+    float m_Y;
     float m_DeltaX;
     float m_DeltaY;
     float m_ScrollX;
     float m_ScrollY;
     bool m_Entered;
 
+    static constexpr uint32_t s_MotionSampleCapacity = 64; // Power of two
+    std::array<MouseMotionSample, s_MotionSampleCapacity> m_MotionSamples;
+    uint32_t m_MotionSampleCount;
+
     friend class Window;
 };
 
@@ -635,18 +741,46 @@ enum class ControllerAxis : uint8_t
     RIGHT_TRIGGER = AE_CONTROLLER_AXIS_RIGHT_TRIGGER
 };
 
+#define AE_CONTROLLER_COUNT (GLFW_JOYSTICK_LAST + 1)
+
+// Gamepad state of every joystick slot at one point in time, one array per field, so that a frame's queries
+// touch a few cache lines however many pads and inputs are read
+struct ControllerStates
+{
+    std::array<uint16_t, AE_CONTROLLER_COUNT> buttons = {}; // One bit per button
+    std::array<std::array<float, AE_CONTROLLER_AXIS_LAST + 1>, AE_CONTROLLER_COUNT> axes = {};
+    uint32_t connected = 0; // One bit per slot
+};
+
+// Taken by the window once per BeginFrame, with the previous frame's copy kept for edge detection
+struct ControllerSnapshot
+{
+    ControllerStates current;
+    ControllerStates previous;
+};
+
+// Reads from its window's snapshot, so queries are cheap and stay constant within a frame
 class Controller
 {
   public:
-    Controller(uint32_t id);
+    Controller(uint32_t id, const ControllerSnapshot &snapshot);
     ~Controller() = default;
 
     [[nodiscard]] bool IsButtonPressed(int32_t button) const;
     [[nodiscard]] bool IsButtonPressed(ControllerButton button) const;
 
+    [[nodiscard]] bool WasButtonPressed(int32_t button) const;
+    [[nodiscard]] bool WasButtonPressed(ControllerButton button) const;
+    [[nodiscard]] bool WasButtonReleased(int32_t button) const;
+    [[nodiscard]] bool WasButtonReleased(ControllerButton button) const;
+
     [[nodiscard]] float GetAxis(int32_t axis) const;
     [[nodiscard]] float GetAxis(ControllerAxis axis) const;
 
+    // Change of the axis, deadzone applied, since the previous frame
+    [[nodiscard]] float GetAxisDelta(int32_t axis) const;
+    [[nodiscard]] float GetAxisDelta(ControllerAxis axis) const;
+
     [[nodiscard]] glm::vec2 GetLeftStick() const;
     [[nodiscard]] glm::vec2 GetRightStick() const;
     [[nodiscard]] glm::vec2 GetTriggers() const;
@@ -671,10 +805,128 @@ class Controller
 
   private:
     float ApplyDeadzone(float value) const;
+    bool IsSnapshotConnected(const char *pQuery) const;
 
   private:
     uint32_t m_Id;
     float m_Deadzone = 0.1f;
+    const ControllerSnapshot *m_pSnapshot;
+};
+
+class JsonFile;
+class TomlFile;
+
+// One way to trigger an action. input names one or more inputs joined by '+', all of which must be held, each as
+// device:NAME where device is key, mouse, button (controller) or axis (controller) and NAME is the matching Key,
+// MouseButton, ControllerButton or ControllerAxis enumerator, e.g. "key:LEFT_CONTROL+key:S" or "axis:LEFT_X".
+// The binding's value is scale, multiplied by the value of each axis in it; axis values within deadzone read 0.
+// Sticks read from -1 to 1 and triggers from 0 (released) to 1.
+struct InputBindingDesc
+{
+    std::string input;
+    float scale = 1.0f;
+    float deadzone = 0.1f;
+};
+
+struct InputActionState
+{
+    float value = 0.0f;
+    bool held = false;
+    bool pressed = false;
+    bool released = false;
+};
+
+// Input actions, compiled into flat binding tables and evaluated all at once after the window dispatches input.
+// Look actions up by name once, then read their state by index. An action's value is that of its binding with the
+// largest magnitude, and it is held while that magnitude reaches the action's threshold. Controller inputs read
+// every connected pad.
+//
+// Files hold an "actions" array whose entries have a name, an optional threshold and a "bindings" array of input
+// strings or of tables with input, scale and deadzone keys.
+class InputActions
+{
+  public:
+    static constexpr uint32_t s_InvalidAction = UINT32_MAX;
+
+    void Load(const JsonFile &file);
+    void Load(const TomlFile &file);
+    uint32_t AddAction(const std::string &name, const std::vector<InputBindingDesc> &bindings,
+                       float threshold = 0.5f);
+    void Clear();
+
+    [[nodiscard]] uint32_t GetActionIndex(std::string_view name) const;
+
+    [[nodiscard]] inline const InputActionState &GetState(uint32_t action) const
+    {
+        return m_States[action];
+    }
+
+    [[nodiscard]] inline bool IsHeld(uint32_t action) const
+    {
+        return m_States[action].held;
+    }
+
+    [[nodiscard]] inline bool WasPressed(uint32_t action) const
+    {
+        return m_States[action].pressed;
+    }
+
+    [[nodiscard]] inline bool WasReleased(uint32_t action) const
+    {
+        return m_States[action].released;
+    }
+
+    [[nodiscard]] inline float GetValue(uint32_t action) const
+    {
+        return m_States[action].value;
+    }
+
+    [[nodiscard]] inline uint32_t GetActionCount() const
+    {
+        return static_cast<uint32_t>(m_Actions.size());
+    }
+
+  private:
+    enum class InputSource : uint8_t
+    {
+        KEY,
+        MOUSE_BUTTON,
+        CONTROLLER_BUTTON,
+        CONTROLLER_AXIS
+    };
+
+    struct Input
+    {
+        InputSource source;
+        uint16_t code;
+    };
+
+    struct Binding
+    {
+        uint32_t firstInput;
+        uint32_t inputCount;
+        float scale;
+        float deadzone;
+    };
+
+    struct Action
+    {
+        uint32_t firstBinding;
+        uint32_t bindingCount;
+        float threshold;
+    };
+
+  private:
+    void Update(const Keyboard &keyboard, const Mouse &mouse, const ControllerSnapshot &controllers);
+
+  private:
+    std::vector<Input> m_Inputs;
+    std::vector<Binding> m_Bindings;
+    std::vector<Action> m_Actions;
+    std::vector<InputActionState> m_States;
+    std::unordered_map<std::string, uint32_t> m_ActionIndices;
+
+    friend class Window;
 };
 
 class IconSetContainer
@@ -826,6 +1078,13 @@ class Context
     void Destroy();
     virtual void OnResize(uint32_t width, uint32_t height);
 
+    // Whether the context is made current on a thread, as OpenGL contexts are. Only those are tracked per thread,
+    // so creating or activating one that is not never releases the context current on the same thread.
+    [[nodiscard]] virtual bool IsThreadBound() const
+    {
+        return false;
+    }
+
     virtual bool CreateImpl() = 0;
     virtual void ActivateImpl() = 0;
     virtual void DeactivateImpl() = 0;
@@ -840,14 +1099,25 @@ class Context
 
   private:
     bool m_Created;
+    // The thread the context is current on, if any
+    std::atomic<std::thread::id> m_ActiveThread;
 
     friend class Window;
 };
 
 class WindowManager;
 class Interface;
+class VulkanContext;
+class FrameCapture;
+class InputQueue;
+class InputRecorder;
+class InputReplay;
+struct InputFrame;
+struct InputRecord;
 class Event;
 
+template <typename T> class ImageFile;
+
 class Window
 {
   public:
@@ -862,14 +1132,166 @@ class Window
 
     FrameInfo BeginFrame();
     void EndFrame();
+
+    // Dispatches the input recorded since the last call through the layer stack and the callbacks. BeginFrame calls it
+    // with InputDispatch::BEGIN_FRAME; with MANUAL it must be called by the app, from the thread that runs BeginFrame,
+    // since controllers, replays and the state below are shared with it. Each call is one input frame: the
+    // pressed-this-frame state, the controller snapshot and recorded frames advance with it. While a record is
+    // dispatched, GetInputTime is the glfwGetTime() at which GLFW reported it, which places input within a frame for
+    // latency measurements. Input state updates per record, while layer events and callbacks are deferred: runs of
+    // mouse moves and scrolls are coalesced and the events are dispatched one by one, through the whole layer stack
+    // each, at the end of the call. Handlers therefore see the Keyboard and Mouse state after every record of the call,
+    // not as of their own event. Input actions are evaluated after that.
+    void DispatchInput();
+    [[nodiscard]] inline double GetInputTime() const
+    {
+        return m_InputTime;
+    }
+
+    // Threaded event mode, opt-in. StartRenderThread hands the window's context to a new thread, which calls
+    // renderFrame (one BeginFrame/EndFrame pair) until the window should close or StopRenderThread is called. The main
+    // thread then calls RunEventLoop, which only waits for OS events and forwards them until every render thread has
+    // stopped, so window moves, resizes and slow frames no longer hold each other up. Window events are handed to the
+    // render thread and dispatched in its BeginFrame, like input. The library's own main-thread-only GLFW queries
+    // (window and framebuffer sizes, gamepad states and mappings, cursor restores) are made by the event loop, which
+    // forwards the results. Close requests are handed over as well, and the render thread only stops once its layers
+    // and callbacks allowed the close. Window functions that change GLFW state (title, size, cursor, ...) must still be
+    // called from the main thread, and the window must be destroyed there, after StopRenderThread has returned the
+    // context to it.
+    void StartRenderThread(const std::function<void(Window &)> &renderFrame);
+    void StopRenderThread();
+    [[nodiscard]] inline bool IsRenderThreadRunning() const
+    {
+        return m_RenderThreadRunning.load(std::memory_order_acquire);
+    }
+    static void RunEventLoop();
+
+    // Deterministic input recording and replay, for benchmark runs. A recording holds, per frame, the delta time, the
+    // controller states and the input records dispatched in that frame, along with the held keys, held buttons and
+    // cursor position it started from, and is written to path when it is stopped or the window is destroyed. A replay
+    // drives the window from such a file in place of live input, which is dropped meanwhile, and GetDeltaTime returns
+    // the recorded delta times. Replays work on headless windows too, and stop by themselves after the last frame.
+    // Window events are not part of a recording.
+    void StartInputRecording(const std::string &path);
+    void StopInputRecording();
+    [[nodiscard]] inline bool IsRecordingInput() const
+    {
+        return m_pInputRecorder != nullptr;
+    }
+    void StartInputReplay(const std::string &path, ReplayTiming timing = ReplayTiming::FIXED);
+    void StopInputReplay();
+    [[nodiscard]] inline bool IsReplayingInput() const
+    {
+        return m_pInputReplay != nullptr;
+    }
+
+    // OpenGL framebuffer to bind in place of framebuffer 0. Headless OpenGL windows created through
+    // surfaceless EGL have no window-system framebuffer and render into this FBO; everywhere else it is 0.
+    uint32_t GetDefaultFramebuffer() const;
+
+    // Frame capture. The frame ended by the next EndFrame is read back without stalling: OpenGL through a ring
+    // of fenced pixel buffers, Vulkan through a host-visible buffer per frame slot that is read once the slot's
+    // fence has signalled. Completed frames arrive as RGBA ImageFiles on a worker thread, together with their
+    // frame number (from 1), and files are encoded there too, so neither the GPU nor the disk holds up rendering.
+    void CaptureFrame(const std::function<void(ImageFile<uint8_t> &, uint64_t)> &cb);
+    void CaptureFrame(const std::string &path);
+    // Writes every frame to directory/frame_000000.png, frame_000001.png, ... until StopCapture. Frames arriving
+    // while the encoders are too far behind are skipped rather than queued, and the numbering stays contiguous.
+    void StartCapture(const std::string &directory);
+    void StopCapture();
+    [[nodiscard]] bool IsCapturing() const;
+    // Blocks until every frame captured so far has been delivered and written
+    void FlushCaptures();
 #ifdef AE_VULKAN
     void EndFrame(std::initializer_list<VkCommandBuffer> commandBuffers);
-    void SetOnSwapchainRecreatedCB(const std::function<void(const VulkanResources &)> &cb);
+    void EndFrame(std::span<const VkCommandBuffer> commandBuffers);
+    template <typename F> inline DelegateHandle SetOnSwapchainRecreatedCB(F &&cb)
+    {
+        return m_OnSwapchainRecreated.Set(std::forward<F>(cb));
+    }
 
-    // Externally-synchronized access to the shared graphics queue (see VulkanManager).
+    inline Delegate<void(const VulkanResources &)> &GetOnSwapchainRecreated()
+    {
+        return m_OnSwapchainRecreated;
+    }
+
+    // Externally-synchronized access to the device's queues (see VulkanManager). The overloads without a
+    // queue type use the graphics queue.
     VkResult SubmitToQueue(const VkSubmitInfo &submitInfo, VkFence fence);
+    VkResult SubmitToQueue(VulkanQueueType type, const VkSubmitInfo &submitInfo, VkFence fence);
     VkResult PresentToQueue(const VkPresentInfoKHR &presentInfo);
     void WaitQueueIdle();
+    void WaitQueueIdle(VulkanQueueType type);
+
+    // Asynchronous uploads through the device's staging ring on the transfer queue. Pending uploads are
+    // flushed at EndFrame and the frame waits for them on the GPU; use the returned value of FlushUploads
+    // to wait for or poll completion on the CPU instead.
+    void UploadBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void *pData, VkDeviceSize size);
+    void UploadImage(VkImage dstImage, VkExtent3D extent, const void *pData, VkDeviceSize size,
+                     VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    // The texels are copied as stored, so the format of dstImage must match the channel count of the file.
+    void UploadImage(VkImage dstImage, const ImageFile<uint8_t> &image,
+                     VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    uint64_t FlushUploads();
+    bool IsUploadComplete(uint64_t value) const;
+    void WaitForUpload(uint64_t value) const;
+
+    // Frame numbers start at 1 and increase with every EndFrame; GetCurrentFrameNumber is the frame being
+    // recorded. Use them to recycle per-frame resources once the GPU is done with them. Exact for any past
+    // frame with DeviceFeature::TimelineSemaphore, conservative for older frames without it.
+    uint64_t GetCurrentFrameNumber() const;
+    uint64_t GetCompletedFrameNumber() const;
+    bool IsFrameComplete(uint64_t frameNumber) const;
+    void WaitForFrame(uint64_t frameNumber) const;
+
+    // Requires DeviceFeature::TimelineSemaphore. The next frame's GPU work waits until the host timeline
+    // reaches value; SignalHost may be called from any thread once the CPU-side data is ready.
+    void AddHostDependency(uint64_t value);
+    void SignalHost(uint64_t value);
+
+    // The present mode chosen from WindowDesc::presentModes, and the time in seconds from BeginFrame to the
+    // frame becoming visible for the most recent frame measured. Latency is only measured with
+    // DeviceFeature::PresentWait and a non-zero maxQueuedPresents, and is 0 otherwise.
+    PresentMode GetPresentMode() const;
+    double GetPresentLatency() const;
+
+    // Command buffers from a per-thread pool for the current frame slot. They are valid until the slot is
+    // reused FramesInFlight frames later, must be recorded and submitted within the frame, and are never freed
+    // individually. Safe to call from any thread between BeginFrame and EndFrame.
+    VkCommandBuffer AllocateCommandBuffer(VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    // Records commandBuffers.size() buffers in parallel on worker threads and returns once all have ended.
+    // With pInheritance the buffers are secondary (execute them with vkCmdExecuteCommands), otherwise primary
+    // (pass them to EndFrame). The callback gets a begun buffer and its index and must not begin or end it.
+    void RecordParallel(std::span<VkCommandBuffer> commandBuffers, const VkCommandBufferInheritanceInfo *pInheritance,
+                        const std::function<void(VkCommandBuffer, uint32_t)> &record);
+
+    // Device-wide shader modules from SPIR-V files, memory-mapped and deduplicated by content hash, so windows
+    // and swapchain recreations share modules instead of rebuilding them. Each AcquireShaderModule needs a
+    // matching ReleaseShaderModule. Outside Dist builds the files are watched and the callback receives the path
+    // and new module whenever a file's SPIR-V actually changes; rebuild the pipelines using it then, through
+    // the pipeline cache in VulkanResources.
+    VkShaderModule AcquireShaderModule(const std::string &path);
+    void ReleaseShaderModule(const std::string &path);
+    template <typename F> inline DelegateHandle SetOnShaderChangedCB(F &&cb)
+    {
+        ListenForShaderChanges();
+        return m_OnShaderChanged.Set(std::forward<F>(cb));
+    }
+
+    inline Delegate<void(const std::string &, VkShaderModule)> &GetOnShaderChanged()
+    {
+        ListenForShaderChanges();
+        return m_OnShaderChanged;
+    }
+
+    // Deferred destruction instead of WaitQueueIdle: the object is destroyed once every frame that any window
+    // was recording when it was queued has completed. Destruction happens in later BeginFrames, a bounded
+    // number of objects per frame. Buffers and images created with VulkanCreateBuffer or VulkanCreateImage are
+    // freed with their allocation; the callback overload covers anything else.
+    void DestroyDeferred(VkBuffer buffer, VmaAllocation allocation);
+    void DestroyDeferred(VkImage image, VmaAllocation allocation);
+    void DestroyDeferred(VkObjectType type, uint64_t handle);
+    void DestroyDeferred(std::function<void()> destroy);
 #endif
 
     void Close();
@@ -890,6 +1312,15 @@ class Window
         return m_pContext;
     }
 
+    inline Window *GetParent() const
+    {
+        return m_pParent;
+    }
+
+    // Headless OpenGL windows get a surfaceless EGL context in builds configured with --egl, unless their parent
+    // has a window-system context they have to share with
+    [[nodiscard]] bool UsesSurfacelessContext() const;
+
     inline const Keyboard &GetKeyboard() const
     {
         return m_Keyboard;
@@ -910,6 +1341,16 @@ class Window
         return m_Mouse;
     }
 
+    inline const InputActions &GetInputActions() const
+    {
+        return m_InputActions;
+    }
+
+    inline InputActions &GetInputActions()
+    {
+        return m_InputActions;
+    }
+
     inline const Controller &GetController(uint32_t index) const
     {
         return m_Controllers[index];
@@ -967,7 +1408,7 @@ class Window
 
     inline double GetDeltaTime() const
     {
-        return m_FrameDuration;
+        return m_pInputReplay ? m_ReplayDeltaTime : m_FrameDuration;
     }
 
     inline uint64_t GetFrameCount() const
@@ -999,6 +1440,8 @@ class Window
     void SetSize(uint32_t width, uint32_t height);
 
     [[nodiscard]] glm::vec2 GetContentScale() const;
+    // Framebuffer size in pixels; on a render thread, as the event loop last sampled it
+    [[nodiscard]] glm::ivec2 GetFramebufferSize() const;
     [[nodiscard]] glm::vec2 GetMonitorPhysicalSize() const;
     [[nodiscard]] glm::vec2 GetMonitorResolution() const;
     [[nodiscard]] std::string GetMonitorName() const;
@@ -1048,12 +1491,19 @@ class Window
         m_ClearColor[3] = color[3];
     }
 
-    inline void SetOnEventCB(const std::function<void(char)> &cb)
+    // Window callbacks are delegates. SetOn...CB replaces every subscription with cb, or clears them given nullptr;
+    // GetOn... returns the delegate itself, to Add and Remove subscriptions alongside others.
+    template <typename F> inline DelegateHandle SetOnEventCB(F &&cb)
+    {
+        return m_OnEvent.Set(std::forward<F>(cb));
+    }
+
+    inline Delegate<void(int32_t)> &GetOnEvent()
     {
-        m_OnEvent = cb;
+        return m_OnEvent;
     }
 
-    inline void SetOnKeyPressedCB(const std::function<void(char)> &cb)
+    template <typename F> inline DelegateHandle SetOnKeyPressedCB(F &&cb)
     {
 #ifdef AE_DEBUG
         if (m_Desc.type == WindowType::HEADLESS)
@@ -1061,10 +1511,15 @@ class Window
             AE_LOG(AE_WARNING, "Tried to set key pressed callback but this is not applicable to headless windows");
         }
 #endif // AE_DEBUG
-        m_OnKeyPressed = cb;
+        return m_OnKeyPressed.Set(std::forward<F>(cb));
+    }
+
+    inline Delegate<void(int32_t)> &GetOnKeyPressed()
+    {
+        return m_OnKeyPressed;
     }
 
-    inline void SetOnKeyReleasedCB(const std::function<void(char)> &cb)
+    template <typename F> inline DelegateHandle SetOnKeyReleasedCB(F &&cb)
     {
 #ifdef AE_DEBUG
         if (m_Desc.type == WindowType::HEADLESS)
@@ -1072,10 +1527,15 @@ class Window
             AE_LOG(AE_WARNING, "Tried to set key released callback but this is not applicable to headless windows");
         }
 #endif // AE_DEBUG
-        m_OnKeyReleased = cb;
+        return m_OnKeyReleased.Set(std::forward<F>(cb));
     }
 
-    inline void SetOnKeyTypedCB(const std::function<void(char)> &cb)
+    inline Delegate<void(int32_t)> &GetOnKeyReleased()
+    {
+        return m_OnKeyReleased;
+    }
+
+    template <typename F> inline DelegateHandle SetOnKeyTypedCB(F &&cb)
     {
 #ifdef AE_DEBUG
         if (m_Desc.type == WindowType::HEADLESS)
@@ -1083,10 +1543,15 @@ class Window
             AE_LOG(AE_WARNING, "Tried to set key typed callback but this is not applicable to headless windows");
         }
 #endif // AE_DEBUG
-        m_OnKeyTyped = cb;
+        return m_OnKeyTyped.Set(std::forward<F>(cb));
     }
 
-    inline void SetOnMouseButtonPressedCB(const std::function<void(int32_t)> &cb)
+    inline Delegate<void(int32_t)> &GetOnKeyTyped()
+    {
+        return m_OnKeyTyped;
+    }
+
+    template <typename F> inline DelegateHandle SetOnMouseButtonPressedCB(F &&cb)
     {
 #ifdef AE_DEBUG
         if (m_Desc.type == WindowType::HEADLESS)
@@ -1095,10 +1560,15 @@ class Window
                    "Tried to set mouse button pressed callback but this is not applicable to headless windows");
         }
 #endif // AE_DEBUG
-        m_OnMouseButtonPressed = cb;
+        return m_OnMouseButtonPressed.Set(std::forward<F>(cb));
     }
 
-    inline void SetOnMouseButtonReleasedCB(const std::function<void(int32_t)> &cb)
+    inline Delegate<void(int32_t)> &GetOnMouseButtonPressed()
+    {
+        return m_OnMouseButtonPressed;
+    }
+
+    template <typename F> inline DelegateHandle SetOnMouseButtonReleasedCB(F &&cb)
     {
 #ifdef AE_DEBUG
         if (m_Desc.type == WindowType::HEADLESS)
@@ -1107,10 +1577,15 @@ class Window
                    "Tried to set mouse button released callback but this is not applicable to headless windows");
         }
 #endif // AE_DEBUG
-        m_OnMouseButtonReleased = cb;
+        return m_OnMouseButtonReleased.Set(std::forward<F>(cb));
+    }
+
+    inline Delegate<void(int32_t)> &GetOnMouseButtonReleased()
+    {
+        return m_OnMouseButtonReleased;
     }
 
-    inline void SetOnMouseMovedCB(const std::function<void(float, float)> &cb)
+    template <typename F> inline DelegateHandle SetOnMouseMovedCB(F &&cb)
     {
 #ifdef AE_DEBUG
         if (m_Desc.type == WindowType::HEADLESS)
@@ -1118,10 +1593,15 @@ class Window
             AE_LOG(AE_WARNING, "Tried to set mouse moved callback but this is not applicable to headless windows");
         }
 #endif // AE_DEBUG
-        m_OnMouseMoved = cb;
+        return m_OnMouseMoved.Set(std::forward<F>(cb));
+    }
+
+    inline Delegate<void(float, float)> &GetOnMouseMoved()
+    {
+        return m_OnMouseMoved;
     }
 
-    inline void SetOnMouseScrolledCB(const std::function<void(float, float)> &cb)
+    template <typename F> inline DelegateHandle SetOnMouseScrolledCB(F &&cb)
     {
 #ifdef AE_DEBUG
         if (m_Desc.type == WindowType::HEADLESS)
@@ -1129,10 +1609,15 @@ class Window
             AE_LOG(AE_WARNING, "Tried to set mouse scrolled callback but this is not applicable to headless windows");
         }
 #endif // AE_DEBUG
-        m_OnMouseScrolled = cb;
+        return m_OnMouseScrolled.Set(std::forward<F>(cb));
     }
 
-    inline void SetOnMouseEnteredCB(const std::function<void()> &cb)
+    inline Delegate<void(float, float)> &GetOnMouseScrolled()
+    {
+        return m_OnMouseScrolled;
+    }
+
+    template <typename F> inline DelegateHandle SetOnMouseEnteredCB(F &&cb)
     {
 #ifdef AE_DEBUG
         if (m_Desc.type == WindowType::HEADLESS)
@@ -1140,10 +1625,15 @@ class Window
             AE_LOG(AE_WARNING, "Tried to set mouse entered callback but this is not applicable to headless windows");
         }
 #endif // AE_DEBUG
-        m_OnMouseEntered = cb;
+        return m_OnMouseEntered.Set(std::forward<F>(cb));
+    }
+
+    inline Delegate<void()> &GetOnMouseEntered()
+    {
+        return m_OnMouseEntered;
     }
 
-    inline void SetOnMouseExitedCB(const std::function<void()> &cb)
+    template <typename F> inline DelegateHandle SetOnMouseExitedCB(F &&cb)
     {
 #ifdef AE_DEBUG
         if (m_Desc.type == WindowType::HEADLESS)
@@ -1151,10 +1641,15 @@ class Window
             AE_LOG(AE_WARNING, "Tried to set mouse exited callback but this is not applicable to headless windows");
         }
 #endif // AE_DEBUG
-        m_OnMouseExited = cb;
+        return m_OnMouseExited.Set(std::forward<F>(cb));
+    }
+
+    inline Delegate<void()> &GetOnMouseExited()
+    {
+        return m_OnMouseExited;
     }
 
-    inline void SetOnWindowResizeCB(const std::function<void(uint32_t, uint32_t)> &cb)
+    template <typename F> inline DelegateHandle SetOnWindowResizeCB(F &&cb)
     {
 #ifdef AE_DEBUG
         if (m_Desc.type == WindowType::HEADLESS)
@@ -1162,10 +1657,15 @@ class Window
             AE_LOG(AE_WARNING, "Tried to set window resize callback but this is not applicable to headless windows");
         }
 #endif // AE_DEBUG
-        m_OnWindowResize = cb;
+        return m_OnWindowResize.Set(std::forward<F>(cb));
+    }
+
+    inline Delegate<void(uint32_t, uint32_t)> &GetOnWindowResize()
+    {
+        return m_OnWindowResize;
     }
 
-    inline void SetOnWindowMinimizedCB(const std::function<void()> &cb)
+    template <typename F> inline DelegateHandle SetOnWindowMinimizedCB(F &&cb)
     {
 #ifdef AE_DEBUG
         if (m_Desc.type == WindowType::HEADLESS)
@@ -1173,10 +1673,15 @@ class Window
             AE_LOG(AE_WARNING, "Tried to set window minimized callback but this is not applicable to headless windows");
         }
 #endif // AE_DEBUG
-        m_OnWindowMinimized = cb;
+        return m_OnWindowMinimized.Set(std::forward<F>(cb));
     }
 
-    inline void SetOnWindowMaximizedCB(const std::function<void()> &cb)
+    inline Delegate<void()> &GetOnWindowMinimized()
+    {
+        return m_OnWindowMinimized;
+    }
+
+    template <typename F> inline DelegateHandle SetOnWindowMaximizedCB(F &&cb)
     {
 #ifdef AE_DEBUG
         if (m_Desc.type == WindowType::HEADLESS)
@@ -1184,10 +1689,15 @@ class Window
             AE_LOG(AE_WARNING, "Tried to set window maximized callback but this is not applicable to headless windows");
         }
 #endif // AE_DEBUG
-        m_OnWindowMaximized = cb;
+        return m_OnWindowMaximized.Set(std::forward<F>(cb));
     }
 
-    inline void SetOnWindowRestoredCB(const std::function<void()> &cb)
+    inline Delegate<void()> &GetOnWindowMaximized()
+    {
+        return m_OnWindowMaximized;
+    }
+
+    template <typename F> inline DelegateHandle SetOnWindowRestoredCB(F &&cb)
     {
 #ifdef AE_DEBUG
         if (m_Desc.type == WindowType::HEADLESS)
@@ -1195,10 +1705,15 @@ class Window
             AE_LOG(AE_WARNING, "Tried to set window restored callback but this is not applicable to headless windows");
         }
 #endif // AE_DEBUG
-        m_OnWindowRestored = cb;
+        return m_OnWindowRestored.Set(std::forward<F>(cb));
     }
 
-    inline void SetOnWindowMovedCB(const std::function<void(uint32_t, uint32_t)> &cb)
+    inline Delegate<void()> &GetOnWindowRestored()
+    {
+        return m_OnWindowRestored;
+    }
+
+    template <typename F> inline DelegateHandle SetOnWindowMovedCB(F &&cb)
     {
 #ifdef AE_DEBUG
         if (m_Desc.type == WindowType::HEADLESS)
@@ -1206,10 +1721,15 @@ class Window
             AE_LOG(AE_WARNING, "Tried to set window moved callback but this is not applicable to headless windows");
         }
 #endif // AE_DEBUG
-        m_OnWindowMoved = cb;
+        return m_OnWindowMoved.Set(std::forward<F>(cb));
+    }
+
+    inline Delegate<void(uint32_t, uint32_t)> &GetOnWindowMoved()
+    {
+        return m_OnWindowMoved;
     }
 
-    inline void SetOnWindowFocusedCB(const std::function<void(bool)> &cb)
+    template <typename F> inline DelegateHandle SetOnWindowFocusedCB(F &&cb)
     {
 #ifdef AE_DEBUG
         if (m_Desc.type == WindowType::HEADLESS)
@@ -1217,10 +1737,15 @@ class Window
             AE_LOG(AE_WARNING, "Tried to set window focused callback but this is not applicable to headless windows");
         }
 #endif // AE_DEBUG
-        m_OnWindowFocused = cb;
+        return m_OnWindowFocused.Set(std::forward<F>(cb));
+    }
+
+    inline Delegate<void(bool)> &GetOnWindowFocused()
+    {
+        return m_OnWindowFocused;
     }
 
-    inline void SetOnFramebufferResizeCB(const std::function<void(uint32_t, uint32_t)> &cb)
+    template <typename F> inline DelegateHandle SetOnFramebufferResizeCB(F &&cb)
     {
 #ifdef AE_DEBUG
         if (m_Desc.type == WindowType::HEADLESS)
@@ -1229,10 +1754,15 @@ class Window
                    "Tried to set framebuffer resize callback but this is not applicable to headless windows");
         }
 #endif // AE_DEBUG
-        m_OnFramebufferResize = cb;
+        return m_OnFramebufferResize.Set(std::forward<F>(cb));
     }
 
-    inline void SetOnContentScaleChangedCB(const std::function<void(float, float)> &cb)
+    inline Delegate<void(uint32_t, uint32_t)> &GetOnFramebufferResize()
+    {
+        return m_OnFramebufferResize;
+    }
+
+    template <typename F> inline DelegateHandle SetOnContentScaleChangedCB(F &&cb)
     {
 #ifdef AE_DEBUG
         if (m_Desc.type == WindowType::HEADLESS)
@@ -1240,10 +1770,15 @@ class Window
             AE_LOG(AE_WARNING, "Tried to set content scale callback but this is not applicable to headless windows");
         }
 #endif // AE_DEBUG
-        m_OnContentScaleChanged = cb;
+        return m_OnContentScaleChanged.Set(std::forward<F>(cb));
+    }
+
+    inline Delegate<void(float, float)> &GetOnContentScaleChanged()
+    {
+        return m_OnContentScaleChanged;
     }
 
-    inline void SetOnFileDropCB(const std::function<void(const std::vector<std::string> &)> &cb)
+    template <typename F> inline DelegateHandle SetOnFileDropCB(F &&cb)
     {
 #ifdef AE_DEBUG
         if (m_Desc.type == WindowType::HEADLESS)
@@ -1251,10 +1786,15 @@ class Window
             AE_LOG(AE_WARNING, "Tried to set file drop callback but this is not applicable to headless windows");
         }
 #endif // AE_DEBUG
-        m_OnFileDrop = cb;
+        return m_OnFileDrop.Set(std::forward<F>(cb));
+    }
+
+    inline Delegate<void(const std::vector<std::string> &)> &GetOnFileDrop()
+    {
+        return m_OnFileDrop;
     }
 
-    inline void SetOnWindowCloseCB(const std::function<bool()> &cb)
+    template <typename F> inline DelegateHandle SetOnWindowCloseCB(F &&cb)
     {
 #ifdef AE_DEBUG
         if (m_Desc.type == WindowType::HEADLESS)
@@ -1262,20 +1802,71 @@ class Window
             AE_LOG(AE_WARNING, "Tried to set window close callback but this is not applicable to headless windows");
         }
 #endif // AE_DEBUG
-        m_OnWindowClose = cb;
+        return m_OnWindowClose.Set(std::forward<F>(cb));
+    }
+
+    inline Delegate<bool()> &GetOnWindowClose()
+    {
+        return m_OnWindowClose;
+    }
+
+    template <typename F> inline DelegateHandle SetOnControllerConnectedCB(F &&cb)
+    {
+        return m_OnControllerConnected.Set(std::forward<F>(cb));
+    }
+
+    inline Delegate<void(int32_t)> &GetOnControllerConnected()
+    {
+        return m_OnControllerConnected;
+    }
+
+    template <typename F> inline DelegateHandle SetOnControllerDisconnectedCB(F &&cb)
+    {
+        return m_OnControllerDisconnected.Set(std::forward<F>(cb));
+    }
+
+    inline Delegate<void(int32_t)> &GetOnControllerDisconnected()
+    {
+        return m_OnControllerDisconnected;
+    }
+
+    // Called from BeginFrame with the controller id and button, for every change between two snapshots
+    template <typename F> inline DelegateHandle SetOnControllerButtonPressedCB(F &&cb)
+    {
+        return m_OnControllerButtonPressed.Set(std::forward<F>(cb));
     }
 
-    inline void SetOnControllerConnectedCB(const std::function<void(int32_t)> &cb)
+    inline Delegate<void(int32_t, int32_t)> &GetOnControllerButtonPressed()
     {
-        m_OnControllerConnected = cb;
+        return m_OnControllerButtonPressed;
     }
 
-    inline void SetOnControllerDisconnectedCB(const std::function<void(int32_t)> &cb)
+    template <typename F> inline DelegateHandle SetOnControllerButtonReleasedCB(F &&cb)
     {
-        m_OnControllerDisconnected = cb;
+        return m_OnControllerButtonReleased.Set(std::forward<F>(cb));
     }
 
-    void SetOnInterfaceUpdateCB(const std::function<void()> &cb);
+    inline Delegate<void(int32_t, int32_t)> &GetOnControllerButtonReleased()
+    {
+        return m_OnControllerButtonReleased;
+    }
+
+    template <typename F> inline DelegateHandle SetOnInterfaceUpdateCB(F &&cb)
+    {
+#ifdef AE_DEBUG
+        if (m_Desc.type == WindowType::HEADLESS)
+        {
+            AE_LOG(AE_WARNING,
+                   "Tried to set interface update callback but this is not applicable to headless windows");
+        }
+#endif // AE_DEBUG
+        return m_OnInterfaceUpdate.Set(std::forward<F>(cb));
+    }
+
+    inline Delegate<void()> &GetOnInterfaceUpdate()
+    {
+        return m_OnInterfaceUpdate;
+    }
 
     // Layer stack for event dispatching
     inline void SetLayerStack(LayerStack *pLayerStack)
@@ -1307,9 +1898,12 @@ class Window
     void CreateOpenGL();
 #ifdef AE_VULKAN
     void CreateVulkan();
+    // Subscribes the window to the shader registry on first use, so windows that never ask do not create it
+    void ListenForShaderChanges();
 #endif // AE_VULKAN
 
     void EndFrameOpenGL();
+    FrameCapture &GetFrameCapture();
 #ifdef AE_VULKAN
     void EndFrameVulkan(const VkCommandBuffer *commandBuffers, uint32_t count);
 #endif // AE_VULKAN
@@ -1322,6 +1916,15 @@ class Window
 #endif // AE_VULKAN
 
     void InitInput();
+    void UpdateControllerSnapshot(const InputFrame *pReplayFrame);
+    // Main thread only, like every gamepad query; false if the pad is not connected or has no gamepad mapping
+    static bool PollController(uint32_t id, ControllerStates &states);
+    static void PollControllers(ControllerStates &states);
+    void BeginInputFrame();
+    const InputFrame *ReplayInputFrame();
+    void DispatchRecord(const InputRecord &record);
+    void DeferInputEvent(const InputRecord &record);
+    void DispatchDeferredInput();
 
     void OnKey(int key, int scancode, int action, int mods);
     void OnChar(unsigned int c);
@@ -1344,10 +1947,16 @@ class Window
     void OnContentScaleChanged(float xScale, float yScale);
     void OnFileDrop(int count, const char **paths);
     void OnWindowClose();
-    void OnControllerConnected(int controllerId);
+    void OnControllerConnected(int controllerId, bool isGamepad);
     void OnControllerDisconnected(int controllerId);
 
     void DispatchEvent(Event &event);
+    // Builds and dispatches an E only when a layer stack is attached; returns whether a layer consumed it
+    template <typename E, typename... EventArgs> bool DispatchLayerEvent(EventArgs &&...args);
+    void DispatchDeferredEvents();
+    // Main thread only; called by the event loop for windows whose frames run on a render thread
+    void SamplePlatformState(const ControllerStates &controllers);
+    void PrepareInterface();
 
     void Deactivate();
 
@@ -1379,54 +1988,98 @@ class Window
     Keyboard m_Keyboard;
     Mouse m_Mouse;
     std::vector<Controller> m_Controllers;
+    ControllerSnapshot m_ControllerSnapshot;
+    InputActions m_InputActions;
 
     IconSet m_IconSet;
     Cursor m_CurrentCursor;
 
     std::shared_ptr<Context> m_pContext;
+#ifdef AE_VULKAN
+    VulkanContext *m_pVulkanContext = nullptr;
+    uint64_t m_ShaderListenerId = 0;
+#endif // AE_VULKAN
     std::array<float, 4> m_ClearColor;
     std::unique_ptr<Interface> m_pInterface;
+    std::unique_ptr<FrameCapture> m_pFrameCapture;
+    std::unique_ptr<InputQueue> m_pInputQueue;
+    uint32_t m_ManagerSlot = 0;
+    double m_InputTime = 0.0;
+    // Input records of the DispatchInput call, coalesced and dispatched to layers and callbacks at its end
+    std::vector<InputRecord> m_DeferredInputEvents;
+    std::unique_ptr<InputRecorder> m_pInputRecorder;
+    std::unique_ptr<InputReplay> m_pInputReplay;
+    ReplayTiming m_ReplayTiming = ReplayTiming::FIXED;
+    double m_ReplayDeltaTime = 0.0;
 
     LayerStack *m_pLayerStack = nullptr;
 
-    std::function<void(int32_t)> m_OnEvent = nullptr;
-
-    std::function<void(int32_t)> m_OnKeyPressed = nullptr;
-    std::function<void(int32_t)> m_OnKeyReleased = nullptr;
-    std::function<void(int32_t)> m_OnKeyTyped = nullptr;
-
-    std::function<void(int32_t)> m_OnMouseButtonPressed = nullptr;
-    std::function<void(int32_t)> m_OnMouseButtonReleased = nullptr;
-    std::function<void(float, float)> m_OnMouseMoved = nullptr;
-    std::function<void(float, float)> m_OnMouseScrolled = nullptr;
-    std::function<void()> m_OnMouseEntered = nullptr;
-    std::function<void()> m_OnMouseExited = nullptr;
-
-    std::function<void(uint32_t, uint32_t)> m_OnWindowResize = nullptr;
-    std::function<void()> m_OnWindowMinimized = nullptr;
-    std::function<void()> m_OnWindowMaximized = nullptr;
-    std::function<void()> m_OnWindowRestored = nullptr;
-    std::function<void(uint32_t, uint32_t)> m_OnWindowMoved = nullptr;
-    std::function<void(bool)> m_OnWindowFocused = nullptr;
-
-    std::function<void()> m_OnMonitorConnected = nullptr;
-
-    std::function<void(uint32_t, uint32_t)> m_OnFramebufferResize = nullptr;
-    std::function<void(float, float)> m_OnContentScaleChanged = nullptr;
-    std::function<void(const std::vector<std::string> &)> m_OnFileDrop = nullptr;
-    std::function<bool()> m_OnWindowClose = nullptr; // Returns true to allow close, false to cancel
-    std::function<void(int32_t)> m_OnControllerConnected = nullptr;
-    std::function<void(int32_t)> m_OnControllerDisconnected = nullptr;
+    Delegate<void(int32_t)> m_OnEvent;
+
+    Delegate<void(int32_t)> m_OnKeyPressed;
+    Delegate<void(int32_t)> m_OnKeyReleased;
+    Delegate<void(int32_t)> m_OnKeyTyped;
+
+    Delegate<void(int32_t)> m_OnMouseButtonPressed;
+    Delegate<void(int32_t)> m_OnMouseButtonReleased;
+    Delegate<void(float, float)> m_OnMouseMoved;
+    Delegate<void(float, float)> m_OnMouseScrolled;
+    Delegate<void()> m_OnMouseEntered;
+    Delegate<void()> m_OnMouseExited;
+
+    Delegate<void(uint32_t, uint32_t)> m_OnWindowResize;
+    Delegate<void()> m_OnWindowMinimized;
+    Delegate<void()> m_OnWindowMaximized;
+    Delegate<void()> m_OnWindowRestored;
+    Delegate<void(uint32_t, uint32_t)> m_OnWindowMoved;
+    Delegate<void(bool)> m_OnWindowFocused;
+
+    Delegate<void()> m_OnMonitorConnected;
+
+    Delegate<void(uint32_t, uint32_t)> m_OnFramebufferResize;
+    Delegate<void(float, float)> m_OnContentScaleChanged;
+    Delegate<void(const std::vector<std::string> &)> m_OnFileDrop;
+    Delegate<bool()> m_OnWindowClose; // Each returns true to allow close, false to cancel
+    Delegate<void(int32_t)> m_OnControllerConnected;
+    Delegate<void(int32_t)> m_OnControllerDisconnected;
+    Delegate<void(int32_t, int32_t)> m_OnControllerButtonPressed;
+    Delegate<void(int32_t, int32_t)> m_OnControllerButtonReleased;
+    Delegate<void()> m_OnInterfaceUpdate;
 
     bool m_Focused;
     bool m_Active;
     bool m_Created;
     bool m_FrameInProgress = false;
+    std::thread::id m_FrameThread;
 
 #ifdef AE_VULKAN
-    std::function<void(const VulkanResources &)> m_OnSwapchainRecreated = nullptr;
+    Delegate<void(const VulkanResources &)> m_OnSwapchainRecreated;
+    Delegate<void(const std::string &, VkShaderModule)> m_OnShaderChanged;
 #endif
 
+    // GLFW state that only the main thread may query, as the event loop last sampled it. The render thread takes
+    // a copy along with the deferred events.
+    struct PlatformState
+    {
+        int windowWidth = 0;
+        int windowHeight = 0;
+        int framebufferWidth = 0;
+        int framebufferHeight = 0;
+        double cursorX = 0.0;
+        double cursorY = 0.0;
+        ControllerStates controllers;
+    };
+
+    // Window events forwarded by the event loop, dispatched by the render thread
+    std::mutex m_DeferredEventMutex;
+    std::vector<std::function<void(Window &)>> m_DeferredEvents;
+    PlatformState m_SampledPlatformState;
+    PlatformState m_PlatformState;
+
+    // Declared last so it is joined before anything it uses is destroyed
+    std::atomic<bool> m_RenderThreadRunning = false;
+    std::jthread m_RenderThread;
+
     friend class WindowManager;
 };
 
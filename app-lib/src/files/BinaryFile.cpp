@@ -2,14 +2,29 @@
 
 #include "Files.h"
 
+#include <filesystem>
 #include <utility>
 
+#ifdef AE_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else // AE_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // AE_WINDOWS
+
 ae::BinaryFile::BinaryFile() = default;
 
 ae::BinaryFile::BinaryFile(const std::string &path) : File(path) {}
 
 void ae::BinaryFile::ReadImpl()
 {
+    m_pMapping.reset();
+    m_MappedView = {};
+
     FILE *file = fopen(m_Path.c_str(), "rb");
     if (!file)
     {
@@ -58,5 +73,104 @@ void ae::BinaryFile::WriteImpl()
 void ae::BinaryFile::SetData(std::vector<uint8_t> data)
 {
     m_Data = std::move(data);
+    m_pMapping.reset();
+    m_MappedView = {};
     SetPopulated(true);
 }
+
+ae::BinaryFile &ae::BinaryFile::Map()
+{
+    if (m_Path.empty())
+    {
+        AE_THROW_FILE_OPEN_ERROR("Attempted to map BinaryFile with empty path. Use SetPath() to set the file path "
+                                 "before calling Map()");
+    }
+
+    if (!std::filesystem::exists(m_Path))
+    {
+        AE_THROW_FILE_NOT_FOUND_ERROR("Failed to map File, there is no file with the specified path '{}'", m_Path);
+    }
+
+    m_Data.clear();
+    m_pMapping.reset();
+    m_MappedView = {};
+
+#ifdef AE_WINDOWS
+    HANDLE file = CreateFileA(m_Path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        AE_THROW_FILE_OPEN_ERROR("Failed to open file '{}' for mapping", m_Path);
+    }
+
+    LARGE_INTEGER size{};
+    GetFileSizeEx(file, &size);
+
+    // Empty files cannot be mapped, but an empty view is a valid result
+    if (size.QuadPart > 0)
+    {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void *pView = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+        // The view keeps the mapping and file alive on its own
+        if (mapping)
+        {
+            CloseHandle(mapping);
+        }
+
+        CloseHandle(file);
+
+        if (!pView)
+        {
+            AE_THROW_FILESYSTEM_ERROR("Failed to map file '{}'", m_Path);
+        }
+
+        m_pMapping = std::shared_ptr<const void>(pView, [](const void *p) { UnmapViewOfFile(p); });
+        m_MappedView = { static_cast<const uint8_t *>(pView), static_cast<size_t>(size.QuadPart) };
+    }
+    else
+    {
+        CloseHandle(file);
+        m_pMapping = std::make_shared<const uint8_t>(0);
+    }
+#else  // AE_WINDOWS
+    int file = open(m_Path.c_str(), O_RDONLY);
+
+    if (file < 0)
+    {
+        AE_THROW_FILE_OPEN_ERROR("Failed to open file '{}' for mapping", m_Path);
+    }
+
+    struct stat info{};
+    fstat(file, &info);
+
+    size_t size = static_cast<size_t>(info.st_size);
+
+    // Empty files cannot be mapped, but an empty view is a valid result
+    if (size > 0)
+    {
+        void *pView = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+
+        // The mapping keeps the file alive on its own
+        close(file);
+
+        if (pView == MAP_FAILED)
+        {
+            AE_THROW_FILESYSTEM_ERROR("Failed to map file '{}'", m_Path);
+        }
+
+        m_pMapping = std::shared_ptr<const void>(pView, [size](const void *p) { munmap(const_cast<void *>(p), size); });
+        m_MappedView = { static_cast<const uint8_t *>(pView), size };
+    }
+    else
+    {
+        close(file);
+        m_pMapping = std::make_shared<const uint8_t>(0);
+    }
+#endif // AE_WINDOWS
+
+    SetRead(true);
+
+    return *this;
+}
@@ -31,6 +31,13 @@ ae::ImageFile<T>::ImageFile(const std::vector<T> &data, uint32_t width, uint32_t
     SetPopulated(true);
 }
 
+template <typename T>
+ae::ImageFile<T>::ImageFile(std::vector<T> &&data, uint32_t width, uint32_t height, uint32_t channels)
+    : File(), m_Data(std::move(data)), m_Width(width), m_Height(height), m_Channels(channels)
+{
+    SetPopulated(true);
+}
+
 template <typename T> void ae::ImageFile<T>::WriteImpl()
 {
     if (m_Data.empty())
@@ -4,6 +4,15 @@
 
 #include <print>
 
+namespace
+{
+
+// Thread-bound contexts are current per thread, so each thread tracks its own. Activating one releases the one
+// current on the same thread and never touches other threads, which may be rendering other windows.
+thread_local ae::Context *t_pCurrentContext = nullptr;
+
+} // namespace
+
 ae::Context::Context(Window &window)
     : m_Window(window), m_GraphicsAPI("Undefined"), m_GraphicsVersion("Undefined"), m_GraphicsCard("Undefined"),
       m_GraphicsVendor("Undefined"), m_Created(false)
@@ -30,12 +39,26 @@ void ae::Context::Create()
     }
 #endif // AE_DEBUG
 
+    // Creation makes a thread-bound context current on this thread
+    if (IsThreadBound() && t_pCurrentContext)
+    {
+        t_pCurrentContext->Deactivate();
+    }
+
     if (!CreateImpl())
     {
         AE_THROW_RUNTIME_ERROR("Failed to create graphics Context for Window");
     }
 
     m_Created = true;
+
+    if (!IsThreadBound())
+    {
+        return;
+    }
+
+    t_pCurrentContext = this;
+    m_ActiveThread = std::this_thread::get_id();
 }
 
 void ae::Context::Activate()
@@ -47,7 +70,31 @@ void ae::Context::Activate()
         return;
     }
 #endif // AE_DEBUG
+
+    if (!IsThreadBound())
+    {
+        ActivateImpl();
+        return;
+    }
+
+#ifdef AE_DEBUG
+    std::thread::id activeThread = m_ActiveThread.load();
+
+    if (activeThread != std::thread::id() && activeThread != std::this_thread::get_id())
+    {
+        AE_LOG(AE_WARNING, "Tried to activate graphics Context that is still active on another thread");
+    }
+#endif // AE_DEBUG
+
+    if (t_pCurrentContext && t_pCurrentContext != this)
+    {
+        t_pCurrentContext->Deactivate();
+    }
+
     ActivateImpl();
+
+    t_pCurrentContext = this;
+    m_ActiveThread = std::this_thread::get_id();
 }
 
 void ae::Context::Deactivate()
@@ -59,7 +106,23 @@ void ae::Context::Deactivate()
         return;
     }
 #endif // AE_DEBUG
+
+    if (!IsThreadBound())
+    {
+        DeactivateImpl();
+        return;
+    }
+
+    // Only the thread the context is current on can release it
+    if (t_pCurrentContext != this)
+    {
+        return;
+    }
+
     DeactivateImpl();
+
+    t_pCurrentContext = nullptr;
+    m_ActiveThread = std::thread::id();
 }
 
 void ae::Context::Destroy()
@@ -73,6 +136,13 @@ void ae::Context::Destroy()
 #endif // AE_DEBUG
     DestroyImpl();
     m_Created = false;
+
+    if (t_pCurrentContext == this)
+    {
+        t_pCurrentContext = nullptr;
+    }
+
+    m_ActiveThread = std::thread::id();
 }
 
 void ae::Context::OnResize([[maybe_unused]] uint32_t width, [[maybe_unused]] uint32_t height) {}
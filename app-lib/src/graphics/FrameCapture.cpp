@@ -0,0 +1,237 @@
+#include "general/pch.h"
+
+#include "FrameCapture.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <format>
+
+ae::FrameCapture::FrameCapture()
+{
+    m_CopyThread = std::jthread([this](std::stop_token stopToken) { CopyLoop(stopToken); });
+
+    // PNG encoding is by far the slowest step, so it gets several threads to keep up with continuous capture
+    uint32_t encodeThreadCount = std::clamp(std::thread::hardware_concurrency() / 2, 1u, s_MaxEncodeThreads);
+
+    m_EncodeThreads.reserve(encodeThreadCount);
+
+    for (uint32_t i = 0; i < encodeThreadCount; i++)
+    {
+        m_EncodeThreads.emplace_back([this](std::stop_token stopToken) { EncodeLoop(stopToken); });
+    }
+}
+
+ae::FrameCapture::~FrameCapture()
+{
+    Flush();
+
+    // std::jthread requests a stop and joins on destruction, which also wakes the condition variable waits
+    m_EncodeThreads.clear();
+    m_CopyThread = {};
+}
+
+void ae::FrameCapture::AddRequest(Request request)
+{
+    std::scoped_lock lock(m_RequestMutex);
+    m_Requests.push_back(std::move(request));
+    m_HasRequests.store(true, std::memory_order_relaxed);
+}
+
+void ae::FrameCapture::StartContinuous(const std::string &directory)
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    if (error)
+    {
+        AE_THROW_RUNTIME_ERROR("Failed to create frame capture directory '{}': {}", directory, error.message());
+    }
+
+    std::scoped_lock lock(m_RequestMutex);
+    m_ContinuousDirectory = directory;
+    m_ContinuousIndex = 0;
+    m_SkippedFrames = 0;
+    m_Continuous.store(true, std::memory_order_relaxed);
+}
+
+void ae::FrameCapture::StopContinuous()
+{
+    std::scoped_lock lock(m_RequestMutex);
+
+    if (m_Continuous.exchange(false, std::memory_order_relaxed) && m_SkippedFrames > 0)
+    {
+        AE_LOG(AE_WARNING, "Continuous frame capture to '{}' skipped {} frames the encoders could not keep up with",
+               m_ContinuousDirectory, m_SkippedFrames);
+    }
+}
+
+bool ae::FrameCapture::TakeRequests(std::vector<Request> &requests)
+{
+    requests.clear();
+
+    if (!HasRequests())
+    {
+        return false;
+    }
+
+    uint64_t outstandingJobs;
+
+    {
+        std::scoped_lock lock(m_Mutex);
+        outstandingJobs = m_OutstandingJobs;
+    }
+
+    std::scoped_lock lock(m_RequestMutex);
+
+    requests.swap(m_Requests);
+    m_HasRequests.store(false, std::memory_order_relaxed);
+
+    // Skipped frames keep the file numbers contiguous, so the sequence still plays back without gaps
+    if (m_Continuous.load(std::memory_order_relaxed))
+    {
+        if (outstandingJobs < s_MaxQueuedFrames)
+        {
+            requests.push_back({ .callback = nullptr,
+                                 .path = std::format("{}/frame_{:06}.png", m_ContinuousDirectory,
+                                                     m_ContinuousIndex++) });
+        }
+        else
+        {
+            m_SkippedFrames++;
+        }
+    }
+
+    return !requests.empty();
+}
+
+void ae::FrameCapture::Submit(const Readback &readback, std::vector<Request> &requests)
+{
+    {
+        std::scoped_lock lock(m_Mutex);
+        m_CopyJobs.push_back({ .readback = readback, .requests = std::move(requests) });
+        m_OutstandingJobs++;
+    }
+
+    requests.clear();
+    m_CopyCondition.notify_one();
+}
+
+void ae::FrameCapture::Flush()
+{
+    std::unique_lock lock(m_Mutex);
+    m_IdleCondition.wait(lock, [this] { return m_OutstandingJobs == 0; });
+}
+
+void ae::FrameCapture::WaitUntilReleased(const std::atomic<bool> &busy)
+{
+    while (busy.load(std::memory_order_acquire))
+    {
+        busy.wait(true, std::memory_order_acquire);
+    }
+}
+
+void ae::FrameCapture::CopyLoop(std::stop_token stopToken)
+{
+    while (true)
+    {
+        CopyJob job;
+
+        {
+            std::unique_lock lock(m_Mutex);
+
+            if (!m_CopyCondition.wait(lock, stopToken, [this] { return !m_CopyJobs.empty(); }))
+            {
+                return;
+            }
+
+            job = std::move(m_CopyJobs.front());
+            m_CopyJobs.pop_front();
+        }
+
+        const Readback &readback = job.readback;
+        size_t rowSize = static_cast<size_t>(readback.width) * 4;
+        std::vector<uint8_t> pixels(rowSize * readback.height);
+
+        for (uint32_t y = 0; y < readback.height; y++)
+        {
+            uint32_t srcRow = readback.flipRows ? readback.height - 1 - y : y;
+            const uint8_t *pSrc = readback.pPixels + srcRow * rowSize;
+            uint8_t *pDst = pixels.data() + y * rowSize;
+
+            std::memcpy(pDst, pSrc, rowSize);
+
+            if (readback.swapRedBlue)
+            {
+                for (size_t x = 0; x < rowSize; x += 4)
+                {
+                    std::swap(pDst[x], pDst[x + 2]);
+                }
+            }
+        }
+
+        // The readback memory is free for the render thread again; everything after this works on the copy
+        readback.pBusy->store(false, std::memory_order_release);
+        readback.pBusy->notify_all();
+
+        EncodeJob encodeJob;
+        encodeJob.pImage = std::make_unique<ImageFile<uint8_t>>(std::move(pixels), readback.width, readback.height, 4);
+        encodeJob.frameNumber = readback.frameNumber;
+        encodeJob.requests = std::move(job.requests);
+
+        {
+            std::scoped_lock lock(m_Mutex);
+            m_EncodeJobs.push_back(std::move(encodeJob));
+        }
+
+        m_EncodeCondition.notify_one();
+    }
+}
+
+void ae::FrameCapture::EncodeLoop(std::stop_token stopToken)
+{
+    while (true)
+    {
+        EncodeJob job;
+
+        {
+            std::unique_lock lock(m_Mutex);
+
+            if (!m_EncodeCondition.wait(lock, stopToken, [this] { return !m_EncodeJobs.empty(); }))
+            {
+                return;
+            }
+
+            job = std::move(m_EncodeJobs.front());
+            m_EncodeJobs.pop_front();
+        }
+
+        for (Request &request : job.requests)
+        {
+            // A failed capture must not take the worker down with it, or every later frame would be lost too
+            try
+            {
+                if (request.callback)
+                {
+                    request.callback(*job.pImage, job.frameNumber);
+                }
+
+                if (!request.path.empty())
+                {
+                    job.pImage->SetPath(request.path);
+                    job.pImage->Write();
+                }
+            }
+            catch (const std::exception &e)
+            {
+                AE_LOG(AE_ERROR, "Frame capture of frame {} failed: {}", job.frameNumber, e.what());
+            }
+        }
+
+        {
+            std::scoped_lock lock(m_Mutex);
+            m_OutstandingJobs--;
+        }
+
+        m_IdleCondition.notify_all();
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Files.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ae
+{
+	using FrameCaptureCallback = std::function<void(ImageFile<uint8_t>&, uint64_t)>;
+
+	// API-independent half of frame capture. The graphics contexts copy the frame into readback memory and
+	// hand it over once the GPU is done with it; from there a copy thread moves the pixels into an RGBA
+	// ImageFile and frees the readback memory, and a pool of encoder threads runs the callbacks and writes the
+	// image files. The render thread only waits when it wants to reuse readback memory the copy thread has not
+	// released yet, never on encoding. So that a slow disk cannot grow the queues without limit, continuous
+	// capture skips frames while s_MaxQueuedFrames are still in flight; explicitly requested frames are never
+	// skipped. Requests may be added from any thread while the render thread takes them.
+	class FrameCapture
+	{
+	public:
+		struct Request
+		{
+			FrameCaptureCallback callback;
+			std::string path;
+		};
+
+		// Pixels of a completed frame, still in the readback memory the GPU wrote them to. Always four bytes
+		// per pixel with tightly packed rows.
+		struct Readback
+		{
+			const uint8_t* pPixels = nullptr;
+			uint32_t width = 0;
+			uint32_t height = 0;
+			uint64_t frameNumber = 0;
+			bool flipRows = false; // OpenGL reads rows bottom-up
+			bool swapRedBlue = false; // BGRA swapchain formats
+			std::atomic<bool>* pBusy = nullptr; // Cleared once pPixels may be written again
+		};
+	public:
+		FrameCapture();
+		FrameCapture(const FrameCapture&) = delete;
+		FrameCapture& operator=(const FrameCapture&) = delete;
+		~FrameCapture();
+
+		// Any thread
+		void AddRequest(Request request);
+		void StartContinuous(const std::string& directory);
+		void StopContinuous();
+		inline bool IsContinuous() const { return m_Continuous.load(std::memory_order_relaxed); }
+
+		// Render thread side. HasRequests is a lock-free hint for skipping the capture work; TakeRequests has the
+		// final say and may still come back empty.
+		inline bool HasRequests() const
+		{
+			return m_Continuous.load(std::memory_order_relaxed) || m_HasRequests.load(std::memory_order_relaxed);
+		}
+
+		// Moves everything asked of the current frame into requests; continuous mode adds the next numbered file
+		// unless the queues are full. Returns false if there is nothing to capture.
+		bool TakeRequests(std::vector<Request>& requests);
+
+		// pBusy must already be set; requests are moved from
+		void Submit(const Readback& readback, std::vector<Request>& requests);
+
+		// Blocks until every submitted frame has been copied, handed to its callbacks and written
+		void Flush();
+
+		// Waits for the copy thread to release a readback slot before it is written again
+		static void WaitUntilReleased(const std::atomic<bool>& busy);
+	private:
+		struct CopyJob
+		{
+			Readback readback;
+			std::vector<Request> requests;
+		};
+
+		struct EncodeJob
+		{
+			std::unique_ptr<ImageFile<uint8_t>> pImage;
+			uint64_t frameNumber = 0;
+			std::vector<Request> requests;
+		};
+
+		void CopyLoop(std::stop_token stopToken);
+		void EncodeLoop(std::stop_token stopToken);
+	private:
+		std::mutex m_RequestMutex;
+		std::vector<Request> m_Requests;
+		std::string m_ContinuousDirectory;
+		uint64_t m_ContinuousIndex = 0;
+		uint64_t m_SkippedFrames = 0;
+		std::atomic<bool> m_HasRequests = false;
+		std::atomic<bool> m_Continuous = false;
+
+		std::mutex m_Mutex;
+		std::condition_variable_any m_CopyCondition;
+		std::condition_variable_any m_EncodeCondition;
+		std::condition_variable m_IdleCondition;
+		std::deque<CopyJob> m_CopyJobs;
+		std::deque<EncodeJob> m_EncodeJobs;
+		uint64_t m_OutstandingJobs = 0;
+
+		// Declared last so the threads are joined before the queues they use are destroyed
+		std::jthread m_CopyThread;
+		std::vector<std::jthread> m_EncodeThreads;
+	private:
+		static constexpr uint32_t s_MaxEncodeThreads = 4;
+		static constexpr uint64_t s_MaxQueuedFrames = 2 * s_MaxEncodeThreads;
+	};
+}
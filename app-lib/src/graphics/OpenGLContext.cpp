@@ -2,15 +2,52 @@
 
 #include "OpenGLContext.h"
 #include "OpenGLManager.h"
-#include "window/WindowManager.h"
+
+#include <utility>
+
+#ifdef AE_EGL
+namespace
+{
+
+struct GLVersion
+{
+    EGLint major;
+    EGLint minor;
+};
+
+// Matches the version requested from GLFW, falling back to 4.5 for drivers such as Mesa's llvmpipe
+constexpr std::array<GLVersion, 2> s_SurfacelessVersions = {{{4, 6}, {4, 5}}};
+
+// eglGetPlatformDisplay hands every caller the same display and EGL does not reference count it, so it is
+// only terminated along with the last surfaceless context
+uint32_t s_SurfacelessContextCount = 0;
+
+} // namespace
+#endif // AE_EGL
 
 ae::OpenGLContext::OpenGLContext(Window &window) : Context(window) {}
 
 bool ae::OpenGLContext::CreateImpl()
 {
-    glfwMakeContextCurrent(m_Window.GetWindow());
+    m_Surfaceless = m_Window.UsesSurfacelessContext();
+
+    if (m_Surfaceless)
+    {
+#ifdef AE_EGL
+        CreateSurfacelessContext();
+        s_SurfacelessContextCount++;
+
+        OpenGLManager::Get().AddContext(reinterpret_cast<GLADloadproc>(eglGetProcAddress));
+
+        CreateDefaultFramebuffer();
+#endif // AE_EGL
+    }
+    else
+    {
+        glfwMakeContextCurrent(m_Window.GetWindow());
 
-    OpenGLManager::Get().AddContext();
+        OpenGLManager::Get().AddContext(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
+    }
 
     m_GraphicsAPI = "OpenGL";
     m_GraphicsVersion = OpenGLManager::Get().GetVersion();
@@ -22,23 +59,395 @@ bool ae::OpenGLContext::CreateImpl()
 
 void ae::OpenGLContext::ActivateImpl()
 {
-    WindowManager::Get().DeactivateAllWindows();
+    if (m_Surfaceless)
+    {
+#ifdef AE_EGL
+        eglMakeCurrent(m_EGLDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, m_EGLContext);
 
-    glfwMakeContextCurrent(m_Window.GetWindow());
+        GL_CHECK(glBindFramebuffer(GL_FRAMEBUFFER, m_DefaultFramebuffer));
+#endif // AE_EGL
+    }
+    else
+    {
+        glfwMakeContextCurrent(m_Window.GetWindow());
+    }
 }
 
-void ae::OpenGLContext::DeactivateImpl() {}
+void ae::OpenGLContext::DeactivateImpl()
+{
+    // Released rather than left current, so another thread can make it current next. A thread also has one
+    // current context across GLX and EGL, so an EGL context has to be released before a GLFW window's context
+    // can take its place.
+    if (m_Surfaceless)
+    {
+#ifdef AE_EGL
+        if (eglGetCurrentContext() == m_EGLContext)
+        {
+            eglMakeCurrent(m_EGLDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        }
+#endif // AE_EGL
+    }
+    else if (glfwGetCurrentContext() == m_Window.GetWindow())
+    {
+        glfwMakeContextCurrent(nullptr);
+    }
+}
 
 void ae::OpenGLContext::DestroyImpl()
 {
+    // GL names are per context, so deleting them with another window's context current would hit that window's
+    // objects instead
+    Activate();
+
+    if (m_Surfaceless)
+    {
+#ifdef AE_EGL
+        DestroyDefaultFramebuffer();
+#endif // AE_EGL
+    }
+
+    DestroyCaptureBuffers();
+
     OpenGLManager::Get().RemoveContext();
 
+#ifdef AE_EGL
+    if (m_Surfaceless)
+    {
+        DestroySurfacelessContext();
+    }
+#endif // AE_EGL
+
     m_GraphicsAPI = "Undefined";
     m_GraphicsVersion = "Undefined";
     m_GraphicsCard = "Undefined";
     m_GraphicsVendor = "Undefined";
 }
 
+#ifdef AE_EGL
+void ae::OpenGLContext::CreateSurfacelessContext()
+{
+    // EGL_EXT_platform_base is a client extension, so its entry point has to be looked up before a display exists
+    auto pfnGetPlatformDisplay =
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+    if (!pfnGetPlatformDisplay)
+    {
+        AE_THROW_RUNTIME_ERROR("EGL_EXT_platform_base is not supported, cannot create a surfaceless OpenGL context");
+    }
+
+    m_EGLDisplay = pfnGetPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+
+    if (m_EGLDisplay == EGL_NO_DISPLAY)
+    {
+        AE_THROW_RUNTIME_ERROR("Failed to get a surfaceless EGL display (EGL_MESA_platform_surfaceless)");
+    }
+
+    EGLint major = 0;
+    EGLint minor = 0;
+
+    if (!eglInitialize(m_EGLDisplay, &major, &minor))
+    {
+        AE_THROW_RUNTIME_ERROR("Failed to initialize EGL display, error {:#x}", eglGetError());
+    }
+
+    AE_LOG(AE_TRACE, "EGL Version: {}.{}", major, minor);
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        AE_THROW_RUNTIME_ERROR("EGL display does not support desktop OpenGL");
+    }
+
+    // No surface is ever created, so the config only has to be renderable with desktop OpenGL
+    const std::array<EGLint, 3> configAttributes = {EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+
+    if (!eglChooseConfig(m_EGLDisplay, configAttributes.data(), &config, 1, &configCount) || configCount == 0)
+    {
+        AE_THROW_RUNTIME_ERROR("No EGL config supports desktop OpenGL");
+    }
+
+    // A child of another surfaceless window shares its objects; both live on the same display
+    EGLContext shareContext = EGL_NO_CONTEXT;
+    Window *pParent = m_Window.GetParent();
+
+    if (pParent && pParent->UsesSurfacelessContext())
+    {
+        std::shared_ptr<Context> pParentContext = pParent->GetContext().lock();
+
+        if (pParentContext)
+        {
+            shareContext = static_cast<OpenGLContext *>(pParentContext.get())->m_EGLContext;
+        }
+    }
+
+    for (const GLVersion &version : s_SurfacelessVersions)
+    {
+        const std::array<EGLint, 7> contextAttributes = {EGL_CONTEXT_MAJOR_VERSION,
+                                                         version.major,
+                                                         EGL_CONTEXT_MINOR_VERSION,
+                                                         version.minor,
+                                                         EGL_CONTEXT_OPENGL_PROFILE_MASK,
+                                                         EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                                                         EGL_NONE};
+
+        m_EGLContext = eglCreateContext(m_EGLDisplay, config, shareContext, contextAttributes.data());
+
+        if (m_EGLContext != EGL_NO_CONTEXT)
+        {
+            break;
+        }
+
+        AE_LOG(AE_WARNING, "Failed to create an OpenGL {}.{} core context through EGL", version.major, version.minor);
+    }
+
+    if (m_EGLContext == EGL_NO_CONTEXT)
+    {
+        AE_THROW_RUNTIME_ERROR("Failed to create a surfaceless OpenGL context, error {:#x}", eglGetError());
+    }
+
+    // Requires EGL_KHR_surfaceless_context, which every display on the surfaceless platform exposes
+    if (!eglMakeCurrent(m_EGLDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, m_EGLContext))
+    {
+        AE_THROW_RUNTIME_ERROR("Failed to make the surfaceless OpenGL context current, error {:#x}", eglGetError());
+    }
+}
+
+void ae::OpenGLContext::DestroySurfacelessContext()
+{
+    eglMakeCurrent(m_EGLDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+    if (m_EGLContext != EGL_NO_CONTEXT)
+    {
+        eglDestroyContext(m_EGLDisplay, m_EGLContext);
+        m_EGLContext = EGL_NO_CONTEXT;
+    }
+
+    if (--s_SurfacelessContextCount == 0)
+    {
+        eglTerminate(m_EGLDisplay);
+    }
+
+    m_EGLDisplay = EGL_NO_DISPLAY;
+}
+#endif // AE_EGL
+
+void ae::OpenGLContext::CreateDefaultFramebuffer()
+{
+    GLsizei width = static_cast<GLsizei>(m_Window.GetWidth());
+    GLsizei height = static_cast<GLsizei>(m_Window.GetHeight());
+
+    GL_CHECK(glGenRenderbuffers(1, &m_ColorRenderbuffer));
+    GL_CHECK(glBindRenderbuffer(GL_RENDERBUFFER, m_ColorRenderbuffer));
+    GL_CHECK(glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height));
+
+    GL_CHECK(glGenRenderbuffers(1, &m_DepthStencilRenderbuffer));
+    GL_CHECK(glBindRenderbuffer(GL_RENDERBUFFER, m_DepthStencilRenderbuffer));
+    GL_CHECK(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height));
+
+    GL_CHECK(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+
+    GL_CHECK(glGenFramebuffers(1, &m_DefaultFramebuffer));
+    GL_CHECK(glBindFramebuffer(GL_FRAMEBUFFER, m_DefaultFramebuffer));
+    GL_CHECK(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorRenderbuffer));
+    GL_CHECK(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER,
+                                       m_DepthStencilRenderbuffer));
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        AE_THROW_RUNTIME_ERROR("Surfaceless default framebuffer is incomplete");
+    }
+
+    GL_CHECK(glViewport(0, 0, width, height));
+}
+
+void ae::OpenGLContext::DestroyDefaultFramebuffer()
+{
+    GL_CHECK(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+
+    GL_CHECK(glDeleteFramebuffers(1, &m_DefaultFramebuffer));
+    GL_CHECK(glDeleteRenderbuffers(1, &m_ColorRenderbuffer));
+    GL_CHECK(glDeleteRenderbuffers(1, &m_DepthStencilRenderbuffer));
+
+    m_DefaultFramebuffer = 0;
+    m_ColorRenderbuffer = 0;
+    m_DepthStencilRenderbuffer = 0;
+}
+
+void ae::OpenGLContext::CaptureFrame(FrameCapture &frameCapture, uint64_t frameNumber)
+{
+    // Fences signal in submission order, so the first unsignalled one ends the scan
+    for (uint32_t i = 0; i < m_CaptureSlots.size(); i++)
+    {
+        CaptureSlot &slot = m_CaptureSlots[(m_NextCaptureSlot + i) % m_CaptureSlots.size()];
+
+        if (!slot.fence)
+        {
+            continue;
+        }
+
+        GLenum status = glClientWaitSync(slot.fence, 0, 0);
+
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+        {
+            break;
+        }
+
+        HandOverCapture(frameCapture, slot);
+    }
+
+    if (!frameCapture.HasRequests())
+    {
+        return;
+    }
+
+    int width = static_cast<int>(m_Window.GetWidth());
+    int height = static_cast<int>(m_Window.GetHeight());
+
+    // A window's framebuffer can differ from its size in screen coordinates; the surfaceless FBO cannot
+    if (!m_Surfaceless)
+    {
+        glm::ivec2 framebufferSize = m_Window.GetFramebufferSize();
+        width = framebufferSize.x;
+        height = framebufferSize.y;
+    }
+
+    if (width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    if (std::cmp_not_equal(width, m_CaptureWidth) || std::cmp_not_equal(height, m_CaptureHeight))
+    {
+        FlushCaptures(frameCapture);
+        DestroyCaptureBuffers();
+        CreateCaptureBuffers(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+    }
+
+    CaptureSlot &slot = m_CaptureSlots[m_NextCaptureSlot];
+
+    // The ring is full, so the oldest capture is handed over before its buffer is reused
+    if (slot.fence)
+    {
+        glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        HandOverCapture(frameCapture, slot);
+    }
+
+    FrameCapture::WaitUntilReleased(slot.busy);
+
+    if (!frameCapture.TakeRequests(slot.requests))
+    {
+        return;
+    }
+
+    slot.frameNumber = frameNumber;
+
+    GL_CHECK(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_DefaultFramebuffer));
+    GL_CHECK(glReadBuffer(m_Surfaceless ? GL_COLOR_ATTACHMENT0 : GL_BACK));
+    GL_CHECK(glPixelStorei(GL_PACK_ALIGNMENT, 4));
+    GL_CHECK(glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer));
+    GL_CHECK(glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+    GL_CHECK(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    // Headless contexts never swap, which would otherwise be what flushes the fence to the GPU
+    glFlush();
+
+    m_NextCaptureSlot = (m_NextCaptureSlot + 1) % static_cast<uint32_t>(m_CaptureSlots.size());
+}
+
+void ae::OpenGLContext::FlushCaptures(FrameCapture &frameCapture)
+{
+    for (uint32_t i = 0; i < m_CaptureSlots.size(); i++)
+    {
+        CaptureSlot &slot = m_CaptureSlots[(m_NextCaptureSlot + i) % m_CaptureSlots.size()];
+
+        if (slot.fence)
+        {
+            glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            HandOverCapture(frameCapture, slot);
+        }
+    }
+}
+
+void ae::OpenGLContext::CreateCaptureBuffers(uint32_t width, uint32_t height)
+{
+    GLsizeiptr size = static_cast<GLsizeiptr>(width) * height * 4;
+
+    // Persistent, coherent mappings: once a buffer's fence has signalled the copy thread reads it directly, so
+    // the render thread never maps, copies or unmaps anything
+    constexpr GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    m_CaptureSlots = std::vector<CaptureSlot>(s_CaptureRingSize);
+    m_NextCaptureSlot = 0;
+    m_CaptureWidth = width;
+    m_CaptureHeight = height;
+
+    for (CaptureSlot &slot : m_CaptureSlots)
+    {
+        GL_CHECK(glGenBuffers(1, &slot.buffer));
+        GL_CHECK(glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer));
+        GL_CHECK(glBufferStorage(GL_PIXEL_PACK_BUFFER, size, nullptr, flags));
+
+        slot.pMapped = static_cast<uint8_t *>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, flags));
+
+        if (!slot.pMapped)
+        {
+            AE_THROW_RUNTIME_ERROR("Failed to map OpenGL frame capture buffer");
+        }
+    }
+
+    GL_CHECK(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+}
+
+void ae::OpenGLContext::DestroyCaptureBuffers()
+{
+    if (m_CaptureSlots.empty())
+    {
+        return;
+    }
+
+    for (CaptureSlot &slot : m_CaptureSlots)
+    {
+        // Captures still in flight are dropped; Window flushes them before destroying the context
+        if (slot.fence)
+        {
+            glDeleteSync(slot.fence);
+        }
+
+        FrameCapture::WaitUntilReleased(slot.busy);
+
+        GL_CHECK(glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer));
+        GL_CHECK(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+        GL_CHECK(glDeleteBuffers(1, &slot.buffer));
+    }
+
+    GL_CHECK(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+    m_CaptureSlots.clear();
+    m_CaptureWidth = 0;
+    m_CaptureHeight = 0;
+}
+
+void ae::OpenGLContext::HandOverCapture(FrameCapture &frameCapture, CaptureSlot &slot)
+{
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    slot.busy.store(true, std::memory_order_relaxed);
+
+    frameCapture.Submit({ .pPixels = slot.pMapped,
+                          .width = m_CaptureWidth,
+                          .height = m_CaptureHeight,
+                          .frameNumber = slot.frameNumber,
+                          .flipRows = true,
+                          .swapRedBlue = false,
+                          .pBusy = &slot.busy },
+                        slot.requests);
+}
+
 #if defined(AE_VULKAN) && defined(AE_DEBUG)
 ae::VulkanResources ae::OpenGLContext::GetVulkanResources() const
 {
@@ -1,7 +1,21 @@
 #pragma once
 
+#include "FrameCapture.h"
+#include "OpenGL.h"
 #include "Window.h"
 
+#include <atomic>
+#include <vector>
+
+#ifdef AE_EGL
+// Keeps eglplatform.h from pulling in Xlib and its macros
+#ifndef EGL_NO_X11
+#define EGL_NO_X11
+#endif
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif // AE_EGL
+
 namespace ae
 {
 	class OpenGLContext : public Context
@@ -12,13 +26,70 @@ namespace ae
 		OpenGLContext& operator=(const OpenGLContext&) = delete;
 		~OpenGLContext() = default;
 
+		// Surfaceless contexts (see Window::UsesSurfacelessContext) have no window-system framebuffer, so they render
+		// into an FBO the size of the window that takes its place. It is bound whenever the context is made
+		// current; code that binds framebuffer 0 to get back to the default one must bind this instead.
+		inline bool IsSurfaceless() const { return m_Surfaceless; }
+		inline uint32_t GetDefaultFramebuffer() const { return m_DefaultFramebuffer; }
+
+		// Frame capture through a ring of persistently mapped pixel buffers. CaptureFrame is called at the end
+		// of every frame once capture is in use: it hands captures whose fence has signalled to frameCapture and,
+		// if the frame was asked for, reads the default framebuffer into the next buffer and fences it. Only a
+		// full ring makes it wait, on a read issued s_CaptureRingSize captures ago.
+		void CaptureFrame(FrameCapture& frameCapture, uint64_t frameNumber);
+		// Blocks until every capture in the ring has been handed to frameCapture
+		void FlushCaptures(FrameCapture& frameCapture);
+
 #if defined(AE_VULKAN) && defined(AE_DEBUG)
 		VulkanResources GetVulkanResources() const override;
 #endif
 	protected:
+		inline bool IsThreadBound() const override { return true; }
+
 		bool CreateImpl() override;
 		void ActivateImpl() override;
 		void DeactivateImpl() override;
 		void DestroyImpl() override;
+	private:
+#ifdef AE_EGL
+		void CreateSurfacelessContext();
+		void DestroySurfacelessContext();
+#endif // AE_EGL
+
+		void CreateDefaultFramebuffer();
+		void DestroyDefaultFramebuffer();
+
+		struct CaptureSlot
+		{
+			uint32_t buffer = 0;
+			uint8_t* pMapped = nullptr;
+			GLsync fence = nullptr;
+			uint64_t frameNumber = 0;
+			std::vector<FrameCapture::Request> requests;
+			std::atomic<bool> busy = false;
+		};
+
+		void CreateCaptureBuffers(uint32_t width, uint32_t height);
+		void DestroyCaptureBuffers();
+		void HandOverCapture(FrameCapture& frameCapture, CaptureSlot& slot);
+	private:
+		bool m_Surfaceless = false;
+
+		uint32_t m_DefaultFramebuffer = 0;
+		uint32_t m_ColorRenderbuffer = 0;
+		uint32_t m_DepthStencilRenderbuffer = 0;
+
+		// Oldest capture first, starting at m_NextCaptureSlot
+		std::vector<CaptureSlot> m_CaptureSlots;
+		uint32_t m_NextCaptureSlot = 0;
+		uint32_t m_CaptureWidth = 0;
+		uint32_t m_CaptureHeight = 0;
+
+#ifdef AE_EGL
+		EGLDisplay m_EGLDisplay = EGL_NO_DISPLAY;
+		EGLContext m_EGLContext = EGL_NO_CONTEXT;
+#endif // AE_EGL
+	private:
+		static constexpr uint32_t s_CaptureRingSize = 3;
 	};
 }
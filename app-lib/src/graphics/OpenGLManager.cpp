@@ -4,11 +4,11 @@
 
 ae::OpenGLManager::OpenGLManager() : m_ContextCount(0), m_Version("None"), m_Renderer("None"), m_Vendor("None") {};
 
-void ae::OpenGLManager::AddContext()
+void ae::OpenGLManager::AddContext(GLADloadproc loader)
 {
     if (m_ContextCount == 0)
     {
-        if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+        if (!gladLoadGLLoader(loader))
         {
             AE_THROW_RUNTIME_ERROR("Failed to initialize GLAD when first graphics Context was created");
             return;
@@ -19,7 +19,8 @@ namespace ae
 			return instance;
 		}
 
-		void AddContext();
+		// The loader resolves GL entry points for GLAD when the first context is added
+		void AddContext(GLADloadproc loader);
 		void RemoveContext();
 
 		inline uint32_t GetContextCount() const { return m_ContextCount; }
@@ -0,0 +1,378 @@
+#include "general/pch.h"
+
+#ifdef AE_VULKAN
+
+#include "VulkanCommandAllocator.h"
+#include "VulkanManager.h"
+
+#include <algorithm>
+
+namespace
+{
+
+// Secondary buffers only continue a pass when the inheritance describes one, either as a render pass or as
+// dynamic rendering chained into pNext
+bool ContinuesRendering(const VkCommandBufferInheritanceInfo &inheritance)
+{
+    if (inheritance.renderPass != VK_NULL_HANDLE)
+    {
+        return true;
+    }
+
+    const auto *pNext = static_cast<const VkBaseInStructure *>(inheritance.pNext);
+
+    while (pNext)
+    {
+        if (pNext->sType == VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR)
+        {
+            return true;
+        }
+
+        pNext = pNext->pNext;
+    }
+
+    return false;
+}
+
+// Expires when the calling thread exits, which tells allocators its pools can go
+std::weak_ptr<int> GetThreadToken()
+{
+    static thread_local std::shared_ptr<int> t_pToken = std::make_shared<int>(0);
+
+    return t_pToken;
+}
+
+} // namespace
+
+ae::VulkanCommandAllocator::VulkanCommandAllocator(uint32_t framesInFlight, uint32_t queueFamilyIndex)
+    : m_Id(s_NextId.fetch_add(1, std::memory_order_relaxed)), m_FramesInFlight(framesInFlight),
+      m_QueueFamilyIndex(queueFamilyIndex)
+{
+}
+
+ae::VulkanCommandAllocator::~VulkanCommandAllocator()
+{
+    StopWorkers();
+
+    VkDevice device = VulkanManager::Get().GetDevice();
+
+    // Destroying a pool frees every buffer allocated from it
+    for (std::unique_ptr<ThreadPools> &pThreadPools : m_ThreadPools)
+    {
+        for (FramePool &framePool : pThreadPools->frames)
+        {
+            if (framePool.pool != VK_NULL_HANDLE)
+            {
+                vkDestroyCommandPool(device, framePool.pool, nullptr);
+            }
+        }
+    }
+}
+
+void ae::VulkanCommandAllocator::BeginFrame(uint32_t frameIndex)
+{
+    std::scoped_lock lock(m_RegistryMutex);
+
+    m_FrameIndex = frameIndex;
+
+    VkDevice device = VulkanManager::Get().GetDevice();
+
+    for (auto it = m_ThreadPools.begin(); it != m_ThreadPools.end();)
+    {
+        ThreadPools &threadPools = **it;
+        FramePool &framePool = threadPools.frames[frameIndex];
+
+        // An exited thread records nothing more, and this slot's buffers have completed, so its pool can go.
+        // Buffers in the other slots may still be in flight; those pools go when their slots come round.
+        if (threadPools.owner.expired())
+        {
+            ForgetThread(threadPools);
+
+            if (framePool.pool != VK_NULL_HANDLE)
+            {
+                vkDestroyCommandPool(device, framePool.pool, nullptr);
+                framePool = {};
+            }
+
+            if (std::ranges::all_of(threadPools.frames,
+                                    [](const FramePool &pool) { return pool.pool == VK_NULL_HANDLE; }))
+            {
+                it = m_ThreadPools.erase(it);
+                continue;
+            }
+
+            ++it;
+            continue;
+        }
+
+        if (framePool.primaryUsed != 0 || framePool.secondaryUsed != 0)
+        {
+            VK_CHECK(vkResetCommandPool(device, framePool.pool, 0));
+
+            framePool.primaryUsed = 0;
+            framePool.secondaryUsed = 0;
+        }
+
+        ++it;
+    }
+}
+
+VkCommandBuffer ae::VulkanCommandAllocator::Allocate(VkCommandBufferLevel level)
+{
+    FramePool &framePool = GetThreadPools().frames[m_FrameIndex];
+
+    bool primary = level == VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    std::vector<VkCommandBuffer> &buffers = primary ? framePool.primary : framePool.secondary;
+    uint32_t &used = primary ? framePool.primaryUsed : framePool.secondaryUsed;
+
+    // Buffers are kept across frames and reused after the pool reset; new ones are only allocated when a
+    // thread records more than it ever has before
+    if (used == buffers.size())
+    {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = framePool.pool;
+        allocInfo.level = level;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+
+        if (vkAllocateCommandBuffers(VulkanManager::Get().GetDevice(), &allocInfo, &commandBuffer) != VK_SUCCESS)
+        {
+            AE_THROW_RUNTIME_ERROR("Failed to allocate frame command buffer");
+        }
+
+        buffers.push_back(commandBuffer);
+    }
+
+    return buffers[used++];
+}
+
+void ae::VulkanCommandAllocator::RecordParallel(std::span<VkCommandBuffer> commandBuffers,
+                                                const VkCommandBufferInheritanceInfo *pInheritance,
+                                                const std::function<void(VkCommandBuffer, uint32_t)> &record)
+{
+    if (commandBuffers.empty())
+    {
+        return;
+    }
+
+    // One parallel job at a time; concurrent callers queue up here
+    std::scoped_lock recordLock(m_RecordMutex);
+
+    if (m_Workers.empty())
+    {
+        StartWorkers();
+    }
+
+    ParallelJob job;
+    job.commandBuffers = commandBuffers;
+    job.pInheritance = pInheritance;
+    job.pRecord = &record;
+
+    {
+        std::scoped_lock lock(m_JobMutex);
+        m_pJob = &job;
+        m_JobGeneration++;
+    }
+
+    m_WorkCondition.notify_all();
+
+    // The calling thread records too, so a job never waits on workers that are slow to wake
+    RunJob(job);
+
+    {
+        std::unique_lock lock(m_JobMutex);
+        m_pJob = nullptr;
+        m_DoneCondition.wait(lock, [&job] { return job.activeWorkers == 0; });
+    }
+
+    if (job.exception)
+    {
+        std::rethrow_exception(job.exception);
+    }
+}
+
+ae::VulkanCommandAllocator::ThreadPools &ae::VulkanCommandAllocator::GetThreadPools()
+{
+    // Small cache per thread, so a thread recording for several windows finds each allocator's pools without
+    // the registry lock. The id rather than the address identifies the allocator, so a new allocator created at
+    // the address of a destroyed one never hits a stale entry.
+    struct CacheEntry
+    {
+        uint64_t id = 0;
+        ThreadPools *pPools = nullptr;
+    };
+
+    static thread_local std::array<CacheEntry, s_ThreadCacheSize> t_Cache;
+    static thread_local uint32_t t_NextCacheEntry = 0;
+
+    for (const CacheEntry &entry : t_Cache)
+    {
+        if (entry.id == m_Id)
+        {
+            return *entry.pPools;
+        }
+    }
+
+    ThreadPools &threadPools = RegisterThread();
+
+    t_Cache[t_NextCacheEntry] = CacheEntry{ .id = m_Id, .pPools = &threadPools };
+    t_NextCacheEntry = (t_NextCacheEntry + 1) % s_ThreadCacheSize;
+
+    return threadPools;
+}
+
+ae::VulkanCommandAllocator::ThreadPools &ae::VulkanCommandAllocator::RegisterThread()
+{
+    std::scoped_lock lock(m_RegistryMutex);
+
+    auto it = m_ThreadLookup.find(std::this_thread::get_id());
+
+    // A new thread can get the id of one that has exited, whose pools are on their way out
+    if (it != m_ThreadLookup.end() && !it->second->owner.expired())
+    {
+        return *it->second;
+    }
+
+    if (it != m_ThreadLookup.end())
+    {
+        m_ThreadLookup.erase(it);
+    }
+
+    ThreadPools &threadPools = *m_ThreadPools.emplace_back(std::make_unique<ThreadPools>());
+    threadPools.frames.resize(m_FramesInFlight);
+    threadPools.threadId = std::this_thread::get_id();
+    threadPools.owner = GetThreadToken();
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.queueFamilyIndex = m_QueueFamilyIndex;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+    for (FramePool &framePool : threadPools.frames)
+    {
+        if (vkCreateCommandPool(VulkanManager::Get().GetDevice(), &poolInfo, nullptr, &framePool.pool) != VK_SUCCESS)
+        {
+            AE_THROW_RUNTIME_ERROR("Failed to create per-thread command pool");
+        }
+    }
+
+    m_ThreadLookup.emplace(std::this_thread::get_id(), &threadPools);
+
+    return threadPools;
+}
+
+void ae::VulkanCommandAllocator::ForgetThread(const ThreadPools &threadPools)
+{
+    auto it = m_ThreadLookup.find(threadPools.threadId);
+
+    if (it != m_ThreadLookup.end() && it->second == &threadPools)
+    {
+        m_ThreadLookup.erase(it);
+    }
+}
+
+void ae::VulkanCommandAllocator::RunJob(ParallelJob &job)
+{
+    while (true)
+    {
+        uint32_t index = job.nextIndex.fetch_add(1, std::memory_order_relaxed);
+
+        if (index >= job.commandBuffers.size())
+        {
+            break;
+        }
+
+        try
+        {
+            RecordOne(job, index);
+        }
+        catch (...)
+        {
+            std::scoped_lock lock(m_JobMutex);
+
+            if (!job.exception)
+            {
+                job.exception = std::current_exception();
+            }
+        }
+    }
+}
+
+void ae::VulkanCommandAllocator::RecordOne(ParallelJob &job, uint32_t index)
+{
+    VkCommandBufferLevel level = job.pInheritance ? VK_COMMAND_BUFFER_LEVEL_SECONDARY : VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    VkCommandBuffer commandBuffer = Allocate(level);
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.pInheritanceInfo = job.pInheritance;
+
+    if (job.pInheritance && ContinuesRendering(*job.pInheritance))
+    {
+        beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    }
+
+    VK_CHECK(vkBeginCommandBuffer(commandBuffer, &beginInfo));
+    (*job.pRecord)(commandBuffer, index);
+    VK_CHECK(vkEndCommandBuffer(commandBuffer));
+
+    job.commandBuffers[index] = commandBuffer;
+}
+
+void ae::VulkanCommandAllocator::StartWorkers()
+{
+    uint32_t workerCount = std::clamp(std::thread::hardware_concurrency(), 2u, s_MaxWorkers + 1) - 1;
+
+    m_Workers.reserve(workerCount);
+
+    for (uint32_t i = 0; i < workerCount; i++)
+    {
+        m_Workers.emplace_back([this](std::stop_token stopToken) { WorkerLoop(stopToken); });
+    }
+}
+
+void ae::VulkanCommandAllocator::StopWorkers()
+{
+    // std::jthread requests a stop and joins on destruction, which also wakes the condition variable wait
+    m_Workers.clear();
+}
+
+void ae::VulkanCommandAllocator::WorkerLoop(std::stop_token stopToken)
+{
+    uint64_t seenGeneration = 0;
+
+    while (true)
+    {
+        ParallelJob *pJob = nullptr;
+
+        {
+            std::unique_lock lock(m_JobMutex);
+
+            bool hasJob = m_WorkCondition.wait(lock, stopToken, [this, &seenGeneration]
+                                               { return m_pJob && m_JobGeneration != seenGeneration; });
+
+            if (!hasJob)
+            {
+                return;
+            }
+
+            seenGeneration = m_JobGeneration;
+            pJob = m_pJob;
+            pJob->activeWorkers++;
+        }
+
+        RunJob(*pJob);
+
+        {
+            std::scoped_lock lock(m_JobMutex);
+            pJob->activeWorkers--;
+        }
+
+        m_DoneCondition.notify_all();
+    }
+}
+
+#endif // AE_VULKAN
@@ -0,0 +1,109 @@
+#pragma once
+
+#ifdef AE_VULKAN
+
+#include "Vulkan.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ae
+{
+	// Frame-scoped command buffers. Every thread that allocates gets its own VkCommandPool per frame in
+	// flight, so recording never contends on a pool, and all pools of a frame slot are reset in one go once
+	// that slot's previous frame has completed. Buffers are only valid until the same slot comes round again.
+	// Pools of threads that have exited are destroyed slot by slot in the same place.
+	class VulkanCommandAllocator
+	{
+	public:
+		VulkanCommandAllocator(uint32_t framesInFlight, uint32_t queueFamilyIndex);
+		VulkanCommandAllocator(const VulkanCommandAllocator&) = delete;
+		VulkanCommandAllocator& operator=(const VulkanCommandAllocator&) = delete;
+		~VulkanCommandAllocator();
+
+		// Must be called with no thread recording, after the slot's previous frame has completed
+		void BeginFrame(uint32_t frameIndex);
+
+		// Thread-safe. The buffer is not begun.
+		VkCommandBuffer Allocate(VkCommandBufferLevel level);
+
+		// Records commandBuffers.size() buffers across the worker threads and the calling thread, then returns
+		// once all of them have ended. With pInheritance the buffers are secondary and continue the render pass
+		// (or dynamic rendering) it describes; without it they are primary. The callback receives the begun
+		// buffer and its index, and must not begin or end it.
+		void RecordParallel(std::span<VkCommandBuffer> commandBuffers, const VkCommandBufferInheritanceInfo* pInheritance,
+			const std::function<void(VkCommandBuffer, uint32_t)>& record);
+	private:
+		struct FramePool
+		{
+			VkCommandPool pool = VK_NULL_HANDLE;
+			std::vector<VkCommandBuffer> primary;
+			std::vector<VkCommandBuffer> secondary;
+			uint32_t primaryUsed = 0;
+			uint32_t secondaryUsed = 0;
+		};
+
+		struct ThreadPools
+		{
+			std::vector<FramePool> frames;
+			std::thread::id threadId;
+			std::weak_ptr<int> owner; // Expires when the thread exits
+		};
+
+		struct ParallelJob
+		{
+			std::span<VkCommandBuffer> commandBuffers;
+			const VkCommandBufferInheritanceInfo* pInheritance = nullptr;
+			const std::function<void(VkCommandBuffer, uint32_t)>* pRecord = nullptr;
+			std::atomic<uint32_t> nextIndex = 0;
+			uint32_t activeWorkers = 0;
+			std::exception_ptr exception;
+		};
+
+		ThreadPools& GetThreadPools();
+		ThreadPools& RegisterThread();
+		// Drops the lookup entry of an exited thread, unless a new thread with its id has taken it over
+		void ForgetThread(const ThreadPools& threadPools);
+
+		void RunJob(ParallelJob& job);
+		void RecordOne(ParallelJob& job, uint32_t index);
+
+		void StartWorkers();
+		void StopWorkers();
+		void WorkerLoop(std::stop_token stopToken);
+	private:
+		uint64_t m_Id;
+		uint32_t m_FramesInFlight;
+		uint32_t m_QueueFamilyIndex;
+		uint32_t m_FrameIndex = 0;
+
+		// Owned through pointers, so those handed to threads stay valid while other threads register or exit
+		std::mutex m_RegistryMutex;
+		std::vector<std::unique_ptr<ThreadPools>> m_ThreadPools;
+		std::unordered_map<std::thread::id, ThreadPools*> m_ThreadLookup;
+
+		std::mutex m_JobMutex;
+		std::condition_variable_any m_WorkCondition;
+		std::condition_variable m_DoneCondition;
+		std::mutex m_RecordMutex;
+		ParallelJob* m_pJob = nullptr;
+		uint64_t m_JobGeneration = 0;
+		std::vector<std::jthread> m_Workers;
+	private:
+		static constexpr uint32_t s_MaxWorkers = 8;
+		static constexpr uint32_t s_ThreadCacheSize = 4; // Allocators a thread finds its pools in without locking
+		static inline std::atomic<uint64_t> s_NextId = 1;
+	};
+}
+
+#endif // AE_VULKAN
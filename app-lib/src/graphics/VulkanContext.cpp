@@ -3,16 +3,60 @@
 #ifdef AE_VULKAN
 
 #include "DearImGui.h"
+#include "VulkanCommandAllocator.h"
 #include "VulkanContext.h"
+#include "VulkanDeletionQueue.h"
+#include "VulkanShaderRegistry.h"
+#include "VulkanUploadManager.h"
 #include "backends/imgui_impl_vulkan.h"
 
 #include <algorithm>
+#include <span>
+
+namespace
+{
+
+VkPresentModeKHR ToVkPresentMode(ae::PresentMode mode)
+{
+    switch (mode)
+    {
+    case ae::PresentMode::IMMEDIATE:
+        return VK_PRESENT_MODE_IMMEDIATE_KHR;
+    case ae::PresentMode::MAILBOX:
+        return VK_PRESENT_MODE_MAILBOX_KHR;
+    case ae::PresentMode::FIFO_RELAXED:
+        return VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+    case ae::PresentMode::FIFO:
+    default:
+        return VK_PRESENT_MODE_FIFO_KHR;
+    }
+}
+
+// Capture copies the image bytes as they are, so only 8-bit, four-channel formats can become RGBA ImageFiles
+bool IsCapturableFormat(VkFormat format)
+{
+    switch (format)
+    {
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace
 
 ae::VulkanContext::VulkanContext(Window &window)
-    : Context(window), m_FramesInFlight(0), m_Surface(VK_NULL_HANDLE), m_SwapChain(VK_NULL_HANDLE),
+    : Context(window), m_FramesInFlight(0), m_Headless(false), m_Surface(VK_NULL_HANDLE), m_SwapChain(VK_NULL_HANDLE),
       m_SwapChainImageFormat(VK_FORMAT_UNDEFINED), m_SwapChainExtent(), m_ImGuiStandaloneRenderPass(VK_NULL_HANDLE),
-      m_ImGuiOverlayRenderPass(VK_NULL_HANDLE), m_CommandPool(VK_NULL_HANDLE), m_CurrentFrame(0),
-      m_CurrentImageIndex(0), m_NeedsResize(false)
+      m_ImGuiOverlayRenderPass(VK_NULL_HANDLE), m_DynamicRendering(false), m_CommandPool(VK_NULL_HANDLE),
+      m_FrameTimeline(VK_NULL_HANDLE), m_HostTimeline(VK_NULL_HANDLE), m_HostDependencyValue(0), m_FrameNumber(1),
+      m_CompletedFrameNumber(0),
+      m_PresentMode(VK_PRESENT_MODE_FIFO_KHR), m_FirstSwapChainPresentId(1), m_LastPresentId(0),
+      m_FrameBeginTimes(), m_PresentLatency(0.0), m_CurrentFrame(0), m_CurrentImageIndex(0), m_NeedsResize(false)
 {
 }
 
@@ -28,25 +72,58 @@ ae::FrameInfo ae::VulkanContext::BeginFrame()
 
     VkDevice device = VulkanManager::Get().GetDevice();
 
-    vkWaitForFences(device, 1, &m_InFlightFences[m_CurrentFrame], VK_TRUE, UINT64_MAX);
+    m_FrameBeginTimes[m_FrameNumber % m_FrameBeginTimes.size()] = m_LatencyTimer.GetElapsedTime();
+
+    WaitForFrameSlot(m_CurrentFrame);
+    ReleaseRetiredSwapChains(false);
 
-    VkResult result = vkAcquireNextImageKHR(device, m_SwapChain, UINT64_MAX, m_ImageAvailableSemaphores[m_CurrentFrame],
-                                            VK_NULL_HANDLE, &m_CurrentImageIndex);
+    VulkanManager::Get().GetDeletionQueue().Collect(m_DeletionSource, m_FrameNumber, GetCompletedFrameNumber());
 
-    if (result == VK_ERROR_OUT_OF_DATE_KHR)
+    VulkanShaderRegistry *pShaders = VulkanManager::Get().FindShaderRegistry();
+
+    if (pShaders)
     {
-        RecreateSwapChain();
-        // Retry acquire after recreation
-        result = vkAcquireNextImageKHR(device, m_SwapChain, UINT64_MAX, m_ImageAvailableSemaphores[m_CurrentFrame],
-                                       VK_NULL_HANDLE, &m_CurrentImageIndex);
+        pShaders->Poll();
     }
 
-    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+    if (m_CaptureSlots[m_CurrentFrame].pending)
     {
-        AE_THROW_RUNTIME_ERROR("Failed to acquire Vulkan swapchain image");
+        HandOverCapture(m_CaptureSlots[m_CurrentFrame]);
     }
 
-    vkResetFences(device, 1, &m_InFlightFences[m_CurrentFrame]);
+    m_pCommandAllocator->BeginFrame(m_CurrentFrame);
+
+    if (m_Headless)
+    {
+        // Each frame slot owns one offscreen target, which is free again once the slot's last frame completed
+        m_CurrentImageIndex = m_CurrentFrame;
+    }
+    else
+    {
+        ThrottlePresents();
+
+        VkResult result = vkAcquireNextImageKHR(device, m_SwapChain, UINT64_MAX,
+                                                m_ImageAvailableSemaphores[m_CurrentFrame], VK_NULL_HANDLE,
+                                                &m_CurrentImageIndex);
+
+        if (result == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            RecreateSwapChain();
+            // Retry acquire after recreation
+            result = vkAcquireNextImageKHR(device, m_SwapChain, UINT64_MAX, m_ImageAvailableSemaphores[m_CurrentFrame],
+                                           VK_NULL_HANDLE, &m_CurrentImageIndex);
+        }
+
+        if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+        {
+            AE_THROW_RUNTIME_ERROR("Failed to acquire Vulkan swapchain image");
+        }
+    }
+
+    if (!IsFrameTimelineEnabled())
+    {
+        vkResetFences(device, 1, &m_InFlightFences[m_CurrentFrame]);
+    }
 
     return { .imageIndex = m_CurrentImageIndex,
              .frameIndex = m_CurrentFrame,
@@ -56,62 +133,144 @@ ae::FrameInfo ae::VulkanContext::BeginFrame()
 
 void ae::VulkanContext::EndFrame(const VkCommandBuffer *appCommandBuffers, uint32_t appCBCount, bool hasImGui)
 {
-    std::vector<VkCommandBuffer> allCBs;
-    allCBs.reserve(appCBCount + 1);
+    // Fixed-capacity arrays keep the steady-state frame free of heap allocations
+    if (appCBCount > s_MaxFrameCommandBuffers - s_InternalFrameCommandBuffers)
+    {
+        AE_THROW_RUNTIME_ERROR("Too many command buffers passed to EndFrame ({}, max {})", appCBCount,
+                               s_MaxFrameCommandBuffers - s_InternalFrameCommandBuffers);
+    }
+
+    std::array<VkCommandBuffer, s_MaxFrameCommandBuffers> allCBs;
+    uint32_t cbCount = 0;
 
     if (appCBCount > 0)
     {
-        allCBs.insert(allCBs.end(), appCommandBuffers, appCommandBuffers + appCBCount);
+        std::copy_n(appCommandBuffers, appCBCount, allCBs.begin());
+        cbCount = appCBCount;
     }
 
-    if (hasImGui)
+    if (hasImGui && m_DynamicRendering)
+    {
+        // The final transition is recorded into the ImGui command buffer, so this is the frame's last one
+        allCBs[cbCount++] = RecordImGuiDynamic(appCBCount > 0);
+    }
+    else if (hasImGui)
     {
         if (appCBCount > 0)
         {
-            allCBs.push_back(RecordImGuiOverlay());
+            allCBs[cbCount++] = RecordImGuiOverlay();
         }
         else
         {
-            allCBs.push_back(RecordImGuiStandalone());
+            allCBs[cbCount++] = RecordImGuiStandalone();
         }
     }
     else if (appCBCount > 0)
     {
-        allCBs.push_back(RecordTransitionToPresent());
+        allCBs[cbCount++] = RecordTransitionToPresent(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    }
+    else
+    {
+        // Nothing was drawn, but the image still has to reach the present layout
+        allCBs[cbCount++] = RecordTransitionToPresent(VK_IMAGE_LAYOUT_UNDEFINED);
     }
 
-    if (!allCBs.empty())
+    if (m_pFrameCapture && m_pFrameCapture->HasRequests())
     {
-        std::array<VkSemaphore, 1> waitSemaphores = { m_ImageAvailableSemaphores[m_CurrentFrame] };
-        std::array<VkPipelineStageFlags, 1> waitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-        std::array<VkSemaphore, 1> signalSemaphores = { m_RenderFinishedSemaphores[m_CurrentImageIndex] };
+        VkCommandBuffer captureCB = RecordCapture();
+
+        if (captureCB != VK_NULL_HANDLE)
+        {
+            allCBs[cbCount++] = captureCB;
+        }
+    }
+
+    // Always submit, even for an empty frame, so the image-available wait is consumed and the frame slot's
+    // fence or timeline value is signaled; otherwise the next use of this slot would wait forever
+    std::array<FrameSemaphore, s_MaxFrameWaits> waits{};
+    std::array<FrameSemaphore, s_MaxFrameSignals> signals{};
+    uint32_t waitCount = 0;
+    uint32_t signalCount = 0;
 
-        VkSubmitInfo submitInfo{};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.waitSemaphoreCount = 1;
-        submitInfo.pWaitSemaphores = waitSemaphores.data();
-        submitInfo.pWaitDstStageMask = waitStages.data();
-        submitInfo.commandBufferCount = static_cast<uint32_t>(allCBs.size());
-        submitInfo.pCommandBuffers = allCBs.data();
-        submitInfo.signalSemaphoreCount = 1;
-        submitInfo.pSignalSemaphores = signalSemaphores.data();
+    if (!m_Headless)
+    {
+        waits[waitCount++] = { m_ImageAvailableSemaphores[m_CurrentFrame], 0,
+                               VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+    }
 
-        if (VulkanManager::Get().SubmitToQueue(submitInfo, m_InFlightFences[m_CurrentFrame]) != VK_SUCCESS)
+    // Uploads recorded this frame are submitted now and waited on by the GPU, not the CPU
+    VulkanUploadManager *pUploads = VulkanManager::Get().FindUploadManager();
+
+    if (pUploads)
+    {
+        uint64_t uploadValue = pUploads->Flush();
+
+        if (!pUploads->IsComplete(uploadValue))
         {
-            AE_THROW_RUNTIME_ERROR("Failed to submit Vulkan command buffers");
+            waits[waitCount++] = { pUploads->GetTimelineSemaphore(), uploadValue, s_UploadWaitStages };
         }
     }
 
-    // Present
+    if (m_HostDependencyValue > 0)
+    {
+        waits[waitCount++] = { m_HostTimeline, m_HostDependencyValue, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT };
+        m_HostDependencyValue = 0;
+    }
+
+    if (!m_Headless)
+    {
+        signals[signalCount++] = { m_RenderFinishedSemaphores[m_CurrentImageIndex], 0,
+                                   VK_PIPELINE_STAGE_ALL_COMMANDS_BIT };
+    }
+
+    if (IsFrameTimelineEnabled())
+    {
+        signals[signalCount++] = { m_FrameTimeline, m_FrameNumber, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT };
+    }
+
+    VkFence fence = IsFrameTimelineEnabled() ? VK_NULL_HANDLE : m_InFlightFences[m_CurrentFrame];
+
+    std::span<const VkCommandBuffer> commandBuffers(allCBs.data(), cbCount);
+    std::span<const FrameSemaphore> waitSpan(waits.data(), waitCount);
+    std::span<const FrameSemaphore> signalSpan(signals.data(), signalCount);
+
+    VkResult result = VulkanManager::Get().IsSynchronization2Enabled()
+                          ? SubmitFrame2(commandBuffers, waitSpan, signalSpan, fence)
+                          : SubmitFrame(commandBuffers, waitSpan, signalSpan, fence);
+
+    if (result != VK_SUCCESS)
+    {
+        AE_THROW_RUNTIME_ERROR("Failed to submit Vulkan command buffers");
+    }
+
+    m_FrameSlotValues[m_CurrentFrame] = m_FrameNumber;
+    m_FrameNumber++;
+
+    if (m_Headless)
+    {
+        m_CurrentFrame = (m_CurrentFrame + 1) % m_FramesInFlight;
+        return;
+    }
+
+    // Present, tagged with the frame number so BeginFrame can wait for it to reach the display
+    uint64_t presentId = m_FrameNumber - 1;
+
+    VkPresentIdKHR presentIdInfo{};
+    presentIdInfo.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+    presentIdInfo.swapchainCount = 1;
+    presentIdInfo.pPresentIds = &presentId;
+
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+    presentInfo.pNext = VulkanManager::Get().IsPresentWaitEnabled() ? &presentIdInfo : nullptr;
     presentInfo.waitSemaphoreCount = 1;
     presentInfo.pWaitSemaphores = &m_RenderFinishedSemaphores[m_CurrentImageIndex];
     presentInfo.swapchainCount = 1;
     presentInfo.pSwapchains = &m_SwapChain;
     presentInfo.pImageIndices = &m_CurrentImageIndex;
 
-    VkResult result = VulkanManager::Get().PresentToQueue(presentInfo);
+    result = VulkanManager::Get().PresentToQueue(presentInfo);
+    m_LastPresentId = presentId;
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
     {
@@ -125,9 +284,257 @@ void ae::VulkanContext::EndFrame(const VkCommandBuffer *appCommandBuffers, uint3
     m_CurrentFrame = (m_CurrentFrame + 1) % m_FramesInFlight;
 }
 
+uint64_t ae::VulkanContext::GetCompletedFrameNumber() const
+{
+    if (IsFrameTimelineEnabled())
+    {
+        uint64_t completed = 0;
+        vkGetSemaphoreCounterValue(VulkanManager::Get().GetDevice(), m_FrameTimeline, &completed);
+        return completed;
+    }
+
+    uint64_t completed = m_CompletedFrameNumber;
+
+    for (uint32_t i = 0; i < m_FramesInFlight; i++)
+    {
+        if (m_FrameSlotValues[i] > completed &&
+            vkGetFenceStatus(VulkanManager::Get().GetDevice(), m_InFlightFences[i]) == VK_SUCCESS)
+        {
+            completed = m_FrameSlotValues[i];
+        }
+    }
+
+    return completed;
+}
+
+void ae::VulkanContext::WaitForSubmittedFrames() const
+{
+    if (m_FrameNumber > 1)
+    {
+        WaitForFrame(m_FrameNumber - 1);
+    }
+}
+
+bool ae::VulkanContext::IsFrameComplete(uint64_t frameNumber) const
+{
+    return frameNumber <= m_CompletedFrameNumber || GetCompletedFrameNumber() >= frameNumber;
+}
+
+void ae::VulkanContext::WaitForFrame(uint64_t frameNumber) const
+{
+    if (frameNumber >= m_FrameNumber)
+    {
+        AE_THROW_RUNTIME_ERROR("Tried to wait for frame {} which has not been submitted yet", frameNumber);
+    }
+
+    if (frameNumber <= m_CompletedFrameNumber)
+    {
+        return;
+    }
+
+    VkDevice device = VulkanManager::Get().GetDevice();
+
+    if (IsFrameTimelineEnabled())
+    {
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_FrameTimeline;
+        waitInfo.pValues = &frameNumber;
+
+        VK_CHECK(vkWaitSemaphores(device, &waitInfo, UINT64_MAX));
+        return;
+    }
+
+    // Fences signal in submission order, so waiting for the oldest slot at or past the frame is enough
+    uint32_t slot = m_FramesInFlight;
+
+    for (uint32_t i = 0; i < m_FramesInFlight; i++)
+    {
+        bool isOlder = slot == m_FramesInFlight || m_FrameSlotValues[i] < m_FrameSlotValues[slot];
+
+        if (m_FrameSlotValues[i] >= frameNumber && isOlder)
+        {
+            slot = i;
+        }
+    }
+
+    if (slot < m_FramesInFlight)
+    {
+        vkWaitForFences(device, 1, &m_InFlightFences[slot], VK_TRUE, UINT64_MAX);
+    }
+}
+
+void ae::VulkanContext::AddHostDependency(uint64_t value)
+{
+    if (!IsFrameTimelineEnabled())
+    {
+        AE_THROW_RUNTIME_ERROR("Host dependencies require DeviceFeature::TimelineSemaphore");
+    }
+
+    m_HostDependencyValue = std::max(m_HostDependencyValue, value);
+}
+
+void ae::VulkanContext::SignalHost(uint64_t value)
+{
+    if (!IsFrameTimelineEnabled())
+    {
+        AE_THROW_RUNTIME_ERROR("Host signalling requires DeviceFeature::TimelineSemaphore");
+    }
+
+    VkSemaphoreSignalInfo signalInfo{};
+    signalInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO;
+    signalInfo.semaphore = m_HostTimeline;
+    signalInfo.value = value;
+
+    VK_CHECK(vkSignalSemaphore(VulkanManager::Get().GetDevice(), &signalInfo));
+}
+
+void ae::VulkanContext::ThrottlePresents()
+{
+    uint32_t maxQueued = m_Window.GetDesc().maxQueuedPresents;
+
+    if (maxQueued == 0 || !VulkanManager::Get().IsPresentWaitEnabled() || m_LastPresentId <= maxQueued)
+    {
+        return;
+    }
+
+    // Leave at most maxQueued presents pending. Ids presented to a retired swapchain are never reported by
+    // the current one, so those are skipped rather than waited on.
+    uint64_t targetId = m_LastPresentId - maxQueued;
+
+    if (targetId < m_FirstSwapChainPresentId)
+    {
+        return;
+    }
+
+    VkResult result = VulkanManager::Get().WaitForPresent(m_SwapChain, targetId, s_PresentWaitTimeout);
+
+    if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR)
+    {
+        if (m_FrameNumber - targetId <= m_FrameBeginTimes.size())
+        {
+            m_PresentLatency = m_LatencyTimer.GetElapsedTime() - m_FrameBeginTimes[targetId % m_FrameBeginTimes.size()];
+        }
+    }
+    else if (result == VK_ERROR_OUT_OF_DATE_KHR)
+    {
+        m_NeedsResize = true;
+    }
+    else if (result != VK_TIMEOUT)
+    {
+        AE_THROW_RUNTIME_ERROR("Failed to wait for Vulkan present");
+    }
+}
+
+void ae::VulkanContext::WaitForFrameSlot(uint32_t slot)
+{
+    if (IsFrameTimelineEnabled())
+    {
+        WaitForFrame(m_FrameSlotValues[slot]);
+    }
+    else
+    {
+        vkWaitForFences(VulkanManager::Get().GetDevice(), 1, &m_InFlightFences[slot], VK_TRUE, UINT64_MAX);
+    }
+
+    m_CompletedFrameNumber = std::max(m_CompletedFrameNumber, m_FrameSlotValues[slot]);
+}
+
+VkResult ae::VulkanContext::SubmitFrame(std::span<const VkCommandBuffer> commandBuffers,
+                                        std::span<const FrameSemaphore> waits,
+                                        std::span<const FrameSemaphore> signals, VkFence fence)
+{
+    std::array<VkSemaphore, s_MaxFrameWaits> waitSemaphores{};
+    std::array<VkPipelineStageFlags, s_MaxFrameWaits> waitStages{};
+    std::array<uint64_t, s_MaxFrameWaits> waitValues{};
+    std::array<VkSemaphore, s_MaxFrameSignals> signalSemaphores{};
+    std::array<uint64_t, s_MaxFrameSignals> signalValues{};
+    bool usesTimeline = false;
+
+    for (size_t i = 0; i < waits.size(); i++)
+    {
+        waitSemaphores[i] = waits[i].semaphore;
+        waitStages[i] = waits[i].stages;
+        waitValues[i] = waits[i].value;
+        usesTimeline |= waits[i].value > 0;
+    }
+
+    for (size_t i = 0; i < signals.size(); i++)
+    {
+        signalSemaphores[i] = signals[i].semaphore;
+        signalValues[i] = signals[i].value;
+        usesTimeline |= signals[i].value > 0;
+    }
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waits.size());
+    timelineInfo.pWaitSemaphoreValues = waitValues.data();
+    timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signals.size());
+    timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = usesTimeline ? &timelineInfo : nullptr;
+    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waits.size());
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
+    submitInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());
+    submitInfo.pCommandBuffers = commandBuffers.data();
+    submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signals.size());
+    submitInfo.pSignalSemaphores = signalSemaphores.data();
+
+    return VulkanManager::Get().SubmitToQueue(submitInfo, fence);
+}
+
+VkResult ae::VulkanContext::SubmitFrame2(std::span<const VkCommandBuffer> commandBuffers,
+                                         std::span<const FrameSemaphore> waits,
+                                         std::span<const FrameSemaphore> signals, VkFence fence)
+{
+    // Synchronization2 carries timeline values and stages per semaphore, so no pNext chain is needed.
+    // The legacy stage bits used here have the same values as their VK_PIPELINE_STAGE_2 counterparts.
+    std::array<VkCommandBufferSubmitInfo, s_MaxFrameCommandBuffers> commandBufferInfos{};
+    std::array<VkSemaphoreSubmitInfo, s_MaxFrameWaits> waitInfos{};
+    std::array<VkSemaphoreSubmitInfo, s_MaxFrameSignals> signalInfos{};
+
+    for (size_t i = 0; i < commandBuffers.size(); i++)
+    {
+        commandBufferInfos[i].sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+        commandBufferInfos[i].commandBuffer = commandBuffers[i];
+    }
+
+    for (size_t i = 0; i < waits.size(); i++)
+    {
+        waitInfos[i].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        waitInfos[i].semaphore = waits[i].semaphore;
+        waitInfos[i].value = waits[i].value;
+        waitInfos[i].stageMask = static_cast<VkPipelineStageFlags2>(waits[i].stages);
+    }
+
+    for (size_t i = 0; i < signals.size(); i++)
+    {
+        signalInfos[i].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        signalInfos[i].semaphore = signals[i].semaphore;
+        signalInfos[i].value = signals[i].value;
+        signalInfos[i].stageMask = static_cast<VkPipelineStageFlags2>(signals[i].stages);
+    }
+
+    VkSubmitInfo2 submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+    submitInfo.waitSemaphoreInfoCount = static_cast<uint32_t>(waits.size());
+    submitInfo.pWaitSemaphoreInfos = waitInfos.data();
+    submitInfo.commandBufferInfoCount = static_cast<uint32_t>(commandBuffers.size());
+    submitInfo.pCommandBufferInfos = commandBufferInfos.data();
+    submitInfo.signalSemaphoreInfoCount = static_cast<uint32_t>(signals.size());
+    submitInfo.pSignalSemaphoreInfos = signalInfos.data();
+
+    return VulkanManager::Get().SubmitToQueue2(VulkanQueueType::GRAPHICS, submitInfo, fence);
+}
+
 VkCommandBuffer ae::VulkanContext::RecordImGuiOverlay()
 {
-    VkCommandBuffer cmd = m_ImGuiCommandBuffers[m_CurrentImageIndex];
+    VkCommandBuffer cmd = m_ImGuiCommandBuffers[m_CurrentFrame];
     vkResetCommandBuffer(cmd, 0);
 
     VkCommandBufferBeginInfo beginInfo{};
@@ -156,7 +563,7 @@ VkCommandBuffer ae::VulkanContext::RecordImGuiOverlay()
 
 VkCommandBuffer ae::VulkanContext::RecordImGuiStandalone()
 {
-    VkCommandBuffer cmd = m_ImGuiCommandBuffers[m_CurrentImageIndex];
+    VkCommandBuffer cmd = m_ImGuiCommandBuffers[m_CurrentFrame];
     vkResetCommandBuffer(cmd, 0);
 
     VkCommandBufferBeginInfo beginInfo{};
@@ -186,9 +593,9 @@ VkCommandBuffer ae::VulkanContext::RecordImGuiStandalone()
     return cmd;
 }
 
-VkCommandBuffer ae::VulkanContext::RecordTransitionToPresent()
+VkCommandBuffer ae::VulkanContext::RecordImGuiDynamic(bool overlay)
 {
-    VkCommandBuffer cmd = m_TransitionCommandBuffers[m_CurrentImageIndex];
+    VkCommandBuffer cmd = m_ImGuiCommandBuffers[m_CurrentFrame];
     vkResetCommandBuffer(cmd, 0);
 
     VkCommandBufferBeginInfo beginInfo{};
@@ -196,53 +603,325 @@ VkCommandBuffer ae::VulkanContext::RecordTransitionToPresent()
     beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
     VK_CHECK(vkBeginCommandBuffer(cmd, &beginInfo));
 
+    // The overlay loads what the app left in COLOR_ATTACHMENT_OPTIMAL, the same contract as the overlay render
+    // pass; standalone discards the previous contents and clears
+    if (overlay)
+    {
+        RecordSwapChainBarrier(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                               VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                               VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                               VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+    }
+    else
+    {
+        RecordSwapChainBarrier(cmd, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                               VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0,
+                               VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+    }
+
+    const auto &clearColorData = m_Window.GetClearColor();
+
+    VkRenderingAttachmentInfo colorAttachment{};
+    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    colorAttachment.imageView = m_SwapChainImageViews[m_CurrentImageIndex];
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = overlay ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.clearValue = { { { clearColorData[0], clearColorData[1], clearColorData[2], clearColorData[3] } } };
+
+    VkRenderingInfo renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+    renderingInfo.renderArea.offset = { .x = 0, .y = 0 };
+    renderingInfo.renderArea.extent = m_SwapChainExtent;
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachments = &colorAttachment;
+
+    VulkanManager::Get().CmdBeginRendering(cmd, renderingInfo);
+
+    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cmd);
+
+    VulkanManager::Get().CmdEndRendering(cmd);
+
+    RecordSwapChainBarrier(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, GetFrameEndLayout(),
+                           VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                           VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0);
+
+    VK_CHECK(vkEndCommandBuffer(cmd));
+
+    return cmd;
+}
+
+VkCommandBuffer ae::VulkanContext::RecordTransitionToPresent(VkImageLayout oldLayout)
+{
+    VkCommandBuffer cmd = m_TransitionCommandBuffers[m_CurrentFrame];
+    vkResetCommandBuffer(cmd, 0);
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    VK_CHECK(vkBeginCommandBuffer(cmd, &beginInfo));
+
+    RecordSwapChainBarrier(cmd, oldLayout, GetFrameEndLayout(), VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                           VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0);
+
+    VK_CHECK(vkEndCommandBuffer(cmd));
+
+    return cmd;
+}
+
+VkCommandBuffer ae::VulkanContext::RecordCapture()
+{
+    CaptureSlot &slot = m_CaptureSlots[m_CurrentFrame];
+
+    if (!m_CaptureSupported)
+    {
+        m_pFrameCapture->TakeRequests(slot.requests);
+        slot.requests.clear();
+
+        AE_LOG(AE_WARNING, "Frame capture is not supported by the swapchain of '{}', dropping the request",
+               m_Window.GetDesc().title);
+        return VK_NULL_HANDLE;
+    }
+
+    // BeginFrame handed this slot's previous capture over, but the copy thread may still be reading it
+    FrameCapture::WaitUntilReleased(slot.busy);
+
+    if (slot.extent.width != m_SwapChainExtent.width || slot.extent.height != m_SwapChainExtent.height)
+    {
+        DestroyCaptureBuffer(slot);
+
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = static_cast<VkDeviceSize>(m_SwapChainExtent.width) * m_SwapChainExtent.height * 4;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VmaAllocationCreateInfo allocationInfo{};
+        allocationInfo.usage = VMA_MEMORY_USAGE_AUTO;
+        allocationInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        VmaAllocationInfo info;
+
+        if (VulkanCreateBuffer(VulkanManager::Get().GetAllocator(), bufferInfo, allocationInfo,
+                               VulkanMemoryCategory::STAGING, &slot.buffer, &slot.allocation, &info) != VK_SUCCESS)
+        {
+            AE_THROW_RUNTIME_ERROR("Failed to create Vulkan frame capture buffer");
+        }
+
+        slot.pMapped = static_cast<uint8_t *>(info.pMappedData);
+        slot.extent = m_SwapChainExtent;
+    }
+
+    if (!m_pFrameCapture->TakeRequests(slot.requests))
+    {
+        return VK_NULL_HANDLE;
+    }
+
+    slot.swapRedBlue =
+        m_SwapChainImageFormat == VK_FORMAT_B8G8R8A8_UNORM || m_SwapChainImageFormat == VK_FORMAT_B8G8R8A8_SRGB;
+    slot.frameNumber = m_FrameNumber;
+    slot.pending = true;
+
+    VkCommandBuffer cmd = m_CaptureCommandBuffers[m_CurrentFrame];
+    vkResetCommandBuffer(cmd, 0);
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    VK_CHECK(vkBeginCommandBuffer(cmd, &beginInfo));
+
+    // Every path through EndFrame ends with a barrier into BOTTOM_OF_PIPE that ALL_COMMANDS chains onto
+    RecordSwapChainBarrier(cmd, GetFrameEndLayout(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                           VK_ACCESS_TRANSFER_READ_BIT);
+
+    VkBufferImageCopy region{};
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = { .width = slot.extent.width, .height = slot.extent.height, .depth = 1 };
+
+    vkCmdCopyImageToBuffer(cmd, m_SwapChainImages[m_CurrentImageIndex], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           slot.buffer, 1, &region);
+
+    // The fence does not make the copy visible to the host by itself
+    VkMemoryBarrier hostBarrier{};
+    hostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &hostBarrier, 0,
+                         nullptr, 0, nullptr);
+
+    if (!m_Headless)
+    {
+        RecordSwapChainBarrier(cmd, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                               VK_PIPELINE_STAGE_TRANSFER_BIT, 0, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0);
+    }
+
+    VK_CHECK(vkEndCommandBuffer(cmd));
+
+    return cmd;
+}
+
+void ae::VulkanContext::FlushCaptures()
+{
+    // Oldest frame first, so captures reach the worker in the order they were rendered
+    for (uint32_t i = 1; i <= m_FramesInFlight; i++)
+    {
+        CaptureSlot &slot = m_CaptureSlots[(m_CurrentFrame + i) % m_FramesInFlight];
+
+        if (slot.pending)
+        {
+            WaitForFrame(slot.frameNumber);
+            HandOverCapture(slot);
+        }
+    }
+}
+
+void ae::VulkanContext::HandOverCapture(CaptureSlot &slot)
+{
+    // Readback memory may be cached but not coherent
+    vmaInvalidateAllocation(VulkanManager::Get().GetAllocator(), slot.allocation, 0, VK_WHOLE_SIZE);
+
+    slot.pending = false;
+    slot.busy.store(true, std::memory_order_relaxed);
+
+    m_pFrameCapture->Submit({ .pPixels = slot.pMapped,
+                              .width = slot.extent.width,
+                              .height = slot.extent.height,
+                              .frameNumber = slot.frameNumber,
+                              .flipRows = false,
+                              .swapRedBlue = slot.swapRedBlue,
+                              .pBusy = &slot.busy },
+                            slot.requests);
+}
+
+void ae::VulkanContext::DestroyCaptureBuffer(CaptureSlot &slot)
+{
+    if (slot.buffer == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    FrameCapture::WaitUntilReleased(slot.busy);
+
+    VulkanDestroyBuffer(VulkanManager::Get().GetAllocator(), slot.buffer, slot.allocation);
+
+    slot.buffer = VK_NULL_HANDLE;
+    slot.allocation = VK_NULL_HANDLE;
+    slot.pMapped = nullptr;
+    slot.extent = {};
+}
+
+void ae::VulkanContext::RecordSwapChainBarrier(VkCommandBuffer cmd, VkImageLayout oldLayout, VkImageLayout newLayout,
+                                               VkPipelineStageFlags srcStages, VkAccessFlags srcAccess,
+                                               VkPipelineStageFlags dstStages, VkAccessFlags dstAccess)
+{
+    VkImageSubresourceRange range{};
+    range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    range.baseMipLevel = 0;
+    range.levelCount = 1;
+    range.baseArrayLayer = 0;
+    range.layerCount = 1;
+
+    // The legacy stage and access bits used here have the same values as their synchronization2 counterparts
+    if (VulkanManager::Get().IsSynchronization2Enabled())
+    {
+        VkImageMemoryBarrier2 barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+        barrier.srcStageMask = static_cast<VkPipelineStageFlags2>(srcStages);
+        barrier.srcAccessMask = static_cast<VkAccessFlags2>(srcAccess);
+        barrier.dstStageMask = static_cast<VkPipelineStageFlags2>(dstStages);
+        barrier.dstAccessMask = static_cast<VkAccessFlags2>(dstAccess);
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = m_SwapChainImages[m_CurrentImageIndex];
+        barrier.subresourceRange = range;
+
+        VkDependencyInfo dependencyInfo{};
+        dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependencyInfo.imageMemoryBarrierCount = 1;
+        dependencyInfo.pImageMemoryBarriers = &barrier;
+
+        VulkanManager::Get().CmdPipelineBarrier2(cmd, dependencyInfo);
+        return;
+    }
+
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-    barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
     barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.image = m_SwapChainImages[m_CurrentImageIndex];
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-    barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-    barrier.dstAccessMask = 0;
-
-    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0,
-                         nullptr, 0, nullptr, 1, &barrier);
-
-    VK_CHECK(vkEndCommandBuffer(cmd));
+    barrier.subresourceRange = range;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
 
-    return cmd;
+    vkCmdPipelineBarrier(cmd, srcStages, dstStages, 0, 0, nullptr, 0, nullptr, 1, &barrier);
 }
 
 bool ae::VulkanContext::CreateImpl()
 {
     m_FramesInFlight = m_Window.GetDesc().framesInFlight;
+    m_Headless = m_Window.GetDesc().type == WindowType::HEADLESS;
 
     VulkanManager::Get().AddContext(m_Window.GetDesc().title);
     VulkanManager::Get().RequestDeviceFeatures(m_Window.GetDesc().features);
 
+    m_LatencyTimer.Start();
+
     CreateSurface();
 
+    m_DeletionSource = VulkanManager::Get().GetDeletionQueue().AddSource();
+
     m_GraphicsAPI = "Vulkan";
     m_GraphicsVersion = VulkanManager::Get().GetVersion();
     m_GraphicsCard = VulkanManager::Get().GetRenderer();
     m_GraphicsVendor = VulkanManager::Get().GetVendor();
 
-    CreateSwapChain();
+    // The device exists once the surface has been added
+    m_DynamicRendering = VulkanManager::Get().IsDynamicRenderingEnabled();
+
+    if (m_Headless)
+    {
+        CreateOffscreenTargets();
+    }
+    else
+    {
+        CreateSwapChain();
+    }
+
     CreateSwapChainImageViews();
-    CreateImGuiStandaloneRenderPass();
-    CreateImGuiOverlayRenderPass();
-    CreateImGuiStandaloneFramebuffers();
-    CreateImGuiOverlayFramebuffers();
+
+    // Headless windows have no ImGui interface, so they need none of its render targets
+    if (!m_DynamicRendering && !m_Headless)
+    {
+        CreateImGuiStandaloneRenderPass();
+        CreateImGuiOverlayRenderPass();
+        CreateImGuiStandaloneFramebuffers();
+        CreateImGuiOverlayFramebuffers();
+    }
+
     CreateCommandPool();
     CreateCommandBuffers();
+
+    m_CaptureSlots = std::vector<CaptureSlot>(m_FramesInFlight);
+
+    m_pCommandAllocator = std::make_unique<VulkanCommandAllocator>(
+        m_FramesInFlight, VulkanManager::Get().GetGraphicsQueueFamilyIndex());
+
+    CreateTimelineSemaphores();
     CreateSyncObjects();
 
+    if (!m_Headless)
+    {
+        CreatePresentSemaphores();
+    }
+
     return true;
 }
 
@@ -258,8 +937,8 @@ void ae::VulkanContext::DeactivateImpl()
 
 void ae::VulkanContext::DestroyImpl()
 {
-    // Wait for all GPU work to complete
-    vkDeviceWaitIdle(VulkanManager::Get().GetDevice());
+    // Only this context's frames use its objects, so other windows and the upload queue keep running
+    WaitForSubmittedFrames();
 
     // Wait for all in-flight fences to ensure no pending operations
     if (!m_InFlightFences.empty())
@@ -268,7 +947,25 @@ void ae::VulkanContext::DestroyImpl()
                         m_InFlightFences.data(), VK_TRUE, UINT64_MAX);
     }
 
+    ReleaseRetiredSwapChains(true);
+
+    // Removed before the surface, whose removal may take the device and the queue with it
+    VulkanManager::Get().GetDeletionQueue().RemoveSource(m_DeletionSource);
+    m_DeletionSource = 0;
+
+    DestroyPresentSemaphores();
     DestroySyncObjects();
+    DestroyTimelineSemaphores();
+    m_pCommandAllocator.reset();
+
+    // Pending captures are dropped; Window flushes them before destroying the context
+    for (CaptureSlot &slot : m_CaptureSlots)
+    {
+        DestroyCaptureBuffer(slot);
+    }
+
+    m_CaptureSlots.clear();
+
     DestroyCommandBuffers();
     DestroyCommandPool();
     DestroyImGuiOverlayFramebuffers();
@@ -276,7 +973,15 @@ void ae::VulkanContext::DestroyImpl()
     DestroyImGuiOverlayRenderPass();
     DestroyImGuiStandaloneRenderPass();
     DestroySwapChainImageViews();
-    DestroySwapChain();
+
+    if (m_Headless)
+    {
+        DestroyOffscreenTargets();
+    }
+    else
+    {
+        DestroySwapChain();
+    }
 
     DestroySurface();
 
@@ -285,6 +990,13 @@ void ae::VulkanContext::DestroyImpl()
 
 void ae::VulkanContext::CreateSurface()
 {
+    // Surfaceless: the context only needs the device, which a headless target creates without any surface
+    if (m_Headless)
+    {
+        ae::VulkanManager::Get().AddHeadlessTarget();
+        return;
+    }
+
     VkInstance instance = VulkanManager::Get().GetInstance();
 
     if (glfwCreateWindowSurface(instance, m_Window.GetWindow(), nullptr, &m_Surface) != VK_SUCCESS)
@@ -297,6 +1009,12 @@ void ae::VulkanContext::CreateSurface()
 
 void ae::VulkanContext::DestroySurface()
 {
+    if (m_Headless)
+    {
+        ae::VulkanManager::Get().RemoveHeadlessTarget();
+        return;
+    }
+
     ae::VulkanManager::Get().RemoveSurface(m_Surface);
 
     vkDestroySurfaceKHR(VulkanManager::Get().GetInstance(), m_Surface, nullptr);
@@ -313,7 +1031,14 @@ void ae::VulkanContext::CreateSwapChain()
     vkGetPhysicalDeviceSurfaceCapabilitiesKHR(ae::VulkanManager::Get().GetPhysicalDevice(), m_Surface,
                                               &surfaceCapabilities);
 
-    uint32_t imageCount = surfaceCapabilities.minImageCount + 1;
+    uint32_t imageCount = m_Window.GetDesc().swapchainImageCount;
+
+    if (imageCount == 0)
+    {
+        imageCount = surfaceCapabilities.minImageCount + 1;
+    }
+
+    imageCount = std::max(imageCount, surfaceCapabilities.minImageCount);
 
     if (surfaceCapabilities.maxImageCount > 0 && imageCount > surfaceCapabilities.maxImageCount)
     {
@@ -354,17 +1079,34 @@ void ae::VulkanContext::CreateSwapChain()
     vkGetPhysicalDeviceSurfacePresentModesKHR(ae::VulkanManager::Get().GetPhysicalDevice(), m_Surface,
                                               &presentModeCount, presentModes.data());
 
+    std::vector<PresentMode> preferredModes = m_Window.GetDesc().presentModes;
+
+    if (preferredModes.empty())
+    {
+        preferredModes = { PresentMode::MAILBOX, PresentMode::FIFO };
+    }
+
     VkPresentModeKHR chosenPresentMode = VK_PRESENT_MODE_FIFO_KHR; // guaranteed
 
-    for (const auto &mode : presentModes)
+    for (PresentMode preferred : preferredModes)
     {
-        if (mode == VK_PRESENT_MODE_MAILBOX_KHR)
+        VkPresentModeKHR mode = ToVkPresentMode(preferred);
+
+        if (std::ranges::find(presentModes, mode) != presentModes.end())
         {
-            chosenPresentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+            chosenPresentMode = mode;
             break;
         }
     }
 
+    if (chosenPresentMode != m_PresentMode || m_SwapChain == VK_NULL_HANDLE)
+    {
+        AE_LOG(AE_TRACE, "Vulkan present mode for '{}': {}", m_Window.GetDesc().title,
+               static_cast<uint32_t>(chosenPresentMode));
+    }
+
+    m_PresentMode = chosenPresentMode;
+
     if (surfaceCapabilities.currentExtent.width != std::numeric_limits<uint32_t>::max())
     {
         m_SwapChainExtent = surfaceCapabilities.currentExtent;
@@ -372,9 +1114,9 @@ void ae::VulkanContext::CreateSwapChain()
 
     else
     {
-        int width;
-        int height;
-        glfwGetFramebufferSize(m_Window.GetWindow(), &width, &height);
+        glm::ivec2 framebufferSize = m_Window.GetFramebufferSize();
+        int width = framebufferSize.x;
+        int height = framebufferSize.y;
 
         m_SwapChainExtent.width = std::clamp(static_cast<uint32_t>(width), surfaceCapabilities.minImageExtent.width,
                                              surfaceCapabilities.maxImageExtent.width);
@@ -383,6 +1125,16 @@ void ae::VulkanContext::CreateSwapChain()
                                               surfaceCapabilities.maxImageExtent.height);
     }
 
+    // Frame capture copies out of the swapchain images, which not every surface allows
+    VkImageUsageFlags imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    m_CaptureSupported = (surfaceCapabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) &&
+                         IsCapturableFormat(m_SwapChainImageFormat);
+
+    if (m_CaptureSupported)
+    {
+        imageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    }
+
     VkSwapchainCreateInfoKHR createInfo{
         .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
         .pNext = nullptr,
@@ -393,7 +1145,7 @@ void ae::VulkanContext::CreateSwapChain()
         .imageColorSpace = chosenFormat.colorSpace,
         .imageExtent = m_SwapChainExtent,
         .imageArrayLayers = 1,
-        .imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+        .imageUsage = imageUsage,
         .imageSharingMode = VK_SHARING_MODE_EXCLUSIVE,
         .queueFamilyIndexCount = 0,
         .pQueueFamilyIndices = nullptr,
@@ -401,7 +1153,7 @@ void ae::VulkanContext::CreateSwapChain()
         .compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
         .presentMode = chosenPresentMode,
         .clipped = VK_TRUE,
-        .oldSwapchain = VK_NULL_HANDLE,
+        .oldSwapchain = m_SwapChain, // Null on first creation, the retiring swapchain when recreating
     };
 
     if (vkCreateSwapchainKHR(VulkanManager::Get().GetDevice(), &createInfo, nullptr, &m_SwapChain) != VK_SUCCESS)
@@ -414,6 +1166,8 @@ void ae::VulkanContext::CreateSwapChain()
 
     m_SwapChainImages.resize(swapImageCount);
     vkGetSwapchainImagesKHR(VulkanManager::Get().GetDevice(), m_SwapChain, &swapImageCount, m_SwapChainImages.data());
+
+    m_FirstSwapChainPresentId = m_FrameNumber;
 }
 
 void ae::VulkanContext::DestroySwapChain()
@@ -423,6 +1177,56 @@ void ae::VulkanContext::DestroySwapChain()
     m_SwapChainImages.clear();
 }
 
+void ae::VulkanContext::CreateOffscreenTargets()
+{
+    m_SwapChainImageFormat = s_OffscreenFormat;
+    m_CaptureSupported = true;
+    m_SwapChainExtent = { .width = m_Window.GetDesc().width, .height = m_Window.GetDesc().height };
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = m_SwapChainImageFormat;
+    imageInfo.extent = { .width = m_SwapChainExtent.width, .height = m_SwapChainExtent.height, .depth = 1 };
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                      VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    VmaAllocationCreateInfo allocationInfo{};
+    allocationInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    allocationInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+
+    // One target per frame slot, so a slot's image is never written while the GPU may still read it
+    m_SwapChainImages.resize(m_FramesInFlight);
+    m_OffscreenAllocations.resize(m_FramesInFlight);
+
+    for (uint32_t i = 0; i < m_FramesInFlight; i++)
+    {
+        if (VulkanCreateImage(VulkanManager::Get().GetAllocator(), imageInfo, allocationInfo,
+                              VulkanMemoryCategory::IMAGE, &m_SwapChainImages[i],
+                              &m_OffscreenAllocations[i]) != VK_SUCCESS)
+        {
+            AE_THROW_RUNTIME_ERROR("Failed to create offscreen render target for headless Vulkan context");
+        }
+    }
+}
+
+void ae::VulkanContext::DestroyOffscreenTargets()
+{
+    for (size_t i = 0; i < m_SwapChainImages.size(); i++)
+    {
+        VulkanDestroyImage(VulkanManager::Get().GetAllocator(), m_SwapChainImages[i], m_OffscreenAllocations[i]);
+    }
+
+    m_SwapChainImages.clear();
+    m_OffscreenAllocations.clear();
+}
+
 void ae::VulkanContext::CreateSwapChainImageViews()
 {
     m_SwapChainImageViews.resize(m_SwapChainImages.size());
@@ -657,15 +1461,16 @@ void ae::VulkanContext::DestroyCommandPool()
 
 void ae::VulkanContext::CreateCommandBuffers()
 {
-    size_t imageCount = m_SwapChainImages.size();
+    // Command buffers are indexed by frame slot rather than swapchain image, so they are only reused once the
+    // slot's previous frame has completed and survive swapchain recreation regardless of the image count
 
-    // ImGui command buffers (one per swapchain image)
-    m_ImGuiCommandBuffers.resize(imageCount);
+    // ImGui command buffers (one per frame in flight)
+    m_ImGuiCommandBuffers.resize(m_FramesInFlight);
     VkCommandBufferAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     allocInfo.commandPool = m_CommandPool;
     allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = static_cast<uint32_t>(imageCount);
+    allocInfo.commandBufferCount = m_FramesInFlight;
 
     if (vkAllocateCommandBuffers(VulkanManager::Get().GetDevice(), &allocInfo, m_ImGuiCommandBuffers.data()) !=
         VK_SUCCESS)
@@ -673,15 +1478,24 @@ void ae::VulkanContext::CreateCommandBuffers()
         AE_THROW_RUNTIME_ERROR("Failed to allocate ImGui command buffers");
     }
 
-    // Transition command buffers (one per swapchain image)
-    m_TransitionCommandBuffers.resize(imageCount);
-    allocInfo.commandBufferCount = static_cast<uint32_t>(imageCount);
+    // Transition command buffers (one per frame in flight)
+    m_TransitionCommandBuffers.resize(m_FramesInFlight);
+    allocInfo.commandBufferCount = m_FramesInFlight;
 
     if (vkAllocateCommandBuffers(VulkanManager::Get().GetDevice(), &allocInfo, m_TransitionCommandBuffers.data()) !=
         VK_SUCCESS)
     {
         AE_THROW_RUNTIME_ERROR("Failed to allocate transition command buffers");
     }
+
+    // Frame capture command buffers (one per frame in flight)
+    m_CaptureCommandBuffers.resize(m_FramesInFlight);
+
+    if (vkAllocateCommandBuffers(VulkanManager::Get().GetDevice(), &allocInfo, m_CaptureCommandBuffers.data()) !=
+        VK_SUCCESS)
+    {
+        AE_THROW_RUNTIME_ERROR("Failed to allocate frame capture command buffers");
+    }
 }
 
 void ae::VulkanContext::DestroyCommandBuffers()
@@ -700,15 +1514,21 @@ void ae::VulkanContext::DestroyCommandBuffers()
                              m_TransitionCommandBuffers.data());
         m_TransitionCommandBuffers.clear();
     }
+
+    if (!m_CaptureCommandBuffers.empty())
+    {
+        vkFreeCommandBuffers(VulkanManager::Get().GetDevice(), m_CommandPool,
+                             static_cast<uint32_t>(m_CaptureCommandBuffers.size()), m_CaptureCommandBuffers.data());
+        m_CaptureCommandBuffers.clear();
+    }
 }
 
 void ae::VulkanContext::CreateSyncObjects()
 {
-    uint32_t imageCount = static_cast<uint32_t>(m_SwapChainImages.size());
-
     m_ImageAvailableSemaphores.resize(m_FramesInFlight);
-    m_RenderFinishedSemaphores.resize(imageCount);
-    m_InFlightFences.resize(m_FramesInFlight);
+
+    // Frame completion is tracked by the frame timeline when available, so the fences are only needed without it
+    m_InFlightFences.resize(IsFrameTimelineEnabled() ? 0 : m_FramesInFlight);
 
     VkSemaphoreCreateInfo semaphoreInfo{};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -720,21 +1540,20 @@ void ae::VulkanContext::CreateSyncObjects()
     for (uint32_t i = 0; i < m_FramesInFlight; i++)
     {
         if (vkCreateSemaphore(VulkanManager::Get().GetDevice(), &semaphoreInfo, nullptr,
-                              &m_ImageAvailableSemaphores[i]) != VK_SUCCESS ||
-            vkCreateFence(VulkanManager::Get().GetDevice(), &fenceInfo, nullptr, &m_InFlightFences[i]) != VK_SUCCESS)
+                              &m_ImageAvailableSemaphores[i]) != VK_SUCCESS)
         {
             AE_THROW_RUNTIME_ERROR("Failed to create synchronization objects for Vulkan context");
         }
     }
 
-    for (uint32_t i = 0; i < imageCount; i++)
+    for (auto &m_InFlightFence : m_InFlightFences)
     {
-        if (vkCreateSemaphore(VulkanManager::Get().GetDevice(), &semaphoreInfo, nullptr,
-                              &m_RenderFinishedSemaphores[i]) != VK_SUCCESS)
+        if (vkCreateFence(VulkanManager::Get().GetDevice(), &fenceInfo, nullptr, &m_InFlightFence) != VK_SUCCESS)
         {
             AE_THROW_RUNTIME_ERROR("Failed to create synchronization objects for Vulkan context");
         }
     }
+
 }
 
 void ae::VulkanContext::DestroySyncObjects()
@@ -744,44 +1563,122 @@ void ae::VulkanContext::DestroySyncObjects()
         vkDestroySemaphore(VulkanManager::Get().GetDevice(), m_ImageAvailableSemaphore, nullptr);
     }
 
+    for (auto &m_InFlightFence : m_InFlightFences)
+    {
+        vkDestroyFence(VulkanManager::Get().GetDevice(), m_InFlightFence, nullptr);
+    }
+
+    m_ImageAvailableSemaphores.clear();
+    m_InFlightFences.clear();
+}
+
+void ae::VulkanContext::CreatePresentSemaphores()
+{
+    // Signaled by the frame submit and waited on by present, so there is one per swapchain image
+    m_RenderFinishedSemaphores.resize(m_SwapChainImages.size());
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
     for (auto &m_RenderFinishedSemaphore : m_RenderFinishedSemaphores)
     {
-        vkDestroySemaphore(VulkanManager::Get().GetDevice(), m_RenderFinishedSemaphore, nullptr);
+        if (vkCreateSemaphore(VulkanManager::Get().GetDevice(), &semaphoreInfo, nullptr, &m_RenderFinishedSemaphore) !=
+            VK_SUCCESS)
+        {
+            AE_THROW_RUNTIME_ERROR("Failed to create synchronization objects for Vulkan context");
+        }
     }
+}
 
-    for (auto &m_InFlightFence : m_InFlightFences)
+void ae::VulkanContext::DestroyPresentSemaphores()
+{
+    for (auto &m_RenderFinishedSemaphore : m_RenderFinishedSemaphores)
     {
-        vkDestroyFence(VulkanManager::Get().GetDevice(), m_InFlightFence, nullptr);
+        vkDestroySemaphore(VulkanManager::Get().GetDevice(), m_RenderFinishedSemaphore, nullptr);
     }
 
-    m_ImageAvailableSemaphores.clear();
     m_RenderFinishedSemaphores.clear();
-    m_InFlightFences.clear();
+}
+
+void ae::VulkanContext::CreateTimelineSemaphores()
+{
+    m_FrameSlotValues.assign(m_FramesInFlight, 0);
+
+    if (!m_Window.GetDesc().features.Has(DeviceFeature::TimelineSemaphore) ||
+        !VulkanManager::Get().IsTimelineSemaphoreEnabled())
+    {
+        return;
+    }
+
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+
+    if (vkCreateSemaphore(VulkanManager::Get().GetDevice(), &semaphoreInfo, nullptr, &m_FrameTimeline) != VK_SUCCESS ||
+        vkCreateSemaphore(VulkanManager::Get().GetDevice(), &semaphoreInfo, nullptr, &m_HostTimeline) != VK_SUCCESS)
+    {
+        AE_THROW_RUNTIME_ERROR("Failed to create timeline semaphores for Vulkan context");
+    }
+}
+
+void ae::VulkanContext::DestroyTimelineSemaphores()
+{
+    vkDestroySemaphore(VulkanManager::Get().GetDevice(), m_FrameTimeline, nullptr);
+    vkDestroySemaphore(VulkanManager::Get().GetDevice(), m_HostTimeline, nullptr);
+
+    m_FrameTimeline = VK_NULL_HANDLE;
+    m_HostTimeline = VK_NULL_HANDLE;
+    m_HostDependencyValue = 0;
+    m_FrameSlotValues.clear();
 }
 
 void ae::VulkanContext::RecreateSwapChain()
 {
-    vkDeviceWaitIdle(VulkanManager::Get().GetDevice());
+    // No device-wide idle: the old swapchain is handed to the new one and everything tied to its images is
+    // retired until its last presents are done with it (see ReleaseRetiredSwapChains). Render passes, command
+    // buffers and per-frame semaphores do not depend on the extent and are kept.
+    VkFormat oldFormat = m_SwapChainImageFormat;
+
+    RetiredSwapChain retired{};
+    retired.frameNumber = m_FrameNumber;
+    retired.swapChain = m_SwapChain;
+    retired.imageViews = std::move(m_SwapChainImageViews);
+    retired.framebuffers = std::move(m_ImGuiStandaloneFramebuffers);
+    retired.framebuffers.insert(retired.framebuffers.end(), m_ImGuiOverlayFramebuffers.begin(),
+                                m_ImGuiOverlayFramebuffers.end());
+    retired.semaphores = std::move(m_RenderFinishedSemaphores);
 
-    DestroySyncObjects();
-    DestroyCommandBuffers();
-    DestroyImGuiOverlayFramebuffers();
-    DestroyImGuiStandaloneFramebuffers();
-    DestroyImGuiOverlayRenderPass();
-    DestroyImGuiStandaloneRenderPass();
-    DestroySwapChainImageViews();
-    DestroySwapChain();
+    m_SwapChainImageViews.clear();
+    m_ImGuiStandaloneFramebuffers.clear();
+    m_ImGuiOverlayFramebuffers.clear();
+    m_RenderFinishedSemaphores.clear();
 
     CreateSwapChain();
     CreateSwapChainImageViews();
-    CreateImGuiStandaloneRenderPass();
-    CreateImGuiOverlayRenderPass();
-    CreateImGuiStandaloneFramebuffers();
-    CreateImGuiOverlayFramebuffers();
-    CreateCommandBuffers();
-    CreateSyncObjects();
 
-    m_CurrentFrame = 0;
+    // Dynamic rendering has no render passes or framebuffers to rebuild
+    if (!m_DynamicRendering)
+    {
+        if (m_SwapChainImageFormat != oldFormat)
+        {
+            retired.renderPasses = { m_ImGuiStandaloneRenderPass, m_ImGuiOverlayRenderPass };
+
+            CreateImGuiStandaloneRenderPass();
+            CreateImGuiOverlayRenderPass();
+        }
+
+        CreateImGuiStandaloneFramebuffers();
+        CreateImGuiOverlayFramebuffers();
+    }
+
+    CreatePresentSemaphores();
+
+    m_RetiredSwapChains.push_back(std::move(retired));
 
     if (m_OnSwapchainRecreated)
     {
@@ -789,9 +1686,81 @@ void ae::VulkanContext::RecreateSwapChain()
     }
 }
 
+void ae::VulkanContext::ReleaseRetiredSwapChains(bool all)
+{
+    if (m_RetiredSwapChains.empty())
+    {
+        return;
+    }
+
+    VkDevice device = VulkanManager::Get().GetDevice();
+
+    // The frame fence only covers the GPU work. A present's wait on its render-finished semaphore is not
+    // fenced without VK_EXT_swapchain_maintenance1, so a retired swapchain's last presents may still hold
+    // its semaphores after the first frame into the new swapchain completes.
+    //
+    // With present wait, the retired objects go once the first present to the current swapchain has been
+    // displayed. Presents on one queue are processed in order, so every earlier present, to whichever
+    // swapchain, has consumed its semaphore by then. Without it they are kept one frames-in-flight cycle
+    // longer. By then the presentation engine has released images for that many later presents, which
+    // drivers only do after the earlier presents' semaphore waits.
+    bool presentWait = VulkanManager::Get().IsPresentWaitEnabled();
+    bool presented = false;
+
+    if (!all && presentWait && m_SwapChain != VK_NULL_HANDLE)
+    {
+        VkResult result = VulkanManager::Get().WaitForPresent(m_SwapChain, m_FirstSwapChainPresentId, 0);
+        presented = result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR;
+    }
+
+    auto released = [this, all, presentWait, presented](const RetiredSwapChain &retired)
+    {
+        if (all)
+        {
+            return true;
+        }
+
+        return presentWait ? presented && IsFrameComplete(retired.frameNumber)
+                           : IsFrameComplete(retired.frameNumber + m_FramesInFlight);
+    };
+
+    for (const RetiredSwapChain &retired : m_RetiredSwapChains)
+    {
+        if (!released(retired))
+        {
+            continue;
+        }
+
+        for (VkFramebuffer framebuffer : retired.framebuffers)
+        {
+            vkDestroyFramebuffer(device, framebuffer, nullptr);
+        }
+
+        for (VkRenderPass renderPass : retired.renderPasses)
+        {
+            vkDestroyRenderPass(device, renderPass, nullptr);
+        }
+
+        for (VkImageView imageView : retired.imageViews)
+        {
+            vkDestroyImageView(device, imageView, nullptr);
+        }
+
+        for (VkSemaphore semaphore : retired.semaphores)
+        {
+            vkDestroySemaphore(device, semaphore, nullptr);
+        }
+
+        vkDestroySwapchainKHR(device, retired.swapChain, nullptr);
+    }
+
+    std::erase_if(m_RetiredSwapChains, released);
+}
+
 void ae::VulkanContext::OnResize(uint32_t width, uint32_t height)
 {
-    if (width == 0 || height == 0)
+    // Offscreen targets keep the size the window was created with
+    if (width == 0 || height == 0 || m_Headless)
     {
         return;
     }
@@ -804,6 +1773,21 @@ void ae::VulkanContext::SetOnSwapchainRecreatedCB(const std::function<void(const
     m_OnSwapchainRecreated = cb;
 }
 
+ae::PresentMode ae::VulkanContext::GetPresentMode() const
+{
+    switch (m_PresentMode)
+    {
+    case VK_PRESENT_MODE_IMMEDIATE_KHR:
+        return PresentMode::IMMEDIATE;
+    case VK_PRESENT_MODE_MAILBOX_KHR:
+        return PresentMode::MAILBOX;
+    case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+        return PresentMode::FIFO_RELAXED;
+    default:
+        return PresentMode::FIFO;
+    }
+}
+
 ae::VulkanResources ae::VulkanContext::GetVulkanResources() const
 {
     VulkanResources resources{};
@@ -812,6 +1796,14 @@ ae::VulkanResources ae::VulkanContext::GetVulkanResources() const
     resources.device = ae::VulkanManager::Get().GetDevice();
     resources.graphicsQueue = ae::VulkanManager::Get().GetGraphicsQueue();
     resources.graphicsQueueFamilyIndex = ae::VulkanManager::Get().GetGraphicsQueueFamilyIndex();
+    resources.computeQueue = ae::VulkanManager::Get().GetQueue(VulkanQueueType::COMPUTE);
+    resources.computeQueueFamilyIndex = ae::VulkanManager::Get().GetQueueFamilyIndex(VulkanQueueType::COMPUTE);
+    resources.transferQueue = ae::VulkanManager::Get().GetQueue(VulkanQueueType::TRANSFER);
+    resources.transferQueueFamilyIndex = ae::VulkanManager::Get().GetQueueFamilyIndex(VulkanQueueType::TRANSFER);
+    resources.pipelineCache = ae::VulkanManager::Get().GetPipelineCache();
+    resources.allocator = ae::VulkanManager::Get().GetAllocator();
+    resources.frameTimelineSemaphore = m_FrameTimeline;
+    resources.hostTimelineSemaphore = m_HostTimeline;
 
     resources.swapchainFormat = m_SwapChainImageFormat;
     resources.swapchainExtent = m_SwapChainExtent;
@@ -2,16 +2,23 @@
 
 #ifdef AE_VULKAN
 
+#include <array>
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <span>
 #include <vector>
 
 #include "Vulkan.h"
 #include "Window.h"
 
+#include "FrameCapture.h"
 #include "VulkanManager.h"
 
 namespace ae
 {
+	class VulkanCommandAllocator;
+
 	class VulkanContext : public Context
 	{
 	public:
@@ -29,6 +36,10 @@ namespace ae
 		inline VkQueue GetGraphicsQueue() const { return ae::VulkanManager::Get().GetGraphicsQueue(); }
 		inline uint32_t GetGraphicsQueueFamilyIndex() const { return ae::VulkanManager::Get().GetGraphicsQueueFamilyIndex(); }
 
+		// Headless contexts have no surface or swapchain. They render into FramesInFlight offscreen images,
+		// exposed through the swapchain getters with the image index equal to the frame index, and leave each
+		// frame's image in VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL instead of presenting it.
+		inline bool IsHeadless() const { return m_Headless; }
 		inline VkSurfaceKHR GetSurface() const { return m_Surface; }
 		inline VkSwapchainKHR GetSwapChain() const { return m_SwapChain; }
 		inline VkFormat GetSwapChainImageFormat() const { return m_SwapChainImageFormat; }
@@ -36,11 +47,45 @@ namespace ae
 		inline const std::vector<VkImage>& GetSwapChainImages() const { return m_SwapChainImages; }
 		inline const std::vector<VkImageView>& GetSwapChainImageViews() const { return m_SwapChainImageViews; }
 
+		// With DeviceFeature::DynamicRendering ImGui is drawn with vkCmdBeginRendering and no render passes or
+		// framebuffers exist, so GetImGuiStandaloneRenderPass returns VK_NULL_HANDLE
 		inline VkRenderPass GetImGuiStandaloneRenderPass() const { return m_ImGuiStandaloneRenderPass; }
+		inline bool IsDynamicRenderingEnabled() const { return m_DynamicRendering; }
 		inline VkCommandPool GetCommandPool() const { return m_CommandPool; }
 
+		// Per-thread, per-frame-slot command buffers for app recording; reset when their slot is reused
+		inline VulkanCommandAllocator& GetCommandAllocator() const { return *m_pCommandAllocator; }
+
 		void SetOnSwapchainRecreatedCB(const std::function<void(const VulkanResources&)>& cb);
 
+		// Frame numbers start at 1 and increase by one per EndFrame. With DeviceFeature::TimelineSemaphore each
+		// frame signals its number on a timeline semaphore; otherwise completion is derived from the per-slot
+		// fences, which only know about the last FramesInFlight frames and report older ones conservatively.
+		uint64_t GetCompletedFrameNumber() const;
+		bool IsFrameComplete(uint64_t frameNumber) const;
+		void WaitForFrame(uint64_t frameNumber) const;
+		// Waits for every frame submitted so far, which is all that teardown of this context's objects needs
+		void WaitForSubmittedFrames() const;
+
+		// CPU-produced dependencies (timeline mode only). The next submitted frame waits on the GPU until the
+		// host timeline reaches the largest value added, which any thread may signal.
+		void AddHostDependency(uint64_t value);
+		void SignalHost(uint64_t value);
+
+		inline uint64_t GetCurrentFrameNumber() const { return m_FrameNumber; }
+
+		PresentMode GetPresentMode() const;
+		inline double GetPresentLatency() const { return m_PresentLatency; }
+		inline bool IsFrameTimelineEnabled() const { return m_FrameTimeline != VK_NULL_HANDLE; }
+
+		// Frame capture into a host-visible buffer per frame slot. EndFrame copies the frame's image into the slot's
+		// buffer when the frame was asked for, and the copy is handed to frameCapture once BeginFrame has waited
+		// for that slot again, so reading it back never waits on the GPU. Needs TRANSFER_SRC support on the
+		// swapchain and an 8-bit RGBA or BGRA format; otherwise requests are dropped with a warning.
+		inline void SetFrameCapture(FrameCapture* pFrameCapture) { m_pFrameCapture = pFrameCapture; }
+		// Blocks until every captured frame has completed and been handed over
+		void FlushCaptures();
+
 		VulkanResources GetVulkanResources() const override;
 	protected:
 		bool CreateImpl() override;
@@ -55,6 +100,9 @@ namespace ae
 		void CreateSwapChain();
 		void DestroySwapChain();
 
+		void CreateOffscreenTargets();
+		void DestroyOffscreenTargets();
+
 		void CreateSwapChainImageViews();
 		void DestroySwapChainImageViews();
 
@@ -79,13 +127,43 @@ namespace ae
 		void CreateSyncObjects();
 		void DestroySyncObjects();
 
+		void CreatePresentSemaphores();
+		void DestroyPresentSemaphores();
+
+		void CreateTimelineSemaphores();
+		void DestroyTimelineSemaphores();
+
+		struct FrameSemaphore
+		{
+			VkSemaphore semaphore;
+			uint64_t value; // 0 for binary semaphores
+			VkPipelineStageFlags stages;
+		};
+
+		VkResult SubmitFrame(std::span<const VkCommandBuffer> commandBuffers, std::span<const FrameSemaphore> waits, std::span<const FrameSemaphore> signals, VkFence fence);
+		VkResult SubmitFrame2(std::span<const VkCommandBuffer> commandBuffers, std::span<const FrameSemaphore> waits, std::span<const FrameSemaphore> signals, VkFence fence);
+
+		void WaitForFrameSlot(uint32_t slot);
+		void ThrottlePresents();
+
 		void RecreateSwapChain();
+		void ReleaseRetiredSwapChains(bool all);
 
 		VkCommandBuffer RecordImGuiOverlay();
 		VkCommandBuffer RecordImGuiStandalone();
-		VkCommandBuffer RecordTransitionToPresent();
+		VkCommandBuffer RecordImGuiDynamic(bool overlay);
+		VkCommandBuffer RecordTransitionToPresent(VkImageLayout oldLayout);
+		VkCommandBuffer RecordCapture();
+		// Every path through EndFrame leaves the image in this layout. Offscreen targets are left ready to be
+		// copied from, since nothing presents them; captures of presented frames transition from and back to it.
+		inline VkImageLayout GetFrameEndLayout() const
+		{
+			return m_Headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		}
+		void RecordSwapChainBarrier(VkCommandBuffer cmd, VkImageLayout oldLayout, VkImageLayout newLayout, VkPipelineStageFlags srcStages, VkAccessFlags srcAccess, VkPipelineStageFlags dstStages, VkAccessFlags dstAccess);
 	private:
 		uint32_t m_FramesInFlight;
+		bool m_Headless;
 
 		VkSurfaceKHR m_Surface;
 
@@ -95,14 +173,17 @@ namespace ae
 
 		std::vector<VkImage> m_SwapChainImages;
 		std::vector<VkImageView> m_SwapChainImageViews;
+		std::vector<VmaAllocation> m_OffscreenAllocations;
 
 		VkRenderPass m_ImGuiStandaloneRenderPass;
 		VkRenderPass m_ImGuiOverlayRenderPass;
+		bool m_DynamicRendering;
 
 		std::vector<VkFramebuffer> m_ImGuiStandaloneFramebuffers;
 		std::vector<VkFramebuffer> m_ImGuiOverlayFramebuffers;
 
 		VkCommandPool m_CommandPool;
+		std::unique_ptr<VulkanCommandAllocator> m_pCommandAllocator;
 
 		std::vector<VkCommandBuffer> m_ImGuiCommandBuffers;
 		std::vector<VkCommandBuffer> m_TransitionCommandBuffers;
@@ -111,11 +192,78 @@ namespace ae
 		std::vector<VkSemaphore> m_RenderFinishedSemaphores;
 		std::vector<VkFence> m_InFlightFences;
 
+		VkSemaphore m_FrameTimeline;
+		VkSemaphore m_HostTimeline;
+		uint64_t m_HostDependencyValue;
+
+		// The number of the frame being recorded, the frame number last submitted from each frame slot, and
+		// the newest frame known to be complete (fence mode)
+		uint64_t m_FrameNumber;
+		std::vector<uint64_t> m_FrameSlotValues;
+		uint64_t m_CompletedFrameNumber;
+
+		// This context's source in the device's deletion queue (see VulkanDeletionQueue)
+		uint32_t m_DeletionSource = 0;
+
+		// Presents are tagged with their frame number (VK_KHR_present_id). Begin times are kept for the last
+		// few frames so the present latency can be computed once a present is reported as displayed.
+		VkPresentModeKHR m_PresentMode;
+		uint64_t m_FirstSwapChainPresentId;
+		uint64_t m_LastPresentId;
+		std::array<double, 16> m_FrameBeginTimes;
+		ae::Timer m_LatencyTimer;
+		double m_PresentLatency;
+
 		uint32_t m_CurrentFrame;
 		uint32_t m_CurrentImageIndex;
 		bool m_NeedsResize;
 
 		std::function<void(const VulkanResources&)> m_OnSwapchainRecreated;
+
+		// Objects from replaced swapchains. frameNumber is the first frame rendered after the replacement, which
+		// is also the id of the first present to the new swapchain; see ReleaseRetiredSwapChains for when they go.
+		struct RetiredSwapChain
+		{
+			uint64_t frameNumber = 0;
+			VkSwapchainKHR swapChain = VK_NULL_HANDLE;
+			std::vector<VkImageView> imageViews;
+			std::vector<VkFramebuffer> framebuffers;
+			std::vector<VkRenderPass> renderPasses;
+			std::vector<VkSemaphore> semaphores;
+		};
+
+		std::vector<RetiredSwapChain> m_RetiredSwapChains;
+
+		struct CaptureSlot
+		{
+			VkBuffer buffer = VK_NULL_HANDLE;
+			VmaAllocation allocation = VK_NULL_HANDLE;
+			uint8_t* pMapped = nullptr;
+			VkExtent2D extent{};
+			bool swapRedBlue = false;
+			bool pending = false;
+			uint64_t frameNumber = 0;
+			std::vector<FrameCapture::Request> requests;
+			std::atomic<bool> busy = false;
+		};
+
+		void DestroyCaptureBuffer(CaptureSlot& slot);
+		void HandOverCapture(CaptureSlot& slot);
+
+		FrameCapture* m_pFrameCapture = nullptr;
+		bool m_CaptureSupported = false;
+		std::vector<CaptureSlot> m_CaptureSlots;
+		std::vector<VkCommandBuffer> m_CaptureCommandBuffers;
+	private:
+		static constexpr VkPipelineStageFlags s_UploadWaitStages = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+			VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+		static constexpr uint32_t s_MaxFrameWaits = 3;
+		static constexpr uint32_t s_MaxFrameSignals = 2;
+		static constexpr uint32_t s_MaxFrameCommandBuffers = 32;
+		static constexpr uint32_t s_InternalFrameCommandBuffers = 2; // ImGui or present transition, then capture
+		static constexpr uint64_t s_PresentWaitTimeout = 1'000'000'000; // 1 second
+		static constexpr VkFormat s_OffscreenFormat = VK_FORMAT_R8G8B8A8_UNORM;
 	};
 }
 
@@ -0,0 +1,226 @@
+#include "general/pch.h"
+
+#ifdef AE_VULKAN
+
+#include "VulkanDeletionQueue.h"
+#include "VulkanManager.h"
+
+#include <algorithm>
+
+ae::VulkanDeletionQueue::~VulkanDeletionQueue()
+{
+    for (Batch &batch : m_Batches)
+    {
+        for (size_t i = batch.destroyed; i < batch.entries.size(); i++)
+        {
+            Destroy(batch.entries[i]);
+        }
+    }
+}
+
+void ae::VulkanDeletionQueue::Enqueue(VkObjectType type, uint64_t handle, VmaAllocation allocation)
+{
+    if (handle == 0 && allocation == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    std::scoped_lock lock(m_Mutex);
+
+    GetOpenBatch().entries.push_back(Entry{ .type = type, .handle = handle, .allocation = allocation });
+}
+
+void ae::VulkanDeletionQueue::Enqueue(std::function<void()> destroy)
+{
+    std::scoped_lock lock(m_Mutex);
+
+    GetOpenBatch().entries.push_back(Entry{ .destroy = std::move(destroy) });
+}
+
+uint32_t ae::VulkanDeletionQueue::AddSource()
+{
+    std::scoped_lock lock(m_Mutex);
+
+    uint32_t id = m_NextSourceId++;
+    m_Sources.push_back(Source{ .id = id });
+
+    // Batches opened before this source existed do not wait for it, which is right since it has recorded nothing
+    m_BatchOpen = false;
+
+    return id;
+}
+
+void ae::VulkanDeletionQueue::RemoveSource(uint32_t source)
+{
+    std::scoped_lock lock(m_Mutex);
+
+    std::erase_if(m_Sources, [source](const Source &s) { return s.id == source; });
+}
+
+void ae::VulkanDeletionQueue::Collect(uint32_t source, uint64_t recordingFrame, uint64_t completedFrame)
+{
+    std::vector<Entry> ready;
+
+    {
+        std::scoped_lock lock(m_Mutex);
+
+        auto it =
+            std::find_if(m_Sources.begin(), m_Sources.end(), [source](const Source &s) { return s.id == source; });
+
+        if (it == m_Sources.end())
+        {
+            return;
+        }
+
+        // Anything enqueued from now on may be used by the new frame, so it needs a batch of its own
+        if (it->recordingFrame != recordingFrame)
+        {
+            it->recordingFrame = recordingFrame;
+            m_BatchOpen = false;
+        }
+
+        it->completedFrame = completedFrame;
+
+        // Batches complete in order, since every later batch waits for the same frames or newer ones
+        while (!m_Batches.empty() && ready.size() < s_MaxDestroysPerCollect && IsBatchComplete(m_Batches.front()))
+        {
+            Batch &batch = m_Batches.front();
+            size_t count = std::min(batch.entries.size() - batch.destroyed, s_MaxDestroysPerCollect - ready.size());
+
+            for (size_t i = 0; i < count; i++)
+            {
+                ready.push_back(std::move(batch.entries[batch.destroyed++]));
+            }
+
+            if (batch.destroyed < batch.entries.size())
+            {
+                break;
+            }
+
+            if (m_Batches.size() == 1)
+            {
+                m_BatchOpen = false;
+            }
+
+            m_Batches.pop_front();
+        }
+    }
+
+    // Outside the lock, so destroy callbacks may enqueue more
+    for (Entry &entry : ready)
+    {
+        Destroy(entry);
+    }
+}
+
+ae::VulkanDeletionQueue::Batch &ae::VulkanDeletionQueue::GetOpenBatch()
+{
+    if (m_BatchOpen && !m_Batches.empty())
+    {
+        return m_Batches.back();
+    }
+
+    Batch &batch = m_Batches.emplace_back();
+    batch.waits.reserve(m_Sources.size());
+
+    for (const Source &source : m_Sources)
+    {
+        batch.waits.emplace_back(source.id, source.recordingFrame);
+    }
+
+    m_BatchOpen = true;
+
+    return batch;
+}
+
+bool ae::VulkanDeletionQueue::IsBatchComplete(const Batch &batch) const
+{
+    for (const auto &[id, frame] : batch.waits)
+    {
+        auto it = std::find_if(m_Sources.begin(), m_Sources.end(), [id](const Source &s) { return s.id == id; });
+
+        // A removed source waited for all of its frames before it went away
+        if (it != m_Sources.end() && it->completedFrame < frame)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ae::VulkanDeletionQueue::Destroy(Entry &entry)
+{
+    if (entry.destroy)
+    {
+        entry.destroy();
+        return;
+    }
+
+    VkDevice device = VulkanManager::Get().GetDevice();
+    VmaAllocator allocator = VulkanManager::Get().GetAllocator();
+
+    switch (entry.type)
+    {
+    case VK_OBJECT_TYPE_UNKNOWN:
+        vmaFreeMemory(allocator, entry.allocation);
+        break;
+    case VK_OBJECT_TYPE_BUFFER:
+        VulkanDestroyBuffer(allocator, reinterpret_cast<VkBuffer>(entry.handle), entry.allocation);
+        break;
+    case VK_OBJECT_TYPE_IMAGE:
+        VulkanDestroyImage(allocator, reinterpret_cast<VkImage>(entry.handle), entry.allocation);
+        break;
+    case VK_OBJECT_TYPE_BUFFER_VIEW:
+        vkDestroyBufferView(device, reinterpret_cast<VkBufferView>(entry.handle), nullptr);
+        break;
+    case VK_OBJECT_TYPE_IMAGE_VIEW:
+        vkDestroyImageView(device, reinterpret_cast<VkImageView>(entry.handle), nullptr);
+        break;
+    case VK_OBJECT_TYPE_SAMPLER:
+        vkDestroySampler(device, reinterpret_cast<VkSampler>(entry.handle), nullptr);
+        break;
+    case VK_OBJECT_TYPE_SHADER_MODULE:
+        vkDestroyShaderModule(device, reinterpret_cast<VkShaderModule>(entry.handle), nullptr);
+        break;
+    case VK_OBJECT_TYPE_PIPELINE:
+        vkDestroyPipeline(device, reinterpret_cast<VkPipeline>(entry.handle), nullptr);
+        break;
+    case VK_OBJECT_TYPE_PIPELINE_LAYOUT:
+        vkDestroyPipelineLayout(device, reinterpret_cast<VkPipelineLayout>(entry.handle), nullptr);
+        break;
+    case VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT:
+        vkDestroyDescriptorSetLayout(device, reinterpret_cast<VkDescriptorSetLayout>(entry.handle), nullptr);
+        break;
+    case VK_OBJECT_TYPE_DESCRIPTOR_POOL:
+        vkDestroyDescriptorPool(device, reinterpret_cast<VkDescriptorPool>(entry.handle), nullptr);
+        break;
+    case VK_OBJECT_TYPE_RENDER_PASS:
+        vkDestroyRenderPass(device, reinterpret_cast<VkRenderPass>(entry.handle), nullptr);
+        break;
+    case VK_OBJECT_TYPE_FRAMEBUFFER:
+        vkDestroyFramebuffer(device, reinterpret_cast<VkFramebuffer>(entry.handle), nullptr);
+        break;
+    case VK_OBJECT_TYPE_COMMAND_POOL:
+        vkDestroyCommandPool(device, reinterpret_cast<VkCommandPool>(entry.handle), nullptr);
+        break;
+    case VK_OBJECT_TYPE_QUERY_POOL:
+        vkDestroyQueryPool(device, reinterpret_cast<VkQueryPool>(entry.handle), nullptr);
+        break;
+    case VK_OBJECT_TYPE_SEMAPHORE:
+        vkDestroySemaphore(device, reinterpret_cast<VkSemaphore>(entry.handle), nullptr);
+        break;
+    case VK_OBJECT_TYPE_FENCE:
+        vkDestroyFence(device, reinterpret_cast<VkFence>(entry.handle), nullptr);
+        break;
+    case VK_OBJECT_TYPE_EVENT:
+        vkDestroyEvent(device, reinterpret_cast<VkEvent>(entry.handle), nullptr);
+        break;
+    default:
+        AE_LOG(AE_WARNING, "Deferred destruction of Vulkan object type {} is not supported, leaking it",
+               static_cast<int32_t>(entry.type));
+        break;
+    }
+}
+
+#endif // AE_VULKAN
@@ -0,0 +1,111 @@
+#pragma once
+
+#ifdef AE_VULKAN
+
+#include "Vulkan.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ae
+{
+	// Device-wide deferred destruction. Objects are enqueued when the app stops using them and destroyed once every
+	// frame that could still reference them has completed, instead of idling the device first. Frame numbers are
+	// per context, so each context is a source: an object waits for the frame each live source was recording when
+	// it was enqueued. Sources that are removed have waited for their own frames and no longer hold anything back.
+	//
+	// Every context collects from BeginFrame after waiting for its frame slot. A collect destroys at most
+	// s_MaxDestroysPerCollect objects, so freeing a large scene is spread over a few frames instead of stalling one.
+	class VulkanDeletionQueue
+	{
+	public:
+		VulkanDeletionQueue() = default;
+		VulkanDeletionQueue(const VulkanDeletionQueue&) = delete;
+		VulkanDeletionQueue& operator=(const VulkanDeletionQueue&) = delete;
+		// Destroys everything still queued; only valid once every source has been removed
+		~VulkanDeletionQueue();
+
+		// Thread-safe. Buffers and images with an allocation are destroyed through VulkanDestroyBuffer and
+		// VulkanDestroyImage; a lone allocation (VK_OBJECT_TYPE_UNKNOWN) is freed with vmaFreeMemory.
+		void Enqueue(VkObjectType type, uint64_t handle, VmaAllocation allocation = VK_NULL_HANDLE);
+		// For anything the type switch does not cover, such as descriptor sets returned to their pool
+		void Enqueue(std::function<void()> destroy);
+
+		template <typename T> requires std::is_pointer_v<T>
+		inline void Enqueue(T handle, VmaAllocation allocation = VK_NULL_HANDLE) { Enqueue(GetObjectType<T>(), reinterpret_cast<uint64_t>(handle), allocation); }
+
+		uint32_t AddSource();
+		void RemoveSource(uint32_t source);
+
+		// recordingFrame is the frame the source records next (or is recording), completedFrame the newest
+		// frame of the source known to have completed on the GPU
+		void Collect(uint32_t source, uint64_t recordingFrame, uint64_t completedFrame);
+	private:
+		struct Entry
+		{
+			VkObjectType type = VK_OBJECT_TYPE_UNKNOWN;
+			uint64_t handle = 0;
+			VmaAllocation allocation = VK_NULL_HANDLE;
+			std::function<void()> destroy;
+		};
+
+		struct Source
+		{
+			uint32_t id = 0;
+			uint64_t recordingFrame = 0;
+			uint64_t completedFrame = 0;
+		};
+
+		// Entries enqueued while no source changed its recording frame share one set of frames to wait for
+		struct Batch
+		{
+			std::vector<std::pair<uint32_t, uint64_t>> waits;
+			std::vector<Entry> entries;
+			size_t destroyed = 0;
+		};
+
+		template <typename T>
+		static constexpr VkObjectType GetObjectType()
+		{
+			if constexpr (std::is_same_v<T, VkBuffer>) return VK_OBJECT_TYPE_BUFFER;
+			else if constexpr (std::is_same_v<T, VkImage>) return VK_OBJECT_TYPE_IMAGE;
+			else if constexpr (std::is_same_v<T, VkBufferView>) return VK_OBJECT_TYPE_BUFFER_VIEW;
+			else if constexpr (std::is_same_v<T, VkImageView>) return VK_OBJECT_TYPE_IMAGE_VIEW;
+			else if constexpr (std::is_same_v<T, VkSampler>) return VK_OBJECT_TYPE_SAMPLER;
+			else if constexpr (std::is_same_v<T, VkShaderModule>) return VK_OBJECT_TYPE_SHADER_MODULE;
+			else if constexpr (std::is_same_v<T, VkPipeline>) return VK_OBJECT_TYPE_PIPELINE;
+			else if constexpr (std::is_same_v<T, VkPipelineLayout>) return VK_OBJECT_TYPE_PIPELINE_LAYOUT;
+			else if constexpr (std::is_same_v<T, VkDescriptorSetLayout>) return VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT;
+			else if constexpr (std::is_same_v<T, VkDescriptorPool>) return VK_OBJECT_TYPE_DESCRIPTOR_POOL;
+			else if constexpr (std::is_same_v<T, VkRenderPass>) return VK_OBJECT_TYPE_RENDER_PASS;
+			else if constexpr (std::is_same_v<T, VkFramebuffer>) return VK_OBJECT_TYPE_FRAMEBUFFER;
+			else if constexpr (std::is_same_v<T, VkCommandPool>) return VK_OBJECT_TYPE_COMMAND_POOL;
+			else if constexpr (std::is_same_v<T, VkQueryPool>) return VK_OBJECT_TYPE_QUERY_POOL;
+			else if constexpr (std::is_same_v<T, VkSemaphore>) return VK_OBJECT_TYPE_SEMAPHORE;
+			else if constexpr (std::is_same_v<T, VkFence>) return VK_OBJECT_TYPE_FENCE;
+			else if constexpr (std::is_same_v<T, VkEvent>) return VK_OBJECT_TYPE_EVENT;
+			else static_assert(!sizeof(T), "Unsupported Vulkan handle type for deferred destruction");
+		}
+
+		Batch& GetOpenBatch();
+		bool IsBatchComplete(const Batch& batch) const;
+		static void Destroy(Entry& entry);
+	private:
+		std::mutex m_Mutex;
+		std::vector<Source> m_Sources;
+		uint32_t m_NextSourceId = 1;
+
+		// The back batch is open while its waits still match the sources' recording frames
+		std::deque<Batch> m_Batches;
+		bool m_BatchOpen = false;
+	private:
+		static constexpr size_t s_MaxDestroysPerCollect = 256;
+	};
+}
+
+#endif // AE_VULKAN
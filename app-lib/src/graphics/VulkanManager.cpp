@@ -2,11 +2,17 @@
 
 #ifdef AE_VULKAN
 
+#include "Files.h"
 #include "OpenGL.h"
+#include "VulkanDeletionQueue.h"
 #include "VulkanManager.h"
+#include "VulkanShaderRegistry.h"
+#include "VulkanUploadManager.h"
 #include "Window.h"
 
 #include <algorithm>
+#include <filesystem>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -27,6 +33,8 @@ struct SupportedDeviceFeatures
     VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRendering{};
     VkPhysicalDeviceSynchronization2FeaturesKHR sync2{};
     VkPhysicalDeviceComputeShaderDerivativesFeaturesKHR derivatives{};
+    VkPhysicalDevicePresentIdFeaturesKHR presentId{};
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWait{};
     VkPhysicalDeviceVulkan12Features vulkan12{};
 };
 
@@ -35,11 +43,15 @@ void QuerySupportedFeatures(VkPhysicalDevice device, SupportedDeviceFeatures &su
     supported.dynamicRendering.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
     supported.sync2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
     supported.derivatives.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_COMPUTE_SHADER_DERIVATIVES_FEATURES_KHR;
+    supported.presentId.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    supported.presentWait.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
     supported.vulkan12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
 
     supported.dynamicRendering.pNext = &supported.sync2;
     supported.sync2.pNext = &supported.derivatives;
-    supported.derivatives.pNext = &supported.vulkan12;
+    supported.derivatives.pNext = &supported.presentId;
+    supported.presentId.pNext = &supported.presentWait;
+    supported.presentWait.pNext = &supported.vulkan12;
 
     supported.features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
     supported.features2.pNext = &supported.dynamicRendering;
@@ -98,12 +110,111 @@ VkPhysicalDeviceFeatures SelectCoreFeatures(ae::DeviceFeatures requested, const
     return enabled;
 }
 
+bool IsDeviceExtensionAvailable(VkPhysicalDevice device, const char *name)
+{
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+    return std::ranges::any_of(availableExtensions, [name](const VkExtensionProperties &properties)
+                               { return strcmp(name, properties.extensionName) == 0; });
+}
+
+constexpr uint32_t s_PipelineCacheMagic = 0x43504541; // "AEPC"
+constexpr uint32_t s_PipelineCacheFormatVersion = 1;
+
+// Prepended to the driver's cache blob. The driver validates its own header as well, but some drivers
+// crash on foreign data, so the identity of the device and driver is checked before handing it over.
+struct PipelineCacheFileHeader
+{
+    uint32_t magic;
+    uint32_t formatVersion;
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint32_t driverVersion;
+    uint32_t reserved;
+    std::array<uint8_t, VK_UUID_SIZE> driverUUID;
+    std::array<uint8_t, VK_UUID_SIZE> pipelineCacheUUID;
+    uint64_t dataSize;
+    uint64_t dataHash;
+};
+
+PipelineCacheFileHeader MakePipelineCacheHeader(VkPhysicalDevice device)
+{
+    VkPhysicalDeviceIDProperties idProperties{};
+    idProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+
+    VkPhysicalDeviceProperties2 properties{};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &idProperties;
+
+    vkGetPhysicalDeviceProperties2(device, &properties);
+
+    PipelineCacheFileHeader header{};
+    header.magic = s_PipelineCacheMagic;
+    header.formatVersion = s_PipelineCacheFormatVersion;
+    header.vendorID = properties.properties.vendorID;
+    header.deviceID = properties.properties.deviceID;
+    header.driverVersion = properties.properties.driverVersion;
+    std::memcpy(header.driverUUID.data(), idProperties.driverUUID, VK_UUID_SIZE);
+    std::memcpy(header.pipelineCacheUUID.data(), properties.properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+    return header;
+}
+
+uint64_t HashPipelineCacheData(const uint8_t *pData, size_t size)
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= pData[i];
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+// Returns the driver blob stored in the file, or an empty span if the file was written by another
+// device, driver or format version, or has been truncated or corrupted.
+std::span<const uint8_t> ExtractPipelineCacheData(const std::vector<uint8_t> &contents,
+                                                  const PipelineCacheFileHeader &expected)
+{
+    if (contents.size() < sizeof(PipelineCacheFileHeader))
+    {
+        return {};
+    }
+
+    PipelineCacheFileHeader stored;
+    std::memcpy(&stored, contents.data(), sizeof(PipelineCacheFileHeader));
+
+    if (stored.magic != expected.magic || stored.formatVersion != expected.formatVersion ||
+        stored.vendorID != expected.vendorID || stored.deviceID != expected.deviceID ||
+        stored.driverVersion != expected.driverVersion || stored.driverUUID != expected.driverUUID ||
+        stored.pipelineCacheUUID != expected.pipelineCacheUUID)
+    {
+        return {};
+    }
+
+    std::span<const uint8_t> data(contents.data() + sizeof(PipelineCacheFileHeader),
+                                  contents.size() - sizeof(PipelineCacheFileHeader));
+
+    if (data.size() != stored.dataSize || HashPipelineCacheData(data.data(), data.size()) != stored.dataHash)
+    {
+        return {};
+    }
+
+    return data;
+}
+
 } // namespace
 
 ae::VulkanManager::VulkanManager()
     : m_ContextCount(0), m_Version("None"), m_Renderer("None"), m_Vendor("None"), m_VulkanInstance(VK_NULL_HANDLE),
-      m_PhysicalDevice(VK_NULL_HANDLE), m_Device(VK_NULL_HANDLE), m_GraphicsQueue(VK_NULL_HANDLE),
-      m_GraphicsQueueFamilyIndex(0)
+      m_PhysicalDevice(VK_NULL_HANDLE), m_Device(VK_NULL_HANDLE), m_PipelineCache(VK_NULL_HANDLE),
+      m_Allocator(VK_NULL_HANDLE)
 {
 }
 
@@ -134,32 +245,144 @@ void ae::VulkanManager::RequestDeviceFeatures(DeviceFeatures features)
     m_RequestedFeatures |= features.Bits();
 }
 
-VkResult ae::VulkanManager::SubmitToQueue(const VkSubmitInfo &submitInfo, VkFence fence)
+VkResult ae::VulkanManager::SubmitToQueue(VulkanQueueType type, const VkSubmitInfo &submitInfo, VkFence fence)
+{
+    const QueueSlot &slot = m_Queues[static_cast<size_t>(type)];
+
+    std::scoped_lock lock(m_QueueMutexes[slot.lockIndex]);
+    return vkQueueSubmit(slot.queue, 1, &submitInfo, fence);
+}
+
+VkResult ae::VulkanManager::SubmitToQueue2(VulkanQueueType type, const VkSubmitInfo2 &submitInfo, VkFence fence)
+{
+    if (!m_pfnQueueSubmit2)
+    {
+        AE_THROW_RUNTIME_ERROR("vkQueueSubmit2 requires DeviceFeature::Synchronization2");
+    }
+
+    const QueueSlot &slot = m_Queues[static_cast<size_t>(type)];
+
+    std::scoped_lock lock(m_QueueMutexes[slot.lockIndex]);
+    return m_pfnQueueSubmit2(slot.queue, 1, &submitInfo, fence);
+}
+
+void ae::VulkanManager::WaitQueueIdle(VulkanQueueType type)
+{
+    const QueueSlot &slot = m_Queues[static_cast<size_t>(type)];
+
+    std::scoped_lock lock(m_QueueMutexes[slot.lockIndex]);
+    vkQueueWaitIdle(slot.queue);
+}
+
+VkResult ae::VulkanManager::WaitForPresent(VkSwapchainKHR swapChain, uint64_t presentId, uint64_t timeout)
 {
-    std::scoped_lock lock(m_QueueMutex);
-    return vkQueueSubmit(m_GraphicsQueue, 1, &submitInfo, fence);
+    if (!m_pfnWaitForPresent)
+    {
+        AE_THROW_RUNTIME_ERROR("Waiting for presents requires DeviceFeature::PresentWait");
+    }
+
+    return m_pfnWaitForPresent(m_Device, swapChain, presentId, timeout);
 }
 
 VkResult ae::VulkanManager::PresentToQueue(const VkPresentInfoKHR &presentInfo)
 {
-    std::scoped_lock lock(m_QueueMutex);
-    return vkQueuePresentKHR(m_GraphicsQueue, &presentInfo);
+    const QueueSlot &slot = m_Queues[static_cast<size_t>(VulkanQueueType::GRAPHICS)];
+
+    std::scoped_lock lock(m_QueueMutexes[slot.lockIndex]);
+    return vkQueuePresentKHR(slot.queue, &presentInfo);
 }
 
-void ae::VulkanManager::WaitQueueIdle()
+ae::VulkanUploadManager &ae::VulkanManager::GetUploadManager()
 {
-    std::scoped_lock lock(m_QueueMutex);
-    vkQueueWaitIdle(m_GraphicsQueue);
+    std::scoped_lock lock(m_UploadManagerMutex);
+
+    if (!m_pUploadManager)
+    {
+        m_pUploadManager = std::make_unique<VulkanUploadManager>(s_UploadStagingSize);
+    }
+
+    return *m_pUploadManager;
+}
+
+ae::VulkanShaderRegistry &ae::VulkanManager::GetShaderRegistry()
+{
+    std::scoped_lock lock(m_ShaderRegistryMutex);
+
+    if (!m_pShaderRegistry)
+    {
+        m_pShaderRegistry = std::make_unique<VulkanShaderRegistry>();
+    }
+
+    return *m_pShaderRegistry;
+}
+
+ae::VulkanDeletionQueue &ae::VulkanManager::GetDeletionQueue()
+{
+    std::scoped_lock lock(m_DeletionQueueMutex);
+
+    if (!m_pDeletionQueue)
+    {
+        m_pDeletionQueue = std::make_unique<VulkanDeletionQueue>();
+    }
+
+    return *m_pDeletionQueue;
+}
+
+void ae::VulkanManager::SetPipelineCachePath(const std::string &path)
+{
+    m_PipelineCachePath = path;
+}
+
+void ae::VulkanManager::SavePipelineCache()
+{
+    if (m_PipelineCache == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    size_t dataSize = 0;
+    VK_CHECK(vkGetPipelineCacheData(m_Device, m_PipelineCache, &dataSize, nullptr));
+
+    std::vector<uint8_t> contents(sizeof(PipelineCacheFileHeader) + dataSize);
+    VkResult result =
+        vkGetPipelineCacheData(m_Device, m_PipelineCache, &dataSize, contents.data() + sizeof(PipelineCacheFileHeader));
+
+    if (result != VK_SUCCESS && result != VK_INCOMPLETE)
+    {
+        AE_THROW_VULKAN_ERROR("Failed to retrieve Vulkan pipeline cache data");
+    }
+
+    contents.resize(sizeof(PipelineCacheFileHeader) + dataSize);
+
+    PipelineCacheFileHeader header = MakePipelineCacheHeader(m_PhysicalDevice);
+    header.dataSize = dataSize;
+    header.dataHash = HashPipelineCacheData(contents.data() + sizeof(PipelineCacheFileHeader), dataSize);
+    std::memcpy(contents.data(), &header, sizeof(PipelineCacheFileHeader));
+
+    // Written next to the target and renamed over it, so a crash mid-write never leaves a truncated cache
+    BinaryFile tempFile(m_PipelineCachePath + ".tmp");
+    tempFile.SetData(std::move(contents));
+    tempFile.Write();
+
+    std::error_code ec;
+    std::filesystem::rename(tempFile.GetPath(), AE_FILE_PATH(m_PipelineCachePath), ec);
+
+    if (ec)
+    {
+        AE_THROW_FILESYSTEM_ERROR("Failed to replace pipeline cache '{}': {}", m_PipelineCachePath, ec.message());
+    }
+
+    AE_LOG(AE_TRACE, "Vulkan pipeline cache saved to '{}' ({} bytes)", m_PipelineCachePath, dataSize);
 }
 
 void ae::VulkanManager::AddSurface(VkSurfaceKHR surface)
 {
     m_Surfaces.push_back(surface);
 
-    if (m_ContextCount == 1)
+    if (m_Device == VK_NULL_HANDLE)
     {
         CreateDevices();
-        SetGraphicsQueue();
+        SetQueues();
 
         FindDeviceData();
     }
@@ -169,7 +392,7 @@ void ae::VulkanManager::AddSurface(VkSurfaceKHR surface)
         if (!IsDeviceSuitable(m_PhysicalDevice))
         {
             RecreateDevices();
-            SetGraphicsQueue();
+            SetQueues();
 
             FindDeviceData();
         }
@@ -185,10 +408,37 @@ void ae::VulkanManager::RemoveSurface(VkSurfaceKHR surface)
         m_Surfaces.erase(it);
     }
 
-    if (m_Surfaces.empty())
+    if (m_Surfaces.empty() && m_HeadlessTargetCount == 0)
     {
-        ResetGraphicsQueue();
         DestroyDevices();
+        ResetQueues();
+
+        ResetDeviceData();
+    }
+}
+
+void ae::VulkanManager::AddHeadlessTarget()
+{
+    m_HeadlessTargetCount++;
+
+    // Any existing device is suitable, since a headless target only needs a graphics queue
+    if (m_Device == VK_NULL_HANDLE)
+    {
+        CreateDevices();
+        SetQueues();
+
+        FindDeviceData();
+    }
+}
+
+void ae::VulkanManager::RemoveHeadlessTarget()
+{
+    m_HeadlessTargetCount--;
+
+    if (m_Surfaces.empty() && m_HeadlessTargetCount == 0)
+    {
+        DestroyDevices();
+        ResetQueues();
 
         ResetDeviceData();
     }
@@ -205,6 +455,12 @@ void ae::VulkanManager::CreateInstance(const std::string &name)
     appInfo.apiVersion = VK_API_VERSION_1_2;
 
     std::vector<const char *> extensions = GetRequiredExtensions();
+    m_SurfaceSupported = !extensions.empty();
+
+    if (!m_SurfaceSupported)
+    {
+        AE_LOG(AE_WARNING, "GLFW reports no Vulkan surface support, only headless Vulkan contexts can be created");
+    }
 
     if (!IsValidationLayersSupported())
     {
@@ -240,12 +496,15 @@ void ae::VulkanManager::DestroyInstance()
     vkDestroyInstance(m_VulkanInstance, nullptr);
 
     m_VulkanInstance = VK_NULL_HANDLE;
+    m_SurfaceSupported = false;
 }
 
 void ae::VulkanManager::CreateDevices()
 {
     FindPhysicalDevice();
     CreateLogicalDevice();
+    CreateAllocator();
+    CreatePipelineCache();
 }
 
 void ae::VulkanManager::RecreateDevices()
@@ -256,6 +515,13 @@ void ae::VulkanManager::RecreateDevices()
 
 void ae::VulkanManager::DestroyDevices()
 {
+    m_pUploadManager.reset();
+    // Every context has waited for its frames by now, so whatever is still queued can go
+    m_pDeletionQueue.reset();
+    m_pShaderRegistry.reset();
+
+    DestroyPipelineCache();
+    DestroyAllocator();
     DestroyLogicalDevice();
     ResetPhysicalDevice();
 }
@@ -302,15 +568,31 @@ void ae::VulkanManager::ResetPhysicalDevice()
 
 void ae::VulkanManager::CreateLogicalDevice()
 {
-    m_GraphicsQueueFamilyIndex = FindQueueFamilies(m_PhysicalDevice);
+    SelectQueues();
 
-    VkDeviceQueueCreateInfo queueCreateInfo{};
-    queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-    queueCreateInfo.queueFamilyIndex = m_GraphicsQueueFamilyIndex;
-    queueCreateInfo.queueCount = 1;
+    // One create info per family, with as many queues as the highest queue index selected in it
+    std::array<float, static_cast<size_t>(VulkanQueueType::COUNT)> queuePriorities;
+    queuePriorities.fill(1.0f);
 
-    float queuePriority = 1.0f;
-    queueCreateInfo.pQueuePriorities = &queuePriority;
+    std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
+
+    for (const QueueSlot &slot : m_Queues)
+    {
+        auto it = std::ranges::find(queueCreateInfos, slot.familyIndex, &VkDeviceQueueCreateInfo::queueFamilyIndex);
+
+        if (it == queueCreateInfos.end())
+        {
+            VkDeviceQueueCreateInfo queueCreateInfo{};
+            queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+            queueCreateInfo.queueFamilyIndex = slot.familyIndex;
+            queueCreateInfo.queueCount = 0;
+            queueCreateInfo.pQueuePriorities = queuePriorities.data();
+
+            it = queueCreateInfos.insert(queueCreateInfos.end(), queueCreateInfo);
+        }
+
+        it->queueCount = std::max(it->queueCount, slot.queueIndex + 1);
+    }
 
     DeviceFeatures requested = DeviceFeatures::FromBits(m_RequestedFeatures);
 
@@ -319,7 +601,13 @@ void ae::VulkanManager::CreateLogicalDevice()
 
     VkPhysicalDeviceFeatures deviceFeatures = SelectCoreFeatures(requested, supported.features2.features);
 
-    std::vector<const char *> deviceExtensions(s_DeviceExtensions.begin(), s_DeviceExtensions.end());
+    // VK_KHR_swapchain depends on the instance surface extensions, so a surfaceless instance goes without it
+    std::vector<const char *> deviceExtensions;
+
+    if (m_SurfaceSupported)
+    {
+        deviceExtensions.assign(s_DeviceExtensions.begin(), s_DeviceExtensions.end());
+    }
 
     void *pNextChain = nullptr;
     auto chainFeature = [&pNextChain](auto &featureStruct)
@@ -366,6 +654,32 @@ void ae::VulkanManager::CreateLogicalDevice()
         deviceExtensions.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
     }
 
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+    presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+    presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+
+    if (requested.Has(DeviceFeature::PresentWait))
+    {
+        RequireFeatureSupported(supported.presentId.presentId, "PresentWait (present id)");
+        RequireFeatureSupported(supported.presentWait.presentWait, "PresentWait");
+        presentIdFeatures.presentId = VK_TRUE;
+        presentWaitFeatures.presentWait = VK_TRUE;
+        deviceExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        deviceExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        chainFeature(presentIdFeatures);
+        chainFeature(presentWaitFeatures);
+    }
+
+    // Not a requestable feature, enabled whenever available so VMA can report real heap budgets
+    m_MemoryBudgetEnabled = IsDeviceExtensionAvailable(m_PhysicalDevice, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+    if (m_MemoryBudgetEnabled)
+    {
+        deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
     // Vulkan 1.2 promoted features share one struct, chained only if any is requested.
     VkPhysicalDeviceVulkan12Features vulkan12Features{};
     vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
@@ -374,6 +688,13 @@ void ae::VulkanManager::CreateLogicalDevice()
     if (requested.Has(DeviceFeature::TimelineSemaphore))
     {
         RequireFeatureSupported(supported.vulkan12.timelineSemaphore, "TimelineSemaphore");
+    }
+
+    // Timeline semaphores are also used internally (uploads), so they are enabled whenever supported
+    m_TimelineSemaphoreEnabled = supported.vulkan12.timelineSemaphore == VK_TRUE;
+
+    if (m_TimelineSemaphoreEnabled)
+    {
         vulkan12Features.timelineSemaphore = VK_TRUE;
         useVulkan12 = true;
     }
@@ -415,8 +736,8 @@ void ae::VulkanManager::CreateLogicalDevice()
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     createInfo.pNext = pNextChain;
-    createInfo.pQueueCreateInfos = &queueCreateInfo;
-    createInfo.queueCreateInfoCount = 1;
+    createInfo.pQueueCreateInfos = queueCreateInfos.data();
+    createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pEnabledFeatures = &deviceFeatures;
     createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
     createInfo.ppEnabledExtensionNames = deviceExtensions.data();
@@ -427,28 +748,267 @@ void ae::VulkanManager::CreateLogicalDevice()
     {
         AE_THROW_RUNTIME_ERROR("Failed to create Vulkan logical device");
     }
+
+    // Extension entry points are not exported by the loader and have to be fetched from the device
+    if (requested.Has(DeviceFeature::PresentWait))
+    {
+        m_pfnWaitForPresent =
+            reinterpret_cast<PFN_vkWaitForPresentKHR>(vkGetDeviceProcAddr(m_Device, "vkWaitForPresentKHR"));
+    }
+
+    if (requested.Has(DeviceFeature::Synchronization2))
+    {
+        m_pfnQueueSubmit2 =
+            reinterpret_cast<PFN_vkQueueSubmit2KHR>(vkGetDeviceProcAddr(m_Device, "vkQueueSubmit2KHR"));
+        m_pfnCmdPipelineBarrier2 = reinterpret_cast<PFN_vkCmdPipelineBarrier2KHR>(
+            vkGetDeviceProcAddr(m_Device, "vkCmdPipelineBarrier2KHR"));
+    }
+
+    if (requested.Has(DeviceFeature::DynamicRendering))
+    {
+        m_pfnCmdBeginRendering =
+            reinterpret_cast<PFN_vkCmdBeginRenderingKHR>(vkGetDeviceProcAddr(m_Device, "vkCmdBeginRenderingKHR"));
+        m_pfnCmdEndRendering =
+            reinterpret_cast<PFN_vkCmdEndRenderingKHR>(vkGetDeviceProcAddr(m_Device, "vkCmdEndRenderingKHR"));
+    }
 }
 
 void ae::VulkanManager::DestroyLogicalDevice()
 {
     vkDestroyDevice(m_Device, nullptr);
 
+    m_pfnWaitForPresent = nullptr;
+    m_pfnQueueSubmit2 = nullptr;
+    m_pfnCmdPipelineBarrier2 = nullptr;
+    m_pfnCmdBeginRendering = nullptr;
+    m_pfnCmdEndRendering = nullptr;
+
     m_Device = VK_NULL_HANDLE;
+    m_TimelineSemaphoreEnabled = false;
+}
+
+void ae::VulkanManager::SelectQueues()
+{
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(m_PhysicalDevice, &queueFamilyCount, nullptr);
+
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(m_PhysicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    auto findDedicatedFamily = [&queueFamilies](VkQueueFlags required, VkQueueFlags excluded,
+                                                uint32_t fallback) -> uint32_t
+    {
+        for (uint32_t i = 0; i < queueFamilies.size(); i++)
+        {
+            VkQueueFlags flags = queueFamilies[i].queueFlags;
+
+            if ((flags & required) == required && !(flags & excluded))
+            {
+                return i;
+            }
+        }
+
+        return fallback;
+    };
+
+    uint32_t graphicsFamily = static_cast<uint32_t>(FindQueueFamilies(m_PhysicalDevice));
+
+    // Async compute prefers a family without graphics, transfer one that maps to the DMA engines
+    std::array<uint32_t, static_cast<size_t>(VulkanQueueType::COUNT)> families{};
+    families[static_cast<size_t>(VulkanQueueType::GRAPHICS)] = graphicsFamily;
+    families[static_cast<size_t>(VulkanQueueType::COMPUTE)] =
+        findDedicatedFamily(VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT, graphicsFamily);
+    families[static_cast<size_t>(VulkanQueueType::TRANSFER)] =
+        findDedicatedFamily(VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT,
+                            families[static_cast<size_t>(VulkanQueueType::COMPUTE)]);
+
+    // Within a family, each type takes the next free queue; once the family runs out, the type aliases the
+    // last queue handed out there and shares its lock
+    std::vector<uint32_t> usedQueues(queueFamilyCount, 0);
+
+    for (uint32_t i = 0; i < m_Queues.size(); i++)
+    {
+        QueueSlot &slot = m_Queues[i];
+        slot.familyIndex = families[i];
+        slot.queue = VK_NULL_HANDLE;
+        slot.lockIndex = i;
+
+        if (usedQueues[slot.familyIndex] < queueFamilies[slot.familyIndex].queueCount)
+        {
+            slot.queueIndex = usedQueues[slot.familyIndex]++;
+            continue;
+        }
+
+        slot.queueIndex = usedQueues[slot.familyIndex] - 1;
+
+        for (uint32_t j = 0; j < i; j++)
+        {
+            if (m_Queues[j].familyIndex == slot.familyIndex && m_Queues[j].queueIndex == slot.queueIndex)
+            {
+                slot.lockIndex = m_Queues[j].lockIndex;
+                break;
+            }
+        }
+    }
+}
+
+void ae::VulkanManager::SetQueues()
+{
+    for (QueueSlot &slot : m_Queues)
+    {
+        vkGetDeviceQueue(m_Device, slot.familyIndex, slot.queueIndex, &slot.queue);
+    }
+
+    AE_LOG(AE_TRACE, "Vulkan queues: graphics {}.{}, compute {}.{}, transfer {}.{}",
+           m_Queues[static_cast<size_t>(VulkanQueueType::GRAPHICS)].familyIndex,
+           m_Queues[static_cast<size_t>(VulkanQueueType::GRAPHICS)].queueIndex,
+           m_Queues[static_cast<size_t>(VulkanQueueType::COMPUTE)].familyIndex,
+           m_Queues[static_cast<size_t>(VulkanQueueType::COMPUTE)].queueIndex,
+           m_Queues[static_cast<size_t>(VulkanQueueType::TRANSFER)].familyIndex,
+           m_Queues[static_cast<size_t>(VulkanQueueType::TRANSFER)].queueIndex);
+}
+
+void ae::VulkanManager::ResetQueues()
+{
+    m_Queues.fill(QueueSlot{});
 }
 
-void ae::VulkanManager::SetGraphicsQueue()
+void ae::VulkanManager::CreateAllocator()
 {
-    vkGetDeviceQueue(m_Device, m_GraphicsQueueFamilyIndex, 0, &m_GraphicsQueue);
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_PhysicalDevice, &properties);
+
+    // VMA may not assume a newer API version than both the instance and the device support
+    uint32_t deviceVersion = VK_MAKE_API_VERSION(0, VK_API_VERSION_MAJOR(properties.apiVersion),
+                                                 VK_API_VERSION_MINOR(properties.apiVersion), 0);
+    uint32_t apiVersion = std::min(deviceVersion, VK_API_VERSION_1_2);
+
+    VmaVulkanFunctions vulkanFunctions{};
+    vulkanFunctions.vkGetInstanceProcAddr = &vkGetInstanceProcAddr;
+    vulkanFunctions.vkGetDeviceProcAddr = &vkGetDeviceProcAddr;
+
+    VmaAllocatorCreateInfo createInfo{};
+    createInfo.instance = m_VulkanInstance;
+    createInfo.physicalDevice = m_PhysicalDevice;
+    createInfo.device = m_Device;
+    createInfo.vulkanApiVersion = apiVersion;
+    createInfo.pVulkanFunctions = &vulkanFunctions;
+
+    DeviceFeatures requested = DeviceFeatures::FromBits(m_RequestedFeatures);
+
+    if (requested.Has(DeviceFeature::BufferDeviceAddress))
+    {
+        createInfo.flags |= VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+    }
+
+    if (m_MemoryBudgetEnabled)
+    {
+        createInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    }
+
+    if (vmaCreateAllocator(&createInfo, &m_Allocator) != VK_SUCCESS)
+    {
+        AE_THROW_RUNTIME_ERROR("Failed to create Vulkan memory allocator");
+    }
 }
 
-void ae::VulkanManager::ResetGraphicsQueue()
+void ae::VulkanManager::DestroyAllocator()
 {
-    m_GraphicsQueue = VK_NULL_HANDLE;
-    m_GraphicsQueueFamilyIndex = 0;
+#ifdef AE_DEBUG
+    VulkanMemoryStats stats = VulkanGetMemoryStats();
+
+    if (stats.totalAllocationCount > 0)
+    {
+        AE_LOG(AE_WARNING, "Destroying Vulkan memory allocator with {} live allocations ({} bytes)",
+               stats.totalAllocationCount, stats.totalAllocationBytes);
+    }
+#endif // AE_DEBUG
+
+    vmaDestroyAllocator(m_Allocator);
+
+    m_Allocator = VK_NULL_HANDLE;
+    m_MemoryBudgetEnabled = false;
+}
+
+void ae::VulkanManager::CreatePipelineCache()
+{
+    ae::Timer timer;
+    timer.Start();
+
+    PipelineCacheFileHeader expected = MakePipelineCacheHeader(m_PhysicalDevice);
+
+    BinaryFile file(m_PipelineCachePath);
+    std::span<const uint8_t> initialData;
+
+    if (File::Exists(m_PipelineCachePath))
+    {
+        file.Read();
+        initialData = ExtractPipelineCacheData(file.GetData(), expected);
+
+        if (initialData.empty())
+        {
+            AE_LOG(AE_WARNING, "Discarding pipeline cache '{}', it was written by another device or driver or is "
+                               "corrupted",
+                   m_PipelineCachePath);
+        }
+    }
+
+    VkPipelineCacheCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.initialDataSize = initialData.size();
+    createInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+    VkResult result = vkCreatePipelineCache(m_Device, &createInfo, nullptr, &m_PipelineCache);
+
+    // The driver may still reject data it does not recognize, fall back to an empty cache in that case
+    if (result != VK_SUCCESS && !initialData.empty())
+    {
+        initialData = {};
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData = nullptr;
+
+        result = vkCreatePipelineCache(m_Device, &createInfo, nullptr, &m_PipelineCache);
+    }
+
+    if (result != VK_SUCCESS)
+    {
+        AE_THROW_RUNTIME_ERROR("Failed to create Vulkan pipeline cache");
+    }
+
+    m_PipelineCacheWarm = !initialData.empty();
+
+    AE_LOG(AE_TRACE, "Vulkan pipeline cache created {} ({} bytes) in {:.3f} ms", m_PipelineCacheWarm ? "warm" : "cold",
+           initialData.size(), timer.GetElapsedTime() * 1000.0);
+}
+
+void ae::VulkanManager::DestroyPipelineCache()
+{
+    // Failing to persist the cache only costs startup time on the next run, so it must not abort teardown
+    try
+    {
+        SavePipelineCache();
+    }
+    catch (const std::exception &e)
+    {
+        AE_LOG(AE_WARNING, "Failed to save Vulkan pipeline cache: {}", e.what());
+    }
+
+    vkDestroyPipelineCache(m_Device, m_PipelineCache, nullptr);
+
+    m_PipelineCache = VK_NULL_HANDLE;
+    m_PipelineCacheWarm = false;
 }
 
 std::vector<const char *> ae::VulkanManager::GetRequiredExtensions()
 {
+    // Without a Vulkan-capable platform (no display server, or GLFW's null platform without
+    // VK_EXT_headless_surface) the instance is created without surface extensions. Checked first, since
+    // glfwGetRequiredInstanceExtensions reports an error in that case.
+    if (!glfwVulkanSupported())
+    {
+        return {};
+    }
+
     uint32_t glfwExtensionCount = 0;
     const char **glfwExtensions;
 
@@ -534,6 +1094,11 @@ bool ae::VulkanManager::IsDeviceSuitable(VkPhysicalDevice device)
 
 bool ae::VulkanManager::IsDeviceExtensionsSupported(VkPhysicalDevice device)
 {
+    if (!m_SurfaceSupported)
+    {
+        return true;
+    }
+
     uint32_t extensionCount;
     vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
 
@@ -4,11 +4,15 @@
 
 #include "Vulkan.h"
 
+#include <memory>
 #include <mutex>
 
 namespace ae
 {
 	class DeviceFeatures;
+	class VulkanDeletionQueue;
+	class VulkanShaderRegistry;
+	class VulkanUploadManager;
 
 	class VulkanManager
 	{
@@ -31,24 +35,72 @@ namespace ae
 		void AddSurface(VkSurfaceKHR surface);
 		void RemoveSurface(VkSurfaceKHR surface);
 
+		// Headless contexts keep the device alive like a surface does, but place no present requirement on it
+		void AddHeadlessTarget();
+		void RemoveHeadlessTarget();
+
 		void RequestDeviceFeatures(DeviceFeatures features);
 
-		// Externally-synchronized graphics-queue access. All submitters (app-lib's frame submit/
-		// present, ImGui single-time uploads, and the engine via Window) must route through these
-		// so the single VkQueue is never touched concurrently.
-		VkResult SubmitToQueue(const VkSubmitInfo& submitInfo, VkFence fence);
+		// Externally-synchronized queue access. All submitters (app-lib's frame submit/present, uploads,
+		// ImGui single-time uploads, and the engine via Window) must route through these. Each distinct
+		// VkQueue has its own lock, so only queue types that alias the same VkQueue contend.
+		VkResult SubmitToQueue(VulkanQueueType type, const VkSubmitInfo& submitInfo, VkFence fence);
+		void WaitQueueIdle(VulkanQueueType type);
+
+		inline VkResult SubmitToQueue(const VkSubmitInfo& submitInfo, VkFence fence) { return SubmitToQueue(VulkanQueueType::GRAPHICS, submitInfo, fence); }
+		inline void WaitQueueIdle() { WaitQueueIdle(VulkanQueueType::GRAPHICS); }
+
+		// vkQueueSubmit2, only available with DeviceFeature::Synchronization2
+		VkResult SubmitToQueue2(VulkanQueueType type, const VkSubmitInfo2& submitInfo, VkFence fence);
+		inline bool IsSynchronization2Enabled() const { return m_pfnQueueSubmit2 != nullptr; }
+
 		VkResult PresentToQueue(const VkPresentInfoKHR& presentInfo);
-		void WaitQueueIdle();
+
+		// Command entry points of VK_KHR_dynamic_rendering and VK_KHR_synchronization2, only loaded with
+		// DeviceFeature::DynamicRendering and DeviceFeature::Synchronization2 respectively
+		inline void CmdBeginRendering(VkCommandBuffer commandBuffer, const VkRenderingInfo& renderingInfo) const { m_pfnCmdBeginRendering(commandBuffer, &renderingInfo); }
+		inline void CmdEndRendering(VkCommandBuffer commandBuffer) const { m_pfnCmdEndRendering(commandBuffer); }
+		inline void CmdPipelineBarrier2(VkCommandBuffer commandBuffer, const VkDependencyInfo& dependencyInfo) const { m_pfnCmdPipelineBarrier2(commandBuffer, &dependencyInfo); }
+		inline bool IsDynamicRenderingEnabled() const { return m_pfnCmdBeginRendering != nullptr; }
+
+		// VK_KHR_present_wait, only available with DeviceFeature::PresentWait. Does not touch the queue, so no lock.
+		VkResult WaitForPresent(VkSwapchainKHR swapChain, uint64_t presentId, uint64_t timeout);
+		inline bool IsPresentWaitEnabled() const { return m_pfnWaitForPresent != nullptr; }
+
+		// Created on first use, since the staging ring is only worth its memory for apps that upload
+		VulkanUploadManager& GetUploadManager();
+		inline VulkanUploadManager* FindUploadManager() const { return m_pUploadManager.get(); }
+
+		// Created on first use as well; destroyed with the device, which takes its modules with it
+		VulkanShaderRegistry& GetShaderRegistry();
+		inline VulkanShaderRegistry* FindShaderRegistry() const { return m_pShaderRegistry.get(); }
+
+		// Created with the first context, which registers as one of its sources
+		VulkanDeletionQueue& GetDeletionQueue();
+		inline VulkanDeletionQueue* FindDeletionQueue() const { return m_pDeletionQueue.get(); }
+
+		// The pipeline cache is device-wide and persisted between runs. It is loaded when the device is
+		// created and written back (atomically, via a temporary file) when the device is destroyed.
+		void SetPipelineCachePath(const std::string& path);
+		void SavePipelineCache();
 
 		inline const std::string& GetVersion() const { return m_Version; }
 		inline const std::string& GetRenderer() const { return m_Renderer; }
 		inline const std::string& GetVendor() const { return m_Vendor; }
 
 		inline VkInstance GetInstance() const { return m_VulkanInstance; }
+		inline bool IsSurfaceSupported() const { return m_SurfaceSupported; }
 		inline VkPhysicalDevice GetPhysicalDevice() const { return m_PhysicalDevice; }	
 		inline VkDevice GetDevice() const { return m_Device; }
-		inline VkQueue GetGraphicsQueue() const { return m_GraphicsQueue; }
-		inline uint32_t GetGraphicsQueueFamilyIndex() const { return m_GraphicsQueueFamilyIndex; }
+		inline VkQueue GetQueue(VulkanQueueType type) const { return m_Queues[static_cast<size_t>(type)].queue; }
+		inline uint32_t GetQueueFamilyIndex(VulkanQueueType type) const { return m_Queues[static_cast<size_t>(type)].familyIndex; }
+		inline bool IsQueueAliased(VulkanQueueType a, VulkanQueueType b) const { return GetQueue(a) == GetQueue(b); }
+		inline VkQueue GetGraphicsQueue() const { return GetQueue(VulkanQueueType::GRAPHICS); }
+		inline uint32_t GetGraphicsQueueFamilyIndex() const { return GetQueueFamilyIndex(VulkanQueueType::GRAPHICS); }
+		inline bool IsTimelineSemaphoreEnabled() const { return m_TimelineSemaphoreEnabled; }
+		inline VkPipelineCache GetPipelineCache() const { return m_PipelineCache; }
+		inline bool IsPipelineCacheWarm() const { return m_PipelineCacheWarm; }
+		inline VmaAllocator GetAllocator() const { return m_Allocator; }
 	private:
 		void CreateInstance(const std::string& name);
 		void DestroyInstance();
@@ -63,8 +115,15 @@ namespace ae
 		void CreateLogicalDevice();
 		void DestroyLogicalDevice();
 
-		void SetGraphicsQueue();
-		void ResetGraphicsQueue();
+		void SelectQueues();
+		void SetQueues();
+		void ResetQueues();
+
+		void CreatePipelineCache();
+		void DestroyPipelineCache();
+
+		void CreateAllocator();
+		void DestroyAllocator();
 
 		std::vector<const char*> GetRequiredExtensions();
 		bool IsValidationLayersSupported();
@@ -84,12 +143,47 @@ namespace ae
 
 		VkInstance m_VulkanInstance;
 		std::vector<VkSurfaceKHR> m_Surfaces;
+		uint32_t m_HeadlessTargetCount = 0;
+		// False when GLFW found no Vulkan-capable platform, in which case the instance has no surface
+		// extensions and the device is created without VK_KHR_swapchain
+		bool m_SurfaceSupported = false;
 		VkPhysicalDevice m_PhysicalDevice;
 		VkDevice m_Device;
 
-		VkQueue m_GraphicsQueue;
-		uint32_t m_GraphicsQueueFamilyIndex;
-		std::mutex m_QueueMutex;
+		struct QueueSlot
+		{
+			VkQueue queue = VK_NULL_HANDLE;
+			uint32_t familyIndex = 0;
+			uint32_t queueIndex = 0;
+			// Index of the slot whose mutex guards this queue; differs from the slot itself when aliased
+			uint32_t lockIndex = 0;
+		};
+
+		std::array<QueueSlot, static_cast<size_t>(VulkanQueueType::COUNT)> m_Queues;
+		std::array<std::mutex, static_cast<size_t>(VulkanQueueType::COUNT)> m_QueueMutexes;
+
+		bool m_TimelineSemaphoreEnabled = false;
+		PFN_vkWaitForPresentKHR m_pfnWaitForPresent = nullptr;
+		PFN_vkQueueSubmit2KHR m_pfnQueueSubmit2 = nullptr;
+		PFN_vkCmdPipelineBarrier2KHR m_pfnCmdPipelineBarrier2 = nullptr;
+		PFN_vkCmdBeginRenderingKHR m_pfnCmdBeginRendering = nullptr;
+		PFN_vkCmdEndRenderingKHR m_pfnCmdEndRendering = nullptr;
+
+		std::unique_ptr<VulkanUploadManager> m_pUploadManager;
+		std::mutex m_UploadManagerMutex;
+
+		std::unique_ptr<VulkanShaderRegistry> m_pShaderRegistry;
+		std::mutex m_ShaderRegistryMutex;
+
+		std::unique_ptr<VulkanDeletionQueue> m_pDeletionQueue;
+		std::mutex m_DeletionQueueMutex;
+
+		VkPipelineCache m_PipelineCache;
+		std::string m_PipelineCachePath = "cache/vulkan_pipeline_cache.bin";
+		bool m_PipelineCacheWarm = false;
+
+		VmaAllocator m_Allocator;
+		bool m_MemoryBudgetEnabled = false;
 
 		uint64_t m_RequestedFeatures = 0;
 	private:
@@ -100,6 +194,8 @@ namespace ae
 #endif // AE_DEBUG
 
 		static constexpr std::array<const char*, 1> s_DeviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+
+		static constexpr VkDeviceSize s_UploadStagingSize = 64ull * 1024 * 1024;
 	};
 }
 
@@ -0,0 +1,288 @@
+#include "general/pch.h"
+
+#ifdef AE_VULKAN
+
+#include "Files.h"
+#include "VulkanManager.h"
+#include "VulkanShaderRegistry.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace
+{
+
+constexpr uint32_t s_SpirvMagic = 0x07230203;
+constexpr size_t s_SpirvHeaderSize = 5 * sizeof(uint32_t);
+
+// FNV-1a over whole SPIR-V words, which are always four-byte aligned
+uint64_t HashSpirv(std::span<const uint8_t> code)
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    for (size_t i = 0; i < code.size(); i += sizeof(uint32_t))
+    {
+        uint32_t word;
+        std::memcpy(&word, code.data() + i, sizeof(uint32_t));
+
+        hash ^= word;
+        hash *= 1099511628211ull;
+    }
+
+    return hash ^ code.size();
+}
+
+// Second hash for telling apart code whose FNV-1a hashes collide; a multiply-rotate mix shares no structure with it
+uint64_t CheckHashSpirv(std::span<const uint8_t> code)
+{
+    uint64_t hash = 0x9E3779B97F4A7C15ull;
+
+    for (size_t i = 0; i < code.size(); i += sizeof(uint32_t))
+    {
+        uint32_t word;
+        std::memcpy(&word, code.data() + i, sizeof(uint32_t));
+
+        hash = std::rotl((hash ^ word) * 0xC2B2AE3D27D4EB4Full, 31) * 0x165667B19E3779F9ull;
+    }
+
+    return hash;
+}
+
+} // namespace
+
+ae::VulkanShaderRegistry::VulkanShaderRegistry()
+{
+    m_PollTimer.Start();
+}
+
+ae::VulkanShaderRegistry::~VulkanShaderRegistry()
+{
+    for (auto &[key, module] : m_Modules)
+    {
+        vkDestroyShaderModule(VulkanManager::Get().GetDevice(), module.module, nullptr);
+    }
+}
+
+VkShaderModule ae::VulkanShaderRegistry::Acquire(const std::string &path)
+{
+    std::scoped_lock lock(m_Mutex);
+
+    auto it = m_Sources.find(path);
+
+    if (it != m_Sources.end())
+    {
+        it->second.refCount++;
+        return m_Modules.at(it->second.key).module;
+    }
+
+    // Taken before loading, so a write that lands while the file is mapped is still seen by the next poll
+    std::error_code ec;
+    std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(AE_FILE_PATH(path), ec);
+
+    BinaryFile file(path);
+    file.Map();
+
+    uint64_t key = Load(path, file.GetView());
+    m_Sources.emplace(path, Source{ .key = key, .writeTime = writeTime, .refCount = 1 });
+
+    return m_Modules.at(key).module;
+}
+
+void ae::VulkanShaderRegistry::Release(const std::string &path)
+{
+    std::scoped_lock lock(m_Mutex);
+
+    auto it = m_Sources.find(path);
+
+    if (it == m_Sources.end())
+    {
+        AE_LOG(AE_WARNING, "Tried to release shader '{}' which was not acquired", path);
+        return;
+    }
+
+    if (--it->second.refCount == 0)
+    {
+        ReleaseModule(it->second.key);
+        m_Sources.erase(it);
+    }
+}
+
+uint64_t ae::VulkanShaderRegistry::AddListener(Listener listener)
+{
+    std::scoped_lock lock(m_Mutex);
+
+    uint64_t id = m_NextListenerId++;
+    m_Listeners.emplace_back(id, std::move(listener));
+
+    return id;
+}
+
+void ae::VulkanShaderRegistry::RemoveListener(uint64_t id)
+{
+    std::scoped_lock lock(m_Mutex);
+
+    std::erase_if(m_Listeners, [id](const auto &entry) { return entry.first == id; });
+}
+
+void ae::VulkanShaderRegistry::Poll()
+{
+#ifndef AE_DIST
+    std::vector<std::pair<std::string, VkShaderModule>> changed;
+    std::vector<uint64_t> replaced;
+    std::vector<Listener> listeners;
+
+    {
+        std::scoped_lock lock(m_Mutex);
+
+        double now = m_PollTimer.GetElapsedTime();
+
+        if (now - m_LastPollTime < s_PollInterval)
+        {
+            return;
+        }
+
+        m_LastPollTime = now;
+
+        for (auto &[path, source] : m_Sources)
+        {
+            // Editors and compilers often replace the file, so it can briefly be missing
+            std::error_code ec;
+            std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(AE_FILE_PATH(path), ec);
+
+            if (ec || writeTime == source.writeTime)
+            {
+                continue;
+            }
+
+            uint64_t key = 0;
+
+            try
+            {
+                // Read, not mapped: touching a mapped page past the end of a file that is being truncated
+                // raises SIGBUS
+                BinaryFile file(path);
+                file.Read();
+
+                std::span<const uint8_t> code = file.GetView();
+
+                // Still being written; the old timestamp is kept so the next poll tries again
+                if (code.empty() || code.size() % sizeof(uint32_t) != 0)
+                {
+                    continue;
+                }
+
+                source.writeTime = writeTime;
+                key = Load(path, code);
+            }
+            catch (const std::exception &e)
+            {
+                source.writeTime = writeTime;
+
+                AE_LOG(AE_WARNING, "Failed to reload shader '{}', keeping the previous module: {}", path, e.what());
+                continue;
+            }
+
+            // Same code under a new timestamp: drop the reference Load took and leave every pipeline alone
+            if (key == source.key)
+            {
+                ReleaseModule(key);
+                continue;
+            }
+
+            // Kept until the listeners have swapped their pipelines over
+            replaced.push_back(source.key);
+            source.key = key;
+
+            changed.emplace_back(path, m_Modules.at(key).module);
+        }
+
+        if (changed.empty())
+        {
+            return;
+        }
+
+        listeners.reserve(m_Listeners.size());
+
+        for (const auto &[id, listener] : m_Listeners)
+        {
+            listeners.push_back(listener);
+        }
+    }
+
+    for (const auto &[path, module] : changed)
+    {
+        AE_LOG(AE_TRACE, "Shader '{}' changed, reloaded its module", path);
+
+        for (const Listener &listener : listeners)
+        {
+            listener(path, module);
+        }
+    }
+
+    std::scoped_lock lock(m_Mutex);
+
+    for (uint64_t key : replaced)
+    {
+        ReleaseModule(key);
+    }
+#endif // AE_DIST
+}
+
+uint64_t ae::VulkanShaderRegistry::Load(const std::string &path, std::span<const uint8_t> code)
+{
+    uint32_t magic = 0;
+
+    if (code.size() >= s_SpirvHeaderSize)
+    {
+        std::memcpy(&magic, code.data(), sizeof(uint32_t));
+    }
+
+    if (magic != s_SpirvMagic || code.size() % sizeof(uint32_t) != 0)
+    {
+        AE_THROW_RUNTIME_ERROR("Shader '{}' is not a SPIR-V binary", path);
+    }
+
+    uint64_t key = HashSpirv(code);
+    uint64_t checkHash = CheckHashSpirv(code);
+
+    // Probes past modules that share the hash but not the code
+    for (auto it = m_Modules.find(key); it != m_Modules.end(); it = m_Modules.find(++key))
+    {
+        if (it->second.checkHash == checkHash && it->second.codeSize == code.size())
+        {
+            it->second.sourceCount++;
+            return key;
+        }
+    }
+
+    VkShaderModuleCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    createInfo.codeSize = code.size();
+    // Mappings are page-aligned and read buffers come from operator new, so the code can be handed over in place
+    createInfo.pCode = reinterpret_cast<const uint32_t *>(code.data());
+
+    VkShaderModule module = VK_NULL_HANDLE;
+
+    if (vkCreateShaderModule(VulkanManager::Get().GetDevice(), &createInfo, nullptr, &module) != VK_SUCCESS)
+    {
+        AE_THROW_RUNTIME_ERROR("Failed to create shader module for '{}'", path);
+    }
+
+    m_Modules.emplace(key,
+                      Module{ .module = module, .sourceCount = 1, .checkHash = checkHash, .codeSize = code.size() });
+
+    return key;
+}
+
+void ae::VulkanShaderRegistry::ReleaseModule(uint64_t key)
+{
+    auto it = m_Modules.find(key);
+
+    if (--it->second.sourceCount == 0)
+    {
+        vkDestroyShaderModule(VulkanManager::Get().GetDevice(), it->second.module, nullptr);
+        m_Modules.erase(it);
+    }
+}
+
+#endif // AE_VULKAN
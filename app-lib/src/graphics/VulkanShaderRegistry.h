@@ -0,0 +1,88 @@
+#pragma once
+
+#ifdef AE_VULKAN
+
+#include "Vulkan.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ae
+{
+	// Device-wide shader modules created from SPIR-V files. Files are memory-mapped when first acquired, and modules
+	// are keyed by a hash of their SPIR-V (checked against a second, independent hash and the size, so no copy of the
+	// code is kept), so the same code loaded through several paths or by several windows shares one VkShaderModule.
+	// Every Acquire of a path must be balanced by a Release; a module is destroyed once no path refers to it, which is
+	// safe for pipelines already created from it.
+	//
+	// Outside Dist builds the files are polled for changes. Changed files are read rather than mapped, since a compiler
+	// may still be truncating and rewriting them, and one that is empty or cut mid-word is tried again on the next
+	// poll. Only a file whose SPIR-V changed gets a new module and is reported to the listeners, which should rebuild
+	// the pipelines using it; a file that was merely touched or rewritten with the same code keeps its module and
+	// invalidates nothing. The replaced module is released only after the listeners have run. The registry does not
+	// build pipelines itself, so the pipeline cache only helps if the listeners pass the one from VulkanResources.
+	class VulkanShaderRegistry
+	{
+	public:
+		using Listener = std::function<void(const std::string&, VkShaderModule)>;
+
+		VulkanShaderRegistry();
+		VulkanShaderRegistry(const VulkanShaderRegistry&) = delete;
+		VulkanShaderRegistry& operator=(const VulkanShaderRegistry&) = delete;
+		~VulkanShaderRegistry();
+
+		// Thread-safe. The module stays valid until the path is released or the listeners have been handed its
+		// replacement.
+		VkShaderModule Acquire(const std::string& path);
+		void Release(const std::string& path);
+
+		// Listeners are called on the thread that polls, without the registry locked
+		uint64_t AddListener(Listener listener);
+		void RemoveListener(uint64_t id);
+
+		// Checks the files at most every s_PollInterval seconds; called from BeginFrame
+		void Poll();
+	private:
+		struct Module
+		{
+			VkShaderModule module = VK_NULL_HANDLE;
+			uint32_t sourceCount = 0; // Paths whose current code this is
+			// Compared on a hit of the key's hash, so a collision of one hash alone never hands out the wrong module
+			uint64_t checkHash = 0;
+			size_t codeSize = 0;
+		};
+
+		struct Source
+		{
+			uint64_t key = 0;
+			std::filesystem::file_time_type writeTime;
+			uint32_t refCount = 0;
+		};
+
+		// Takes a source reference on the module for the code, creating it if needed, and returns its key: the hash of
+		// the code, or the next free key past it should a different module already hold the hash
+		uint64_t Load(const std::string& path, std::span<const uint8_t> code);
+		void ReleaseModule(uint64_t key);
+	private:
+		std::mutex m_Mutex;
+		std::unordered_map<uint64_t, Module> m_Modules;
+		std::unordered_map<std::string, Source> m_Sources;
+
+		std::vector<std::pair<uint64_t, Listener>> m_Listeners;
+		uint64_t m_NextListenerId = 1;
+
+		ae::Timer m_PollTimer;
+		double m_LastPollTime = 0.0;
+	private:
+		static constexpr double s_PollInterval = 0.5;
+	};
+}
+
+#endif // AE_VULKAN
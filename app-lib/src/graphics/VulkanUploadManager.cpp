@@ -0,0 +1,592 @@
+#include "general/pch.h"
+
+#ifdef AE_VULKAN
+
+#include "VulkanManager.h"
+#include "VulkanUploadManager.h"
+
+#include <algorithm>
+
+namespace
+{
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+ae::VulkanUploadManager::VulkanUploadManager(VkDeviceSize stagingSize)
+    : m_GraphicsFamily(VulkanManager::Get().GetGraphicsQueueFamilyIndex()),
+      m_TransferFamily(VulkanManager::Get().GetQueueFamilyIndex(VulkanQueueType::TRANSFER)), m_Alignment(16),
+      m_StagingBuffer(VK_NULL_HANDLE), m_StagingAllocation(VK_NULL_HANDLE), m_pStagingData(nullptr),
+      m_StagingSize(stagingSize), m_TransferCommandPool(VK_NULL_HANDLE), m_AcquireCommandPool(VK_NULL_HANDLE),
+      m_TimelineSemaphore(VK_NULL_HANDLE)
+{
+    if (!VulkanManager::Get().IsTimelineSemaphoreEnabled())
+    {
+        AE_THROW_RUNTIME_ERROR("The Vulkan upload manager requires timeline semaphores (Vulkan 1.2)");
+    }
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(VulkanManager::Get().GetPhysicalDevice(), &properties);
+
+    // Offsets must satisfy both the preferred copy alignment and the texel size of common formats
+    m_Alignment = std::max<VkDeviceSize>(m_Alignment, properties.limits.optimalBufferCopyOffsetAlignment);
+    m_StagingSize = AlignUp(m_StagingSize, m_Alignment);
+
+    CreateStagingBuffer();
+    CreateCommandObjects();
+    CreateTimelineSemaphore();
+}
+
+ae::VulkanUploadManager::~VulkanUploadManager()
+{
+    Wait(Flush());
+
+    {
+        std::scoped_lock lock(m_Mutex);
+
+        while (m_RetiredBatches < m_SubmittedBatches)
+        {
+            RetireOldestBatch();
+        }
+    }
+
+    DestroyTimelineSemaphore();
+    DestroyCommandObjects();
+    DestroyStagingBuffer();
+}
+
+void ae::VulkanUploadManager::UploadBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void *pData,
+                                           VkDeviceSize size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+    std::scoped_lock lock(m_Mutex);
+
+    StagingAllocation staging = AllocateStaging(size);
+    std::memcpy(staging.pMapped, pData, size);
+
+    Batch &batch = GetRecordingBatch();
+
+    if (staging.dedicatedAllocation != VK_NULL_HANDLE)
+    {
+        batch.dedicatedStaging.emplace_back(staging.buffer, staging.dedicatedAllocation);
+    }
+
+    VkBufferCopy region{};
+    region.srcOffset = staging.offset;
+    region.dstOffset = dstOffset;
+    region.size = size;
+
+    vkCmdCopyBuffer(batch.transferCommandBuffer, staging.buffer, dstBuffer, 1, &region);
+
+    if (m_TransferFamily != m_GraphicsFamily)
+    {
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = m_TransferFamily;
+        barrier.dstQueueFamilyIndex = m_GraphicsFamily;
+        barrier.buffer = dstBuffer;
+        barrier.offset = dstOffset;
+        barrier.size = size;
+
+        batch.bufferBarriers.push_back(barrier);
+    }
+}
+
+void ae::VulkanUploadManager::UploadImage(VkImage dstImage, VkExtent3D extent, const void *pData, VkDeviceSize size,
+                                          VkImageLayout finalLayout)
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+    std::scoped_lock lock(m_Mutex);
+
+    StagingAllocation staging = AllocateStaging(size);
+    std::memcpy(staging.pMapped, pData, size);
+
+    Batch &batch = GetRecordingBatch();
+
+    if (staging.dedicatedAllocation != VK_NULL_HANDLE)
+    {
+        batch.dedicatedStaging.emplace_back(staging.buffer, staging.dedicatedAllocation);
+    }
+
+    VkImageMemoryBarrier toTransfer{};
+    toTransfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    toTransfer.srcAccessMask = 0;
+    toTransfer.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    toTransfer.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    toTransfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    toTransfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransfer.image = dstImage;
+    toTransfer.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    toTransfer.subresourceRange.baseMipLevel = 0;
+    toTransfer.subresourceRange.levelCount = 1;
+    toTransfer.subresourceRange.baseArrayLayer = 0;
+    toTransfer.subresourceRange.layerCount = 1;
+
+    vkCmdPipelineBarrier(batch.transferCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &toTransfer);
+
+    VkBufferImageCopy region{};
+    region.bufferOffset = staging.offset;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = { .x = 0, .y = 0, .z = 0 };
+    region.imageExtent = extent;
+
+    vkCmdCopyBufferToImage(batch.transferCommandBuffer, staging.buffer, dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           1, &region);
+
+    // The transition to the final layout is recorded once per batch, together with any ownership transfer
+    VkImageMemoryBarrier toFinal = toTransfer;
+    toFinal.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    toFinal.newLayout = finalLayout;
+
+    if (m_TransferFamily != m_GraphicsFamily)
+    {
+        toFinal.srcQueueFamilyIndex = m_TransferFamily;
+        toFinal.dstQueueFamilyIndex = m_GraphicsFamily;
+    }
+
+    batch.imageBarriers.push_back(toFinal);
+}
+
+uint64_t ae::VulkanUploadManager::Flush()
+{
+    std::scoped_lock lock(m_Mutex);
+
+    Batch &batch = m_Batches[m_SubmittedBatches % s_BatchCount];
+
+    if (batch.recording)
+    {
+        SubmitBatch(batch);
+    }
+
+    return m_SubmittedValue;
+}
+
+bool ae::VulkanUploadManager::IsComplete(uint64_t value) const
+{
+    uint64_t completed = 0;
+    vkGetSemaphoreCounterValue(VulkanManager::Get().GetDevice(), m_TimelineSemaphore, &completed);
+
+    return completed >= value;
+}
+
+void ae::VulkanUploadManager::Wait(uint64_t value) const
+{
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &m_TimelineSemaphore;
+    waitInfo.pValues = &value;
+
+    VK_CHECK(vkWaitSemaphores(VulkanManager::Get().GetDevice(), &waitInfo, UINT64_MAX));
+}
+
+ae::VulkanUploadManager::StagingAllocation ae::VulkanUploadManager::AllocateStaging(VkDeviceSize size)
+{
+    // Uploads larger than the whole ring get a temporary buffer that is freed with their batch
+    if (size > m_StagingSize)
+    {
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VmaAllocationCreateInfo allocationInfo{};
+        allocationInfo.usage = VMA_MEMORY_USAGE_AUTO;
+        allocationInfo.flags =
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        StagingAllocation staging{};
+        VmaAllocationInfo info;
+
+        VK_CHECK(VulkanCreateBuffer(VulkanManager::Get().GetAllocator(), bufferInfo, allocationInfo,
+                                    VulkanMemoryCategory::STAGING, &staging.buffer, &staging.dedicatedAllocation,
+                                    &info));
+
+        staging.offset = 0;
+        staging.pMapped = static_cast<uint8_t *>(info.pMappedData);
+
+        return staging;
+    }
+
+    while (true)
+    {
+        uint64_t position = AlignUp(m_RingHead, m_Alignment);
+        uint64_t offset = position % m_StagingSize;
+
+        // A copy source may not wrap around, skip the remainder of the ring instead
+        if (offset + size > m_StagingSize)
+        {
+            position += m_StagingSize - offset;
+            offset = 0;
+        }
+
+        if (position + size - m_RingTail <= m_StagingSize)
+        {
+            m_RingHead = position + size;
+
+            return { .buffer = m_StagingBuffer,
+                     .offset = offset,
+                     .pMapped = m_pStagingData + offset,
+                     .dedicatedAllocation = VK_NULL_HANDLE };
+        }
+
+        if (RetireCompletedBatches())
+        {
+            continue;
+        }
+
+        if (m_RetiredBatches < m_SubmittedBatches)
+        {
+            RetireOldestBatch();
+            continue;
+        }
+
+        Batch &recording = m_Batches[m_SubmittedBatches % s_BatchCount];
+
+        // Only the batch being recorded holds ring memory, it has to be submitted to make room
+        if (recording.recording)
+        {
+            SubmitBatch(recording);
+            continue;
+        }
+
+        // The ring is empty, restart it at offset zero so the allocation does not need to skip
+        m_RingHead += (m_StagingSize - m_RingHead % m_StagingSize) % m_StagingSize;
+        m_RingTail = m_RingHead;
+    }
+}
+
+ae::VulkanUploadManager::Batch &ae::VulkanUploadManager::GetRecordingBatch()
+{
+    if (m_SubmittedBatches - m_RetiredBatches == s_BatchCount)
+    {
+        RetireOldestBatch();
+    }
+
+    Batch &batch = m_Batches[m_SubmittedBatches % s_BatchCount];
+
+    if (batch.recording)
+    {
+        return batch;
+    }
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    VK_CHECK(vkResetCommandBuffer(batch.transferCommandBuffer, 0));
+    VK_CHECK(vkBeginCommandBuffer(batch.transferCommandBuffer, &beginInfo));
+
+    batch.recording = true;
+
+    return batch;
+}
+
+void ae::VulkanUploadManager::SubmitBatch(Batch &batch)
+{
+    bool ownershipTransfer = m_TransferFamily != m_GraphicsFamily;
+
+    for (auto &barrier : batch.bufferBarriers)
+    {
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+    }
+
+    for (auto &barrier : batch.imageBarriers)
+    {
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = ownershipTransfer ? 0 : VK_ACCESS_MEMORY_READ_BIT;
+    }
+
+    if (!batch.bufferBarriers.empty() || !batch.imageBarriers.empty())
+    {
+        // Release half of the ownership transfer, or the final layout transition on a shared family
+        VkPipelineStageFlags dstStage =
+            ownershipTransfer ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+        vkCmdPipelineBarrier(batch.transferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStage, 0, 0, nullptr,
+                             static_cast<uint32_t>(batch.bufferBarriers.size()), batch.bufferBarriers.data(),
+                             static_cast<uint32_t>(batch.imageBarriers.size()), batch.imageBarriers.data());
+    }
+
+    VK_CHECK(vkEndCommandBuffer(batch.transferCommandBuffer));
+
+    uint64_t transferValue = ++m_SubmittedValue;
+
+    VkTimelineSemaphoreSubmitInfo transferTimeline{};
+    transferTimeline.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    transferTimeline.signalSemaphoreValueCount = 1;
+    transferTimeline.pSignalSemaphoreValues = &transferValue;
+
+    VkSubmitInfo transferSubmit{};
+    transferSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    transferSubmit.pNext = &transferTimeline;
+    transferSubmit.commandBufferCount = 1;
+    transferSubmit.pCommandBuffers = &batch.transferCommandBuffer;
+    transferSubmit.signalSemaphoreCount = 1;
+    transferSubmit.pSignalSemaphores = &m_TimelineSemaphore;
+
+    if (VulkanManager::Get().SubmitToQueue(VulkanQueueType::TRANSFER, transferSubmit, VK_NULL_HANDLE) !=
+        VK_SUCCESS)
+    {
+        AE_THROW_RUNTIME_ERROR("Failed to submit Vulkan upload batch");
+    }
+
+    if (ownershipTransfer && (!batch.bufferBarriers.empty() || !batch.imageBarriers.empty()))
+    {
+        for (auto &barrier : batch.bufferBarriers)
+        {
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+        }
+
+        for (auto &barrier : batch.imageBarriers)
+        {
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+        }
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        VK_CHECK(vkResetCommandBuffer(batch.acquireCommandBuffer, 0));
+        VK_CHECK(vkBeginCommandBuffer(batch.acquireCommandBuffer, &beginInfo));
+
+        vkCmdPipelineBarrier(batch.acquireCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                             VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr,
+                             static_cast<uint32_t>(batch.bufferBarriers.size()), batch.bufferBarriers.data(),
+                             static_cast<uint32_t>(batch.imageBarriers.size()), batch.imageBarriers.data());
+
+        VK_CHECK(vkEndCommandBuffer(batch.acquireCommandBuffer));
+
+        uint64_t acquireValue = ++m_SubmittedValue;
+        VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+        VkTimelineSemaphoreSubmitInfo acquireTimeline{};
+        acquireTimeline.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        acquireTimeline.waitSemaphoreValueCount = 1;
+        acquireTimeline.pWaitSemaphoreValues = &transferValue;
+        acquireTimeline.signalSemaphoreValueCount = 1;
+        acquireTimeline.pSignalSemaphoreValues = &acquireValue;
+
+        VkSubmitInfo acquireSubmit{};
+        acquireSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        acquireSubmit.pNext = &acquireTimeline;
+        acquireSubmit.waitSemaphoreCount = 1;
+        acquireSubmit.pWaitSemaphores = &m_TimelineSemaphore;
+        acquireSubmit.pWaitDstStageMask = &waitStage;
+        acquireSubmit.commandBufferCount = 1;
+        acquireSubmit.pCommandBuffers = &batch.acquireCommandBuffer;
+        acquireSubmit.signalSemaphoreCount = 1;
+        acquireSubmit.pSignalSemaphores = &m_TimelineSemaphore;
+
+        if (VulkanManager::Get().SubmitToQueue(VulkanQueueType::GRAPHICS, acquireSubmit, VK_NULL_HANDLE) !=
+            VK_SUCCESS)
+        {
+            AE_THROW_RUNTIME_ERROR("Failed to submit Vulkan upload ownership acquire");
+        }
+    }
+
+    batch.stagingEnd = m_RingHead;
+    batch.completionValue = m_SubmittedValue;
+    batch.recording = false;
+
+    m_SubmittedBatches++;
+}
+
+bool ae::VulkanUploadManager::RetireCompletedBatches()
+{
+    bool retired = false;
+
+    uint64_t completed = 0;
+    vkGetSemaphoreCounterValue(VulkanManager::Get().GetDevice(), m_TimelineSemaphore, &completed);
+
+    while (m_RetiredBatches < m_SubmittedBatches)
+    {
+        Batch &batch = m_Batches[m_RetiredBatches % s_BatchCount];
+
+        if (batch.completionValue > completed)
+        {
+            break;
+        }
+
+        RetireBatch(batch);
+        retired = true;
+    }
+
+    return retired;
+}
+
+void ae::VulkanUploadManager::RetireOldestBatch()
+{
+    Batch &batch = m_Batches[m_RetiredBatches % s_BatchCount];
+
+    Wait(batch.completionValue);
+    RetireBatch(batch);
+}
+
+void ae::VulkanUploadManager::RetireBatch(Batch &batch)
+{
+    for (const auto &[buffer, allocation] : batch.dedicatedStaging)
+    {
+        VulkanDestroyBuffer(VulkanManager::Get().GetAllocator(), buffer, allocation);
+    }
+
+    batch.dedicatedStaging.clear();
+    batch.bufferBarriers.clear();
+    batch.imageBarriers.clear();
+
+    m_RingTail = batch.stagingEnd;
+    m_RetiredBatches++;
+}
+
+void ae::VulkanUploadManager::CreateStagingBuffer()
+{
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = m_StagingSize;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo allocationInfo{};
+    allocationInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    allocationInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    VmaAllocationInfo info;
+
+    if (VulkanCreateBuffer(VulkanManager::Get().GetAllocator(), bufferInfo, allocationInfo,
+                           VulkanMemoryCategory::STAGING, &m_StagingBuffer, &m_StagingAllocation,
+                           &info) != VK_SUCCESS)
+    {
+        AE_THROW_RUNTIME_ERROR("Failed to create Vulkan staging ring buffer");
+    }
+
+    m_pStagingData = static_cast<uint8_t *>(info.pMappedData);
+}
+
+void ae::VulkanUploadManager::DestroyStagingBuffer()
+{
+    VulkanDestroyBuffer(VulkanManager::Get().GetAllocator(), m_StagingBuffer, m_StagingAllocation);
+
+    m_StagingBuffer = VK_NULL_HANDLE;
+    m_StagingAllocation = VK_NULL_HANDLE;
+    m_pStagingData = nullptr;
+}
+
+void ae::VulkanUploadManager::CreateCommandObjects()
+{
+    VkDevice device = VulkanManager::Get().GetDevice();
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = m_TransferFamily;
+
+    if (vkCreateCommandPool(device, &poolInfo, nullptr, &m_TransferCommandPool) != VK_SUCCESS)
+    {
+        AE_THROW_RUNTIME_ERROR("Failed to create Vulkan upload command pool");
+    }
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+
+    for (auto &batch : m_Batches)
+    {
+        allocInfo.commandPool = m_TransferCommandPool;
+
+        if (vkAllocateCommandBuffers(device, &allocInfo, &batch.transferCommandBuffer) != VK_SUCCESS)
+        {
+            AE_THROW_RUNTIME_ERROR("Failed to allocate Vulkan upload command buffers");
+        }
+    }
+
+    if (m_TransferFamily == m_GraphicsFamily)
+    {
+        return;
+    }
+
+    poolInfo.queueFamilyIndex = m_GraphicsFamily;
+
+    if (vkCreateCommandPool(device, &poolInfo, nullptr, &m_AcquireCommandPool) != VK_SUCCESS)
+    {
+        AE_THROW_RUNTIME_ERROR("Failed to create Vulkan upload acquire command pool");
+    }
+
+    for (auto &batch : m_Batches)
+    {
+        allocInfo.commandPool = m_AcquireCommandPool;
+
+        if (vkAllocateCommandBuffers(device, &allocInfo, &batch.acquireCommandBuffer) != VK_SUCCESS)
+        {
+            AE_THROW_RUNTIME_ERROR("Failed to allocate Vulkan upload acquire command buffers");
+        }
+    }
+}
+
+void ae::VulkanUploadManager::DestroyCommandObjects()
+{
+    VkDevice device = VulkanManager::Get().GetDevice();
+
+    // Destroying the pools frees the command buffers allocated from them
+    vkDestroyCommandPool(device, m_AcquireCommandPool, nullptr);
+    vkDestroyCommandPool(device, m_TransferCommandPool, nullptr);
+
+    m_AcquireCommandPool = VK_NULL_HANDLE;
+    m_TransferCommandPool = VK_NULL_HANDLE;
+
+    for (auto &batch : m_Batches)
+    {
+        batch.transferCommandBuffer = VK_NULL_HANDLE;
+        batch.acquireCommandBuffer = VK_NULL_HANDLE;
+    }
+}
+
+void ae::VulkanUploadManager::CreateTimelineSemaphore()
+{
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+
+    if (vkCreateSemaphore(VulkanManager::Get().GetDevice(), &semaphoreInfo, nullptr, &m_TimelineSemaphore) !=
+        VK_SUCCESS)
+    {
+        AE_THROW_RUNTIME_ERROR("Failed to create Vulkan upload timeline semaphore");
+    }
+}
+
+void ae::VulkanUploadManager::DestroyTimelineSemaphore()
+{
+    vkDestroySemaphore(VulkanManager::Get().GetDevice(), m_TimelineSemaphore, nullptr);
+
+    m_TimelineSemaphore = VK_NULL_HANDLE;
+}
+
+#endif // AE_VULKAN
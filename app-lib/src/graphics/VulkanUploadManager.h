@@ -0,0 +1,110 @@
+#pragma once
+
+#ifdef AE_VULKAN
+
+#include "Vulkan.h"
+
+#include <array>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ae
+{
+	// Streams buffer and image data to the GPU through a persistently mapped staging ring. Copies are
+	// batched into one submission on the transfer queue, and each submission signals a timeline
+	// semaphore that frame submissions wait on, so uploads overlap rendering instead of stalling it.
+	// When the transfer queue belongs to its own family, ownership is released on the transfer queue
+	// and acquired on the graphics queue as part of the same batch.
+	class VulkanUploadManager
+	{
+	public:
+		VulkanUploadManager(VkDeviceSize stagingSize);
+		VulkanUploadManager(const VulkanUploadManager&) = delete;
+		VulkanUploadManager& operator=(const VulkanUploadManager&) = delete;
+		~VulkanUploadManager();
+
+		void UploadBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* pData, VkDeviceSize size);
+
+		// Copies tightly packed texels into mip 0, layer 0 of a color image. The previous contents are
+		// discarded and the image is left in finalLayout, owned by the graphics queue family.
+		void UploadImage(VkImage dstImage, VkExtent3D extent, const void* pData, VkDeviceSize size, VkImageLayout finalLayout);
+
+		// Submits everything recorded since the last flush and returns the timeline value that is
+		// signaled once it has completed. Returns the last submitted value if nothing was pending.
+		uint64_t Flush();
+
+		bool IsComplete(uint64_t value) const;
+		void Wait(uint64_t value) const;
+
+		inline VkSemaphore GetTimelineSemaphore() const { return m_TimelineSemaphore; }
+	private:
+		struct Batch
+		{
+			VkCommandBuffer transferCommandBuffer = VK_NULL_HANDLE;
+			VkCommandBuffer acquireCommandBuffer = VK_NULL_HANDLE;
+
+			std::vector<VkBufferMemoryBarrier> bufferBarriers;
+			std::vector<VkImageMemoryBarrier> imageBarriers;
+			std::vector<std::pair<VkBuffer, VmaAllocation>> dedicatedStaging;
+
+			uint64_t stagingEnd = 0;
+			uint64_t completionValue = 0;
+			bool recording = false;
+		};
+
+		struct StagingAllocation
+		{
+			VkBuffer buffer;
+			VkDeviceSize offset;
+			uint8_t* pMapped;
+			VmaAllocation dedicatedAllocation;
+		};
+
+		StagingAllocation AllocateStaging(VkDeviceSize size);
+		Batch& GetRecordingBatch();
+
+		void SubmitBatch(Batch& batch);
+		bool RetireCompletedBatches();
+		void RetireOldestBatch();
+		void RetireBatch(Batch& batch);
+
+		void CreateStagingBuffer();
+		void DestroyStagingBuffer();
+
+		void CreateCommandObjects();
+		void DestroyCommandObjects();
+
+		void CreateTimelineSemaphore();
+		void DestroyTimelineSemaphore();
+	private:
+		static constexpr uint32_t s_BatchCount = 4;
+
+		mutable std::mutex m_Mutex;
+
+		uint32_t m_GraphicsFamily;
+		uint32_t m_TransferFamily;
+		VkDeviceSize m_Alignment;
+
+		VkBuffer m_StagingBuffer;
+		VmaAllocation m_StagingAllocation;
+		uint8_t* m_pStagingData;
+		VkDeviceSize m_StagingSize;
+
+		// Monotonic byte positions in the ring; the offset into the buffer is position % m_StagingSize
+		uint64_t m_RingHead = 0;
+		uint64_t m_RingTail = 0;
+
+		VkCommandPool m_TransferCommandPool;
+		VkCommandPool m_AcquireCommandPool;
+
+		std::array<Batch, s_BatchCount> m_Batches;
+		uint64_t m_SubmittedBatches = 0;
+		uint64_t m_RetiredBatches = 0;
+
+		VkSemaphore m_TimelineSemaphore;
+		uint64_t m_SubmittedValue = 0;
+	};
+}
+
+#endif // AE_VULKAN
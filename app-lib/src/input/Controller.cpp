@@ -2,49 +2,63 @@
 
 #include "Window.h"
 
-ae::Controller::Controller(uint32_t id) : m_Id(id) {}
+ae::Controller::Controller(uint32_t id, const ControllerSnapshot &snapshot) : m_Id(id), m_pSnapshot(&snapshot) {}
 
 bool ae::Controller::IsButtonPressed(int32_t button) const
 {
-    if (button < 0 || button > AE_CONTROLLER_BUTTON_LAST)
+    if (button < 0 || button > AE_CONTROLLER_BUTTON_LAST || !IsSnapshotConnected("button state"))
     {
         return false;
     }
 
-    GLFWgamepadstate state = {};
-    if (!glfwGetGamepadState(GLFW_JOYSTICK_1 + static_cast<int>(m_Id), &state))
+    return m_pSnapshot->current.buttons[m_Id] & (1u << button);
+}
+
+bool ae::Controller::IsButtonPressed(ControllerButton button) const
+{
+    return IsButtonPressed(static_cast<int32_t>(button));
+}
+
+bool ae::Controller::WasButtonPressed(int32_t button) const
+{
+    if (button < 0 || button > AE_CONTROLLER_BUTTON_LAST || !IsSnapshotConnected("button state"))
     {
-#ifdef AE_DEBUG
-        AE_LOG(AE_WARNING, "Tried to get button state but controller {} is not connected", m_Id);
-#endif
         return false;
     }
 
-    return state.buttons[button] == GLFW_PRESS;
+    uint32_t pressed = m_pSnapshot->current.buttons[m_Id] & ~m_pSnapshot->previous.buttons[m_Id];
+    return pressed & (1u << button);
 }
 
-bool ae::Controller::IsButtonPressed(ControllerButton button) const
+bool ae::Controller::WasButtonPressed(ControllerButton button) const
 {
-    return IsButtonPressed(static_cast<int32_t>(button));
+    return WasButtonPressed(static_cast<int32_t>(button));
 }
 
-float ae::Controller::GetAxis(int32_t axis) const
+bool ae::Controller::WasButtonReleased(int32_t button) const
 {
-    if (axis < 0 || axis > AE_CONTROLLER_AXIS_LAST)
+    if (button < 0 || button > AE_CONTROLLER_BUTTON_LAST || !IsSnapshotConnected("button state"))
     {
-        return 0.0f;
+        return false;
     }
 
-    GLFWgamepadstate state = {};
-    if (!glfwGetGamepadState(GLFW_JOYSTICK_1 + static_cast<int>(m_Id), &state))
+    uint32_t released = ~m_pSnapshot->current.buttons[m_Id] & m_pSnapshot->previous.buttons[m_Id];
+    return released & (1u << button);
+}
+
+bool ae::Controller::WasButtonReleased(ControllerButton button) const
+{
+    return WasButtonReleased(static_cast<int32_t>(button));
+}
+
+float ae::Controller::GetAxis(int32_t axis) const
+{
+    if (axis < 0 || axis > AE_CONTROLLER_AXIS_LAST || !IsSnapshotConnected("axis state"))
     {
-#ifdef AE_DEBUG
-        AE_LOG(AE_WARNING, "Tried to get axis state but controller {} is not connected", m_Id);
-#endif
         return 0.0f;
     }
 
-    return ApplyDeadzone(state.axes[axis]);
+    return ApplyDeadzone(m_pSnapshot->current.axes[m_Id][axis]);
 }
 
 float ae::Controller::GetAxis(ControllerAxis axis) const
@@ -52,48 +66,55 @@ float ae::Controller::GetAxis(ControllerAxis axis) const
     return GetAxis(static_cast<int32_t>(axis));
 }
 
+float ae::Controller::GetAxisDelta(int32_t axis) const
+{
+    if (axis < 0 || axis > AE_CONTROLLER_AXIS_LAST || !IsSnapshotConnected("axis delta"))
+    {
+        return 0.0f;
+    }
+
+    // A pad that just connected starts from rest
+    return ApplyDeadzone(m_pSnapshot->current.axes[m_Id][axis]) -
+           ApplyDeadzone(m_pSnapshot->previous.axes[m_Id][axis]);
+}
+
+float ae::Controller::GetAxisDelta(ControllerAxis axis) const
+{
+    return GetAxisDelta(static_cast<int32_t>(axis));
+}
+
 glm::vec2 ae::Controller::GetLeftStick() const
 {
-    GLFWgamepadstate state = {};
-    if (!glfwGetGamepadState(GLFW_JOYSTICK_1 + static_cast<int>(m_Id), &state))
+    if (!IsSnapshotConnected("left stick"))
     {
-#ifdef AE_DEBUG
-        AE_LOG(AE_WARNING, "Tried to get left stick but controller {} is not connected", m_Id);
-#endif
         return { 0.0f, 0.0f };
     }
 
-    return { ApplyDeadzone(state.axes[GLFW_GAMEPAD_AXIS_LEFT_X]), ApplyDeadzone(state.axes[GLFW_GAMEPAD_AXIS_LEFT_Y]) };
+    const auto &axes = m_pSnapshot->current.axes[m_Id];
+    return { ApplyDeadzone(axes[GLFW_GAMEPAD_AXIS_LEFT_X]), ApplyDeadzone(axes[GLFW_GAMEPAD_AXIS_LEFT_Y]) };
 }
 
 glm::vec2 ae::Controller::GetRightStick() const
 {
-    GLFWgamepadstate state = {};
-    if (!glfwGetGamepadState(GLFW_JOYSTICK_1 + static_cast<int>(m_Id), &state))
+    if (!IsSnapshotConnected("right stick"))
     {
-#ifdef AE_DEBUG
-        AE_LOG(AE_WARNING, "Tried to get right stick but controller {} is not connected", m_Id);
-#endif
         return { 0.0f, 0.0f };
     }
 
-    return { ApplyDeadzone(state.axes[GLFW_GAMEPAD_AXIS_RIGHT_X]),
-             ApplyDeadzone(state.axes[GLFW_GAMEPAD_AXIS_RIGHT_Y]) };
+    const auto &axes = m_pSnapshot->current.axes[m_Id];
+    return { ApplyDeadzone(axes[GLFW_GAMEPAD_AXIS_RIGHT_X]), ApplyDeadzone(axes[GLFW_GAMEPAD_AXIS_RIGHT_Y]) };
 }
 
 glm::vec2 ae::Controller::GetTriggers() const
 {
-    GLFWgamepadstate state = {};
-    if (!glfwGetGamepadState(GLFW_JOYSTICK_1 + static_cast<int>(m_Id), &state))
+    if (!IsSnapshotConnected("triggers"))
     {
-#ifdef AE_DEBUG
-        AE_LOG(AE_WARNING, "Tried to get triggers but controller {} is not connected", m_Id);
-#endif
         return { 0.0f, 0.0f };
     }
 
     // Triggers don't need deadzone - they're linear from -1 to 1
-    return { state.axes[GLFW_GAMEPAD_AXIS_LEFT_TRIGGER], state.axes[GLFW_GAMEPAD_AXIS_RIGHT_TRIGGER] };
+    const auto &axes = m_pSnapshot->current.axes[m_Id];
+    return { axes[GLFW_GAMEPAD_AXIS_LEFT_TRIGGER], axes[GLFW_GAMEPAD_AXIS_RIGHT_TRIGGER] };
 }
 
 float ae::Controller::ApplyDeadzone(float value) const
@@ -108,6 +129,19 @@ float ae::Controller::ApplyDeadzone(float value) const
     return sign * (std::abs(value) - m_Deadzone) / (1.0f - m_Deadzone);
 }
 
+bool ae::Controller::IsSnapshotConnected([[maybe_unused]] const char *pQuery) const
+{
+    if (m_Id >= AE_CONTROLLER_COUNT || !(m_pSnapshot->current.connected & (1u << m_Id)))
+    {
+#ifdef AE_DEBUG
+        AE_LOG(AE_WARNING, "Tried to get {} but controller {} is not connected", pQuery, m_Id);
+#endif
+        return false;
+    }
+
+    return true;
+}
+
 std::string ae::Controller::GetName() const
 {
     const char *pName = glfwGetGamepadName(GLFW_JOYSTICK_1 + static_cast<int>(m_Id));
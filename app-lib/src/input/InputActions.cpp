@@ -0,0 +1,459 @@
+#include "general/pch.h"
+
+#include "Files.h"
+#include "Window.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+
+constexpr std::pair<std::string_view, uint16_t> s_KeyNames[] = {
+    { "SPACE", static_cast<uint16_t>(ae::Key::SPACE) },
+    { "APOSTROPHE", static_cast<uint16_t>(ae::Key::APOSTROPHE) },
+    { "COMMA", static_cast<uint16_t>(ae::Key::COMMA) },
+    { "MINUS", static_cast<uint16_t>(ae::Key::MINUS) },
+    { "PERIOD", static_cast<uint16_t>(ae::Key::PERIOD) },
+    { "SLASH", static_cast<uint16_t>(ae::Key::SLASH) },
+    { "ZERO", static_cast<uint16_t>(ae::Key::ZERO) },
+    { "ONE", static_cast<uint16_t>(ae::Key::ONE) },
+    { "TWO", static_cast<uint16_t>(ae::Key::TWO) },
+    { "THREE", static_cast<uint16_t>(ae::Key::THREE) },
+    { "FOUR", static_cast<uint16_t>(ae::Key::FOUR) },
+    { "FIVE", static_cast<uint16_t>(ae::Key::FIVE) },
+    { "SIX", static_cast<uint16_t>(ae::Key::SIX) },
+    { "SEVEN", static_cast<uint16_t>(ae::Key::SEVEN) },
+    { "EIGHT", static_cast<uint16_t>(ae::Key::EIGHT) },
+    { "NINE", static_cast<uint16_t>(ae::Key::NINE) },
+    { "SEMICOLON", static_cast<uint16_t>(ae::Key::SEMICOLON) },
+    { "EQUAL", static_cast<uint16_t>(ae::Key::EQUAL) },
+    { "A", static_cast<uint16_t>(ae::Key::A) },
+    { "B", static_cast<uint16_t>(ae::Key::B) },
+    { "C", static_cast<uint16_t>(ae::Key::C) },
+    { "D", static_cast<uint16_t>(ae::Key::D) },
+    { "E", static_cast<uint16_t>(ae::Key::E) },
+    { "F", static_cast<uint16_t>(ae::Key::F) },
+    { "G", static_cast<uint16_t>(ae::Key::G) },
+    { "H", static_cast<uint16_t>(ae::Key::H) },
+    { "I", static_cast<uint16_t>(ae::Key::I) },
+    { "J", static_cast<uint16_t>(ae::Key::J) },
+    { "K", static_cast<uint16_t>(ae::Key::K) },
+    { "L", static_cast<uint16_t>(ae::Key::L) },
+    { "M", static_cast<uint16_t>(ae::Key::M) },
+    { "N", static_cast<uint16_t>(ae::Key::N) },
+    { "O", static_cast<uint16_t>(ae::Key::O) },
+    { "P", static_cast<uint16_t>(ae::Key::P) },
+    { "Q", static_cast<uint16_t>(ae::Key::Q) },
+    { "R", static_cast<uint16_t>(ae::Key::R) },
+    { "S", static_cast<uint16_t>(ae::Key::S) },
+    { "T", static_cast<uint16_t>(ae::Key::T) },
+    { "U", static_cast<uint16_t>(ae::Key::U) },
+    { "V", static_cast<uint16_t>(ae::Key::V) },
+    { "W", static_cast<uint16_t>(ae::Key::W) },
+    { "X", static_cast<uint16_t>(ae::Key::X) },
+    { "Y", static_cast<uint16_t>(ae::Key::Y) },
+    { "Z", static_cast<uint16_t>(ae::Key::Z) },
+    { "LEFT_BRACKET", static_cast<uint16_t>(ae::Key::LEFT_BRACKET) },
+    { "BACKSLASH", static_cast<uint16_t>(ae::Key::BACKSLASH) },
+    { "RIGHT_BRACKET", static_cast<uint16_t>(ae::Key::RIGHT_BRACKET) },
+    { "GRAVE_ACCENT", static_cast<uint16_t>(ae::Key::GRAVE_ACCENT) },
+    { "WORLD_1", static_cast<uint16_t>(ae::Key::WORLD_1) },
+    { "WORLD_2", static_cast<uint16_t>(ae::Key::WORLD_2) },
+    { "ESCAPE", static_cast<uint16_t>(ae::Key::ESCAPE) },
+    { "ENTER", static_cast<uint16_t>(ae::Key::ENTER) },
+    { "TAB", static_cast<uint16_t>(ae::Key::TAB) },
+    { "BACKSPACE", static_cast<uint16_t>(ae::Key::BACKSPACE) },
+    { "INSERT", static_cast<uint16_t>(ae::Key::INSERT) },
+    { "DELETE", static_cast<uint16_t>(ae::Key::DELETE) },
+    { "RIGHT", static_cast<uint16_t>(ae::Key::RIGHT) },
+    { "LEFT", static_cast<uint16_t>(ae::Key::LEFT) },
+    { "DOWN", static_cast<uint16_t>(ae::Key::DOWN) },
+    { "UP", static_cast<uint16_t>(ae::Key::UP) },
+    { "PAGE_UP", static_cast<uint16_t>(ae::Key::PAGE_UP) },
+    { "PAGE_DOWN", static_cast<uint16_t>(ae::Key::PAGE_DOWN) },
+    { "HOME", static_cast<uint16_t>(ae::Key::HOME) },
+    { "END", static_cast<uint16_t>(ae::Key::END) },
+    { "CAPS_LOCK", static_cast<uint16_t>(ae::Key::CAPS_LOCK) },
+    { "SCROLL_LOCK", static_cast<uint16_t>(ae::Key::SCROLL_LOCK) },
+    { "NUM_LOCK", static_cast<uint16_t>(ae::Key::NUM_LOCK) },
+    { "PRINT_SCREEN", static_cast<uint16_t>(ae::Key::PRINT_SCREEN) },
+    { "PAUSE", static_cast<uint16_t>(ae::Key::PAUSE) },
+    { "F1", static_cast<uint16_t>(ae::Key::F1) },
+    { "F2", static_cast<uint16_t>(ae::Key::F2) },
+    { "F3", static_cast<uint16_t>(ae::Key::F3) },
+    { "F4", static_cast<uint16_t>(ae::Key::F4) },
+    { "F5", static_cast<uint16_t>(ae::Key::F5) },
+    { "F6", static_cast<uint16_t>(ae::Key::F6) },
+    { "F7", static_cast<uint16_t>(ae::Key::F7) },
+    { "F8", static_cast<uint16_t>(ae::Key::F8) },
+    { "F9", static_cast<uint16_t>(ae::Key::F9) },
+    { "F10", static_cast<uint16_t>(ae::Key::F10) },
+    { "F11", static_cast<uint16_t>(ae::Key::F11) },
+    { "F12", static_cast<uint16_t>(ae::Key::F12) },
+    { "F13", static_cast<uint16_t>(ae::Key::F13) },
+    { "F14", static_cast<uint16_t>(ae::Key::F14) },
+    { "F15", static_cast<uint16_t>(ae::Key::F15) },
+    { "F16", static_cast<uint16_t>(ae::Key::F16) },
+    { "F17", static_cast<uint16_t>(ae::Key::F17) },
+    { "F18", static_cast<uint16_t>(ae::Key::F18) },
+    { "F19", static_cast<uint16_t>(ae::Key::F19) },
+    { "F20", static_cast<uint16_t>(ae::Key::F20) },
+    { "F21", static_cast<uint16_t>(ae::Key::F21) },
+    { "F22", static_cast<uint16_t>(ae::Key::F22) },
+    { "F23", static_cast<uint16_t>(ae::Key::F23) },
+    { "F24", static_cast<uint16_t>(ae::Key::F24) },
+    { "F25", static_cast<uint16_t>(ae::Key::F25) },
+    { "KP_0", static_cast<uint16_t>(ae::Key::KP_0) },
+    { "KP_1", static_cast<uint16_t>(ae::Key::KP_1) },
+    { "KP_2", static_cast<uint16_t>(ae::Key::KP_2) },
+    { "KP_3", static_cast<uint16_t>(ae::Key::KP_3) },
+    { "KP_4", static_cast<uint16_t>(ae::Key::KP_4) },
+    { "KP_5", static_cast<uint16_t>(ae::Key::KP_5) },
+    { "KP_6", static_cast<uint16_t>(ae::Key::KP_6) },
+    { "KP_7", static_cast<uint16_t>(ae::Key::KP_7) },
+    { "KP_8", static_cast<uint16_t>(ae::Key::KP_8) },
+    { "KP_9", static_cast<uint16_t>(ae::Key::KP_9) },
+    { "KP_DECIMAL", static_cast<uint16_t>(ae::Key::KP_DECIMAL) },
+    { "KP_DIVIDE", static_cast<uint16_t>(ae::Key::KP_DIVIDE) },
+    { "KP_MULTIPLY", static_cast<uint16_t>(ae::Key::KP_MULTIPLY) },
+    { "KP_SUBTRACT", static_cast<uint16_t>(ae::Key::KP_SUBTRACT) },
+    { "KP_ADD", static_cast<uint16_t>(ae::Key::KP_ADD) },
+    { "KP_ENTER", static_cast<uint16_t>(ae::Key::KP_ENTER) },
+    { "KP_EQUAL", static_cast<uint16_t>(ae::Key::KP_EQUAL) },
+    { "LEFT_SHIFT", static_cast<uint16_t>(ae::Key::LEFT_SHIFT) },
+    { "LEFT_CONTROL", static_cast<uint16_t>(ae::Key::LEFT_CONTROL) },
+    { "LEFT_ALT", static_cast<uint16_t>(ae::Key::LEFT_ALT) },
+    { "LEFT_SUPER", static_cast<uint16_t>(ae::Key::LEFT_SUPER) },
+    { "RIGHT_SHIFT", static_cast<uint16_t>(ae::Key::RIGHT_SHIFT) },
+    { "RIGHT_CONTROL", static_cast<uint16_t>(ae::Key::RIGHT_CONTROL) },
+    { "RIGHT_ALT", static_cast<uint16_t>(ae::Key::RIGHT_ALT) },
+    { "RIGHT_SUPER", static_cast<uint16_t>(ae::Key::RIGHT_SUPER) },
+    { "MENU", static_cast<uint16_t>(ae::Key::MENU) },
+};
+
+constexpr std::pair<std::string_view, uint16_t> s_MouseButtonNames[] = {
+    { "BUTTON_LEFT", static_cast<uint16_t>(ae::MouseButton::BUTTON_LEFT) },
+    { "BUTTON_RIGHT", static_cast<uint16_t>(ae::MouseButton::BUTTON_RIGHT) },
+    { "BUTTON_MIDDLE", static_cast<uint16_t>(ae::MouseButton::BUTTON_MIDDLE) },
+    { "BUTTON_4", static_cast<uint16_t>(ae::MouseButton::BUTTON_4) },
+    { "BUTTON_5", static_cast<uint16_t>(ae::MouseButton::BUTTON_5) },
+    { "BUTTON_6", static_cast<uint16_t>(ae::MouseButton::BUTTON_6) },
+    { "BUTTON_7", static_cast<uint16_t>(ae::MouseButton::BUTTON_7) },
+    { "BUTTON_8", static_cast<uint16_t>(ae::MouseButton::BUTTON_8) },
+};
+
+constexpr std::pair<std::string_view, uint16_t> s_ControllerButtonNames[] = {
+    { "BUTTON_ONE", static_cast<uint16_t>(ae::ControllerButton::BUTTON_ONE) },
+    { "BUTTON_TWO", static_cast<uint16_t>(ae::ControllerButton::BUTTON_TWO) },
+    { "BUTTON_THREE", static_cast<uint16_t>(ae::ControllerButton::BUTTON_THREE) },
+    { "BUTTON_FOUR", static_cast<uint16_t>(ae::ControllerButton::BUTTON_FOUR) },
+    { "LEFT_BUMPER", static_cast<uint16_t>(ae::ControllerButton::LEFT_BUMPER) },
+    { "RIGHT_BUMPER", static_cast<uint16_t>(ae::ControllerButton::RIGHT_BUMPER) },
+    { "BACK", static_cast<uint16_t>(ae::ControllerButton::BACK) },
+    { "START", static_cast<uint16_t>(ae::ControllerButton::START) },
+    { "GUIDE", static_cast<uint16_t>(ae::ControllerButton::GUIDE) },
+    { "LEFT_THUMB", static_cast<uint16_t>(ae::ControllerButton::LEFT_THUMB) },
+    { "RIGHT_THUMB", static_cast<uint16_t>(ae::ControllerButton::RIGHT_THUMB) },
+    { "DPAD_UP", static_cast<uint16_t>(ae::ControllerButton::DPAD_UP) },
+    { "DPAD_RIGHT", static_cast<uint16_t>(ae::ControllerButton::DPAD_RIGHT) },
+    { "DPAD_DOWN", static_cast<uint16_t>(ae::ControllerButton::DPAD_DOWN) },
+    { "DPAD_LEFT", static_cast<uint16_t>(ae::ControllerButton::DPAD_LEFT) },
+};
+
+constexpr std::pair<std::string_view, uint16_t> s_ControllerAxisNames[] = {
+    { "LEFT_X", static_cast<uint16_t>(ae::ControllerAxis::LEFT_X) },
+    { "LEFT_Y", static_cast<uint16_t>(ae::ControllerAxis::LEFT_Y) },
+    { "RIGHT_X", static_cast<uint16_t>(ae::ControllerAxis::RIGHT_X) },
+    { "RIGHT_Y", static_cast<uint16_t>(ae::ControllerAxis::RIGHT_Y) },
+    { "LEFT_TRIGGER", static_cast<uint16_t>(ae::ControllerAxis::LEFT_TRIGGER) },
+    { "RIGHT_TRIGGER", static_cast<uint16_t>(ae::ControllerAxis::RIGHT_TRIGGER) },
+};
+
+template <size_t N>
+bool FindCode(const std::pair<std::string_view, uint16_t> (&names)[N], std::string_view name, uint16_t &code)
+{
+    for (const auto &[entryName, entryCode] : names)
+    {
+        if (entryName == name)
+        {
+            code = entryCode;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+float ApplyDeadzone(float value, float deadzone)
+{
+    if (std::abs(value) < deadzone)
+    {
+        return 0.0f;
+    }
+
+    float sign = (value > 0.0f) ? 1.0f : -1.0f;
+    return sign * (std::abs(value) - deadzone) / (1.0f - deadzone);
+}
+
+// GLFW triggers rest at -1 and are fully pulled at 1. They are read from 0 to 1, so a released trigger is at rest
+// like every other input.
+float ReadAxis(const ae::ControllerStates &pads, uint32_t id, uint16_t axis)
+{
+    float value = pads.axes[id][axis];
+
+    if (axis == AE_CONTROLLER_AXIS_LEFT_TRIGGER || axis == AE_CONTROLLER_AXIS_RIGHT_TRIGGER)
+    {
+        return (value + 1.0f) * 0.5f;
+    }
+
+    return value;
+}
+
+} // namespace
+
+void ae::InputActions::Load(const JsonFile &file)
+{
+    const nlohmann::json &json = file.GetJson();
+
+    if (!json.contains("actions") || !json["actions"].is_array())
+    {
+        AE_THROW_RUNTIME_ERROR("Input actions file '{}' has no actions array", file.GetPath());
+    }
+
+    for (const nlohmann::json &action : json["actions"])
+    {
+        std::vector<InputBindingDesc> bindings;
+
+        for (const nlohmann::json &binding : action.value("bindings", nlohmann::json::array()))
+        {
+            if (binding.is_string())
+            {
+                bindings.push_back({ .input = binding.get<std::string>() });
+            }
+            else
+            {
+                bindings.push_back({ .input = binding.value("input", std::string()),
+                                     .scale = binding.value("scale", 1.0f),
+                                     .deadzone = binding.value("deadzone", 0.1f) });
+            }
+        }
+
+        AddAction(action.value("name", std::string()), bindings, action.value("threshold", 0.5f));
+    }
+}
+
+void ae::InputActions::Load(const TomlFile &file)
+{
+    const toml::array *pActions = file.GetTable()["actions"].as_array();
+
+    if (!pActions)
+    {
+        AE_THROW_RUNTIME_ERROR("Input actions file '{}' has no actions array", file.GetPath());
+    }
+
+    for (const toml::node &node : *pActions)
+    {
+        const toml::table *pAction = node.as_table();
+
+        if (!pAction)
+        {
+            AE_THROW_RUNTIME_ERROR("Input actions file '{}' has an action that is not a table", file.GetPath());
+        }
+
+        std::vector<InputBindingDesc> bindings;
+
+        if (const toml::array *pBindings = (*pAction)["bindings"].as_array())
+        {
+            for (const toml::node &binding : *pBindings)
+            {
+                if (const toml::table *pBinding = binding.as_table())
+                {
+                    bindings.push_back({ .input = (*pBinding)["input"].value_or(std::string()),
+                                         .scale = (*pBinding)["scale"].value_or(1.0f),
+                                         .deadzone = (*pBinding)["deadzone"].value_or(0.1f) });
+                }
+                else
+                {
+                    bindings.push_back({ .input = binding.value_or(std::string()) });
+                }
+            }
+        }
+
+        AddAction((*pAction)["name"].value_or(std::string()), bindings, (*pAction)["threshold"].value_or(0.5f));
+    }
+}
+
+uint32_t ae::InputActions::AddAction(const std::string &name, const std::vector<InputBindingDesc> &bindings,
+                                     float threshold)
+{
+    if (name.empty())
+    {
+        AE_THROW_RUNTIME_ERROR("Input action has no name");
+    }
+
+    if (m_ActionIndices.contains(name))
+    {
+        AE_THROW_RUNTIME_ERROR("Input action '{}' is defined twice", name);
+    }
+
+    Action action = { .firstBinding = static_cast<uint32_t>(m_Bindings.size()),
+                      .bindingCount = 0,
+                      .threshold = threshold };
+
+    for (const InputBindingDesc &desc : bindings)
+    {
+        Binding binding = { .firstInput = static_cast<uint32_t>(m_Inputs.size()),
+                            .inputCount = 0,
+                            .scale = desc.scale,
+                            .deadzone = std::clamp(desc.deadzone, 0.0f, 0.99f) };
+
+        std::string_view chord = desc.input;
+
+        while (!chord.empty())
+        {
+            size_t end = chord.find('+');
+            std::string_view input = chord.substr(0, end);
+            chord = end == std::string_view::npos ? std::string_view() : chord.substr(end + 1);
+
+            size_t separator = input.find(':');
+            std::string_view device = input.substr(0, separator);
+            std::string_view inputName = separator == std::string_view::npos ? "" : input.substr(separator + 1);
+
+            Input compiled = {};
+            bool found = false;
+
+            if (device == "key")
+            {
+                compiled.source = InputSource::KEY;
+                found = FindCode(s_KeyNames, inputName, compiled.code);
+            }
+            else if (device == "mouse")
+            {
+                compiled.source = InputSource::MOUSE_BUTTON;
+                found = FindCode(s_MouseButtonNames, inputName, compiled.code);
+            }
+            else if (device == "button")
+            {
+                compiled.source = InputSource::CONTROLLER_BUTTON;
+                found = FindCode(s_ControllerButtonNames, inputName, compiled.code);
+            }
+            else if (device == "axis")
+            {
+                compiled.source = InputSource::CONTROLLER_AXIS;
+                found = FindCode(s_ControllerAxisNames, inputName, compiled.code);
+            }
+
+            if (!found)
+            {
+                AE_THROW_RUNTIME_ERROR("Input action '{}' has unknown input '{}'", name, input);
+            }
+
+            m_Inputs.push_back(compiled);
+            binding.inputCount++;
+        }
+
+        if (binding.inputCount == 0)
+        {
+            AE_THROW_RUNTIME_ERROR("Input action '{}' has an empty binding", name);
+        }
+
+        m_Bindings.push_back(binding);
+        action.bindingCount++;
+    }
+
+    uint32_t index = static_cast<uint32_t>(m_Actions.size());
+
+    m_Actions.push_back(action);
+    m_States.emplace_back();
+    m_ActionIndices.emplace(name, index);
+
+    return index;
+}
+
+void ae::InputActions::Clear()
+{
+    m_Inputs.clear();
+    m_Bindings.clear();
+    m_Actions.clear();
+    m_States.clear();
+    m_ActionIndices.clear();
+}
+
+uint32_t ae::InputActions::GetActionIndex(std::string_view name) const
+{
+    auto it = m_ActionIndices.find(std::string(name));
+
+    return it != m_ActionIndices.end() ? it->second : s_InvalidAction;
+}
+
+void ae::InputActions::Update(const Keyboard &keyboard, const Mouse &mouse, const ControllerSnapshot &controllers)
+{
+    const ControllerStates &pads = controllers.current;
+
+    for (size_t actionIndex = 0; actionIndex < m_Actions.size(); actionIndex++)
+    {
+        const Action &action = m_Actions[actionIndex];
+        float value = 0.0f;
+
+        for (uint32_t bindingIndex = 0; bindingIndex < action.bindingCount; bindingIndex++)
+        {
+            const Binding &binding = m_Bindings[action.firstBinding + bindingIndex];
+            float bindingValue = binding.scale;
+
+            for (uint32_t inputIndex = 0; inputIndex < binding.inputCount && bindingValue != 0.0f; inputIndex++)
+            {
+                const Input &input = m_Inputs[binding.firstInput + inputIndex];
+
+                switch (input.source)
+                {
+                case InputSource::KEY:
+                    bindingValue *= keyboard.IsKeyPressed(static_cast<int32_t>(input.code)) ? 1.0f : 0.0f;
+                    break;
+                case InputSource::MOUSE_BUTTON:
+                    bindingValue *= mouse.IsButtonPressed(static_cast<int32_t>(input.code)) ? 1.0f : 0.0f;
+                    break;
+                case InputSource::CONTROLLER_BUTTON:
+                case InputSource::CONTROLLER_AXIS: {
+                    // The pad pushing the input the furthest wins
+                    float padValue = 0.0f;
+
+                    for (uint32_t id = 0; id < AE_CONTROLLER_COUNT; id++)
+                    {
+                        if (!(pads.connected & (1u << id)))
+                        {
+                            continue;
+                        }
+
+                        float candidate = input.source == InputSource::CONTROLLER_BUTTON
+                                              ? ((pads.buttons[id] >> input.code) & 1u ? 1.0f : 0.0f)
+                                              : ApplyDeadzone(ReadAxis(pads, id, input.code), binding.deadzone);
+
+                        if (std::abs(candidate) > std::abs(padValue))
+                        {
+                            padValue = candidate;
+                        }
+                    }
+
+                    bindingValue *= padValue;
+                    break;
+                }
+                }
+            }
+
+            if (std::abs(bindingValue) > std::abs(value))
+            {
+                value = bindingValue;
+            }
+        }
+
+        InputActionState &state = m_States[actionIndex];
+        bool held = std::abs(value) >= action.threshold && value != 0.0f;
+
+        state.pressed = held && !state.held;
+        state.released = !held && state.held;
+        state.held = held;
+        state.value = value;
+    }
+}
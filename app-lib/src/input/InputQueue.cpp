@@ -0,0 +1,35 @@
+#include "general/pch.h"
+
+#include "input/InputQueue.h"
+
+bool ae::InputQueue::Push(const InputRecord &record)
+{
+    uint32_t head = m_Head.load(std::memory_order_relaxed);
+
+    // Indices wrap freely; the difference is the number of unread records
+    if (head - m_Tail.load(std::memory_order_acquire) == s_Capacity)
+    {
+        m_DroppedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    m_Records[head & (s_Capacity - 1)] = record;
+    m_Head.store(head + 1, std::memory_order_release);
+
+    return true;
+}
+
+bool ae::InputQueue::Pop(InputRecord &record)
+{
+    uint32_t tail = m_Tail.load(std::memory_order_relaxed);
+
+    if (tail == m_Head.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    record = m_Records[tail & (s_Capacity - 1)];
+    m_Tail.store(tail + 1, std::memory_order_release);
+
+    return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace ae
+{
+	enum class InputRecordType : uint8_t
+	{
+		KEY,
+		MOUSE_BUTTON,
+		MOUSE_MOVED,
+		MOUSE_SCROLLED,
+		MOUSE_ENTERED,
+		CHAR
+	};
+
+	// One GLFW input callback, as raw as it arrived. time is glfwGetTime() when the callback ran.
+	struct InputRecord
+	{
+		double time = 0.0;
+		double x = 0.0;
+		double y = 0.0;
+		int32_t a = 0; // Key, button, entered or codepoint
+		int32_t b = 0; // Scancode
+		int32_t action = 0;
+		int32_t mods = 0;
+		InputRecordType type = InputRecordType::KEY;
+	};
+
+	// Lock-free single-producer, single-consumer ring of input records. The producer is the thread polling GLFW
+	// and the consumer the thread dispatching the window's input; they may be the same thread. When the consumer
+	// falls more than s_Capacity records behind, new records are dropped and counted rather than blocking the
+	// producer.
+	class InputQueue
+	{
+	public:
+		InputQueue() = default;
+		InputQueue(const InputQueue&) = delete;
+		InputQueue& operator=(const InputQueue&) = delete;
+
+		// Producer only
+		bool Push(const InputRecord& record);
+		// Consumer only
+		bool Pop(InputRecord& record);
+
+		inline uint64_t GetDroppedCount() const { return m_DroppedCount.load(std::memory_order_relaxed); }
+	private:
+		static constexpr uint32_t s_Capacity = 1024; // Power of two
+	private:
+		std::array<InputRecord, s_Capacity> m_Records;
+
+		// On separate cache lines so the two threads do not invalidate each other's index on every record
+		alignas(64) std::atomic<uint32_t> m_Head = 0; // Next slot to write
+		alignas(64) std::atomic<uint32_t> m_Tail = 0; // Next slot to read
+		std::atomic<uint64_t> m_DroppedCount = 0;
+	};
+}
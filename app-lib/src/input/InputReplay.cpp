@@ -0,0 +1,280 @@
+#include "general/pch.h"
+
+#include "Files.h"
+#include "Window.h"
+#include "input/InputReplay.h"
+
+namespace
+{
+
+constexpr uint32_t s_RecordingMagic = 0x52494541; // "AEIR"
+constexpr uint32_t s_RecordingVersion = 3;
+constexpr size_t s_FrameCountOffset = 2 * sizeof(uint32_t);
+
+// Serialized sizes, used to bound the counts read from a file before anything is allocated for them
+constexpr size_t s_FrameHeaderSize = sizeof(double) + sizeof(uint32_t) + sizeof(uint8_t);
+constexpr size_t s_ControllerRecordSize = sizeof(uint8_t) + sizeof(uint16_t) + 6 * sizeof(float);
+constexpr size_t s_InputRecordSize = 3 * sizeof(double) + 4 * sizeof(int32_t) + sizeof(ae::InputRecordType);
+
+template <typename T> void Append(std::vector<uint8_t> &data, const T &value)
+{
+    const uint8_t *pBytes = reinterpret_cast<const uint8_t *>(&value);
+    data.insert(data.end(), pBytes, pBytes + sizeof(T));
+}
+
+class RecordingReader
+{
+  public:
+    RecordingReader(const std::vector<uint8_t> &data, const std::string &path) : m_Data(data), m_Path(path) {}
+
+    template <typename T> T Read()
+    {
+        T value;
+        Read(&value, sizeof(T));
+
+        return value;
+    }
+
+    void Read(void *pDestination, size_t size)
+    {
+        if (m_Offset + size > m_Data.size())
+        {
+            AE_THROW_RUNTIME_ERROR("Input recording '{}' is truncated", m_Path);
+        }
+
+        std::memcpy(pDestination, m_Data.data() + m_Offset, size);
+        m_Offset += size;
+    }
+
+    // Reads a count of entries that follow in the file, each at least entrySize bytes long. A corrupt count
+    // would otherwise allocate its entries before the missing data is noticed.
+    template <typename T> size_t ReadCount(size_t entrySize, const char *pWhat)
+    {
+        size_t count = Read<T>();
+
+        if (count > GetRemaining() / entrySize)
+        {
+            AE_THROW_RUNTIME_ERROR("Input recording '{}' is corrupt, {} {} do not fit in the remaining {} bytes",
+                                   m_Path, count, pWhat, GetRemaining());
+        }
+
+        return count;
+    }
+
+    inline size_t GetRemaining() const
+    {
+        return m_Data.size() - m_Offset;
+    }
+
+  private:
+    const std::vector<uint8_t> &m_Data;
+    const std::string &m_Path;
+    size_t m_Offset = 0;
+};
+
+} // namespace
+
+ae::InputRecorder::InputRecorder(const std::string &path, const InputStartState &startState) : m_Path(path)
+{
+    Append(m_Data, s_RecordingMagic);
+    Append(m_Data, s_RecordingVersion);
+    Append(m_Data, uint32_t(0)); // Frame count, filled in by Save
+
+    Append(m_Data, startState.cursorX);
+    Append(m_Data, startState.cursorY);
+    Append(m_Data, startState.buttons);
+    Append(m_Data, static_cast<uint16_t>(startState.keys.size()));
+
+    for (int32_t key : startState.keys)
+    {
+        Append(m_Data, static_cast<int16_t>(key));
+    }
+}
+
+void ae::InputRecorder::BeginFrame(double deltaTime, const ControllerStates &controllers)
+{
+    FinishFrame();
+
+    m_Frame.deltaTime = deltaTime;
+    m_Frame.controllers.clear();
+    m_Frame.records.clear();
+
+    for (uint32_t id = 0; id < AE_CONTROLLER_COUNT; id++)
+    {
+        if (controllers.connected & (1u << id))
+        {
+            m_Frame.controllers.push_back(
+                ControllerRecord{ .id = id, .buttons = controllers.buttons[id], .axes = controllers.axes[id] });
+        }
+    }
+
+    m_FrameOpen = true;
+}
+
+void ae::InputRecorder::Add(const InputRecord &record)
+{
+    if (m_FrameOpen)
+    {
+        m_Frame.records.push_back(record);
+    }
+}
+
+void ae::InputRecorder::Save()
+{
+    FinishFrame();
+
+    std::memcpy(m_Data.data() + s_FrameCountOffset, &m_FrameCount, sizeof(uint32_t));
+
+    BinaryFile file(m_Path);
+    file.SetData(m_Data);
+    file.Write();
+
+    AE_LOG(AE_INFO, "Input recording of {} frames written to '{}'", m_FrameCount, m_Path);
+}
+
+void ae::InputRecorder::FinishFrame()
+{
+    if (!m_FrameOpen)
+    {
+        return;
+    }
+
+    Append(m_Data, m_Frame.deltaTime);
+    Append(m_Data, static_cast<uint32_t>(m_Frame.records.size()));
+    Append(m_Data, static_cast<uint8_t>(m_Frame.controllers.size()));
+
+    for (const ControllerRecord &controller : m_Frame.controllers)
+    {
+        Append(m_Data, static_cast<uint8_t>(controller.id));
+        Append(m_Data, controller.buttons);
+        Append(m_Data, controller.axes);
+    }
+
+    for (const InputRecord &record : m_Frame.records)
+    {
+        Append(m_Data, record.time);
+        Append(m_Data, record.x);
+        Append(m_Data, record.y);
+        Append(m_Data, record.a);
+        Append(m_Data, record.b);
+        Append(m_Data, record.action);
+        Append(m_Data, record.mods);
+        Append(m_Data, record.type);
+    }
+
+    m_FrameCount++;
+    m_FrameOpen = false;
+}
+
+ae::InputReplay::InputReplay(const std::string &path)
+{
+    BinaryFile file(path);
+    file.Read();
+
+    RecordingReader reader(file.GetData(), path);
+
+    if (reader.Read<uint32_t>() != s_RecordingMagic)
+    {
+        AE_THROW_RUNTIME_ERROR("File '{}' is not an input recording", path);
+    }
+
+    uint32_t version = reader.Read<uint32_t>();
+
+    if (version != s_RecordingVersion)
+    {
+        AE_THROW_RUNTIME_ERROR("Input recording '{}' has version {}, expected {}", path, version, s_RecordingVersion);
+    }
+
+    // Frames follow the start state, so their count is only bounded once it is read
+    uint32_t frameCount = reader.Read<uint32_t>();
+
+    m_StartState.cursorX = reader.Read<float>();
+    m_StartState.cursorY = reader.Read<float>();
+    m_StartState.buttons = reader.Read<uint8_t>();
+    m_StartState.keys.resize(reader.ReadCount<uint16_t>(sizeof(int16_t), "held keys"));
+
+    for (int32_t &key : m_StartState.keys)
+    {
+        key = reader.Read<int16_t>();
+
+        if (key < 0 || key > GLFW_KEY_LAST)
+        {
+            AE_THROW_RUNTIME_ERROR("Input recording '{}' is corrupt, held key {} is out of range", path, key);
+        }
+    }
+
+    if (frameCount > reader.GetRemaining() / s_FrameHeaderSize)
+    {
+        AE_THROW_RUNTIME_ERROR("Input recording '{}' is corrupt, {} frames do not fit in the remaining {} bytes",
+                               path, frameCount, reader.GetRemaining());
+    }
+
+    m_Frames.resize(frameCount);
+
+    for (InputFrame &frame : m_Frames)
+    {
+        frame.deltaTime = reader.Read<double>();
+
+        // Records follow the controllers, so their count is only bounded once both are read
+        uint32_t recordCount = reader.Read<uint32_t>();
+        frame.controllers.resize(reader.ReadCount<uint8_t>(s_ControllerRecordSize, "controllers"));
+
+        for (ControllerRecord &controller : frame.controllers)
+        {
+            controller.id = reader.Read<uint8_t>();
+            controller.buttons = reader.Read<uint16_t>();
+            reader.Read(controller.axes.data(), sizeof(controller.axes));
+
+            if (controller.id >= AE_CONTROLLER_COUNT)
+            {
+                AE_THROW_RUNTIME_ERROR("Input recording '{}' is corrupt, controller id {} is out of range", path,
+                                       controller.id);
+            }
+        }
+
+        if (recordCount > reader.GetRemaining() / s_InputRecordSize)
+        {
+            AE_THROW_RUNTIME_ERROR("Input recording '{}' is corrupt, {} records do not fit in the remaining {} bytes",
+                                   path, recordCount, reader.GetRemaining());
+        }
+
+        frame.records.resize(recordCount);
+
+        for (InputRecord &record : frame.records)
+        {
+            record.time = reader.Read<double>();
+            record.x = reader.Read<double>();
+            record.y = reader.Read<double>();
+            record.a = reader.Read<int32_t>();
+            record.b = reader.Read<int32_t>();
+            record.action = reader.Read<int32_t>();
+            record.mods = reader.Read<int32_t>();
+            record.type = reader.Read<InputRecordType>();
+
+            if (record.type > InputRecordType::CHAR)
+            {
+                AE_THROW_RUNTIME_ERROR("Input recording '{}' is corrupt, unknown record type {}", path,
+                                       static_cast<uint32_t>(record.type));
+            }
+
+            if ((record.type == InputRecordType::KEY && (record.a < GLFW_KEY_UNKNOWN || record.a > GLFW_KEY_LAST)) ||
+                (record.type == InputRecordType::MOUSE_BUTTON && (record.a < 0 || record.a > GLFW_MOUSE_BUTTON_LAST)))
+            {
+                AE_THROW_RUNTIME_ERROR("Input recording '{}' is corrupt, key or button code {} is out of range", path,
+                                       record.a);
+            }
+        }
+    }
+
+    AE_LOG(AE_INFO, "Input recording '{}' loaded with {} frames", path, frameCount);
+}
+
+const ae::InputFrame *ae::InputReplay::NextFrame()
+{
+    if (m_NextFrame == m_Frames.size())
+    {
+        return nullptr;
+    }
+
+    return &m_Frames[m_NextFrame++];
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "input/InputQueue.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ae
+{
+	struct ControllerStates;
+
+	// One connected pad as the window's controller snapshot held it
+	struct ControllerRecord
+	{
+		uint32_t id = 0;
+		uint16_t buttons = 0;
+		std::array<float, 6> axes = {};
+	};
+
+	// Input state a recording starts from, restored when it is replayed so held keys and buttons and the first
+	// mouse deltas match the recording rather than whatever is live at the time
+	struct InputStartState
+	{
+		float cursorX = 0.0f;
+		float cursorY = 0.0f;
+		std::vector<int32_t> keys; // Held keys
+		uint8_t buttons = 0; // One bit per held mouse button
+	};
+
+	// Everything a window consumed as input in one frame: the delta time its simulation saw, the state of every
+	// controller it knew of and the input records dispatched during the frame, in order
+	struct InputFrame
+	{
+		double deltaTime = 0.0;
+		std::vector<ControllerRecord> controllers;
+		std::vector<InputRecord> records;
+	};
+
+	// Collects frames and writes them to a compact binary file on Save. Records are stored field by field, so
+	// recordings do not depend on the padding of InputRecord and replay with any build of the same endianness.
+	class InputRecorder
+	{
+	public:
+		InputRecorder(const std::string& path, const InputStartState& startState);
+		InputRecorder(const InputRecorder&) = delete;
+		InputRecorder& operator=(const InputRecorder&) = delete;
+
+		// Finishes the previous frame and starts the next one
+		void BeginFrame(double deltaTime, const ControllerStates& controllers);
+		void Add(const InputRecord& record);
+
+		void Save();
+
+		inline uint32_t GetFrameCount() const { return m_FrameCount; }
+	private:
+		void FinishFrame();
+	private:
+		std::string m_Path;
+		std::vector<uint8_t> m_Data;
+		InputFrame m_Frame;
+		uint32_t m_FrameCount = 0;
+		bool m_FrameOpen = false;
+	};
+
+	// Reads a whole recording up front, so replaying never touches the disk between frames
+	class InputReplay
+	{
+	public:
+		InputReplay(const std::string& path);
+		InputReplay(const InputReplay&) = delete;
+		InputReplay& operator=(const InputReplay&) = delete;
+
+		// Null once every frame has been replayed
+		const InputFrame* NextFrame();
+
+		inline size_t GetFrameCount() const { return m_Frames.size(); }
+		inline const InputStartState& GetStartState() const { return m_StartState; }
+	private:
+		InputStartState m_StartState;
+		std::vector<InputFrame> m_Frames;
+		size_t m_NextFrame = 0;
+	};
+}
@@ -51,24 +51,60 @@ bool ae::Keyboard::WasKeyReleased(Key key) const
     return WasKeyReleased(static_cast<int32_t>(key));
 }
 
-std::string ae::Keyboard::GetTyped()
-{
-    std::string typed = m_Typed.str();
-    m_Typed.str("");
-    return typed;
-}
-
 void ae::Keyboard::SetKeyPressed(int32_t key, bool pressed)
 {
+    // GLFW reports keys it has no code for as GLFW_KEY_UNKNOWN
+    if (key < 0 || key > GLFW_KEY_LAST)
+    {
+        return;
+    }
+
     m_Keys[key] = pressed;
 }
 
-void ae::Keyboard::SetKeyTyped(int32_t key)
+void ae::Keyboard::SetKeyTyped(char32_t codepoint)
 {
-    m_Typed << static_cast<char>(key);
+    // Surrogates and values past the last plane are not characters
+    if ((codepoint >= 0xD800 && codepoint <= 0xDFFF) || codepoint > 0x10FFFF || m_TypedCount == s_TypedCapacity)
+    {
+        return;
+    }
+
+    m_Typed[m_TypedCount++] = codepoint;
+
+    char *pOut = m_TypedUtf8.data() + m_TypedUtf8Size;
+
+    if (codepoint < 0x80)
+    {
+        pOut[0] = static_cast<char>(codepoint);
+        m_TypedUtf8Size += 1;
+    }
+    else if (codepoint < 0x800)
+    {
+        pOut[0] = static_cast<char>(0xC0 | (codepoint >> 6));
+        pOut[1] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        m_TypedUtf8Size += 2;
+    }
+    else if (codepoint < 0x10000)
+    {
+        pOut[0] = static_cast<char>(0xE0 | (codepoint >> 12));
+        pOut[1] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        pOut[2] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        m_TypedUtf8Size += 3;
+    }
+    else
+    {
+        pOut[0] = static_cast<char>(0xF0 | (codepoint >> 18));
+        pOut[1] = static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        pOut[2] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        pOut[3] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        m_TypedUtf8Size += 4;
+    }
 }
 
 void ae::Keyboard::UpdatePreviousState()
 {
     m_PreviousKeys = m_Keys;
+    m_TypedCount = 0;
+    m_TypedUtf8Size = 0;
 }
@@ -3,7 +3,8 @@
 #include "Window.h"
 
 ae::Mouse::Mouse(Window *pWindow)
-    : m_pWindow(pWindow), m_DeltaX(0.0f), m_DeltaY(0.0f), m_ScrollX(0.0f), m_ScrollY(0.0f), m_Entered(false)
+    : m_pWindow(pWindow), m_X(0.0f), m_Y(0.0f), m_DeltaX(0.0f), m_DeltaY(0.0f), m_ScrollX(0.0f), m_ScrollY(0.0f),
+      m_Entered(false), m_MotionSamples{}, m_MotionSampleCount(0)
 {
 }
 
@@ -52,57 +53,59 @@ bool ae::Mouse::WasButtonReleased(MouseButton button) const
     return WasButtonReleased(static_cast<int32_t>(button));
 }
 
-float ae::Mouse::GetX() const
+const ae::MouseMotionSample &ae::Mouse::GetMotionSample(uint32_t index) const
 {
-    double x;
-    double y;
-    glfwGetCursorPos(m_pWindow->GetWindow(), &x, &y);
+    uint32_t first = m_MotionSampleCount - GetMotionSampleCount();
 
-    return static_cast<float>(x);
-}
-
-float ae::Mouse::GetY() const
-{
-    double x;
-    double y;
-    glfwGetCursorPos(m_pWindow->GetWindow(), &x, &y);
-
-    return static_cast<float>(y);
-}
-
-glm::vec2 ae::Mouse::GetPosition() const
-{
-    double x;
-    double y;
-    glfwGetCursorPos(m_pWindow->GetWindow(), &x, &y);
-
-    return { static_cast<float>(x), static_cast<float>(y) };
+    return m_MotionSamples[(first + index) & (s_MotionSampleCapacity - 1)];
 }
 
 void ae::Mouse::SetX(float x)
 {
-    glfwSetCursorPos(m_pWindow->GetWindow(), static_cast<double>(x), static_cast<double>(GetY()));
+    SetPosition(x, m_Y);
 }
 
 void ae::Mouse::SetY(float y)
 {
-    glfwSetCursorPos(m_pWindow->GetWindow(), static_cast<double>(GetX()), static_cast<double>(y));
+    SetPosition(m_X, y);
 }
 
 void ae::Mouse::SetPosition(float x, float y)
 {
     glfwSetCursorPos(m_pWindow->GetWindow(), static_cast<double>(x), static_cast<double>(y));
+
+    // A warp is not motion; a callback it triggers then reports no delta
+    SetCachedPosition(x, y);
 }
 
 void ae::Mouse::SetPressed(int32_t button, bool pressed)
 {
+    if (button < 0 || button > GLFW_MOUSE_BUTTON_LAST)
+    {
+        return;
+    }
+
     m_Buttons[button] = pressed;
 }
 
-void ae::Mouse::SetMoved(float x, float y)
+void ae::Mouse::SetMoved(float x, float y, double time)
+{
+    float deltaX = x - m_X;
+    float deltaY = y - m_Y;
+
+    m_DeltaX += deltaX;
+    m_DeltaY += deltaY;
+
+    m_MotionSamples[m_MotionSampleCount & (s_MotionSampleCapacity - 1)] = { deltaX, deltaY, time };
+    m_MotionSampleCount++;
+
+    SetCachedPosition(x, y);
+}
+
+void ae::Mouse::SetCachedPosition(float x, float y)
 {
-    m_DeltaX = x + m_DeltaX;
-    m_DeltaY = y + m_DeltaY;
+    m_X = x;
+    m_Y = y;
 }
 
 void ae::Mouse::SetScrolled(float x, float y)
@@ -119,4 +122,5 @@ void ae::Mouse::SetEntered(bool entered)
 void ae::Mouse::UpdatePreviousState()
 {
     m_PreviousButtons = m_Buttons;
+    m_MotionSampleCount = 0;
 }
@@ -6,8 +6,26 @@
 
 #include <print>
 
+// Exported by the GLFW backend without a declaration in its header
+ImGuiKey ImGui_ImplGlfw_KeyToImGuiKey(int keycode, int scancode);
+
+namespace
+{
+
+// The backend reads the modifiers with glfwGetKey, which only the main thread may call; the mods GLFW reported
+// with the event are used instead
+void AddKeyModifiers(ImGuiIO &io, int mods)
+{
+    io.AddKeyEvent(ImGuiMod_Ctrl, (mods & GLFW_MOD_CONTROL) != 0);
+    io.AddKeyEvent(ImGuiMod_Shift, (mods & GLFW_MOD_SHIFT) != 0);
+    io.AddKeyEvent(ImGuiMod_Alt, (mods & GLFW_MOD_ALT) != 0);
+    io.AddKeyEvent(ImGuiMod_Super, (mods & GLFW_MOD_SUPER) != 0);
+}
+
+} // namespace
+
 ae::Interface::Interface(Window &window)
-    : m_Window(window), m_pContext(nullptr), m_OnInterfaceUpdate(nullptr), m_Created(false)
+    : m_Window(window), m_pContext(nullptr), m_Time(0.0), m_Created(false)
 {
 }
 
@@ -66,27 +84,45 @@ void ae::Interface::Prepare()
 #endif // AE_DEBUG
     ImGui::SetCurrentContext(m_pContext);
     PrepareImpl();
+    ImGui_ImplGlfw_NewFrame();
 }
 
-void ae::Interface::Update()
+void ae::Interface::Prepare(const InterfacePlatformInput &input)
 {
 #ifdef AE_DEBUG
     if (!m_Created)
     {
-        AE_LOG(AE_WARNING, "Tried to update Interface but it was not created");
+        AE_LOG(AE_WARNING, "Tried to prepare Interface but it was not created");
         return;
     }
 #endif // AE_DEBUG
-    if (!m_OnInterfaceUpdate)
+    ImGui::SetCurrentContext(m_pContext);
+    PrepareImpl();
+
+    ImGuiIO &io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(input.width, input.height);
+    io.DisplayFramebufferScale = ImVec2(input.framebufferScaleX, input.framebufferScaleY);
+
+    // glfwGetTime may be called from any thread
+    double time = glfwGetTime();
+    io.DeltaTime = (m_Time > 0.0 && time > m_Time) ? static_cast<float>(time - m_Time) : 1.0f / 60.0f;
+    m_Time = time;
+}
+
+void ae::Interface::Update(Delegate<void()> &onUpdate)
+{
+#ifdef AE_DEBUG
+    if (!m_Created)
     {
+        AE_LOG(AE_WARNING, "Tried to update Interface but it was not created");
         return;
     }
-
+#endif // AE_DEBUG
     ImGui::SetCurrentContext(m_pContext);
 
     ImGui::NewFrame();
 
-    m_OnInterfaceUpdate();
+    onUpdate.Invoke();
 
     ImGui::Render();
 }
@@ -127,7 +163,25 @@ void ae::Interface::SendOnKeyEvent(int key, int scancode, int action, int mods)
 {
     ImGui::SetCurrentContext(m_pContext);
 
-    ImGui_ImplGlfw_KeyCallback(m_Window.GetWindow(), key, scancode, action, mods);
+    if (!m_Window.IsRenderThreadRunning())
+    {
+        ImGui_ImplGlfw_KeyCallback(m_Window.GetWindow(), key, scancode, action, mods);
+        return;
+    }
+
+    // The backend also untranslates the key by its name, another main-thread query, so shortcuts on the render
+    // thread follow the key position rather than the layout
+    if (action != GLFW_PRESS && action != GLFW_RELEASE)
+    {
+        return;
+    }
+
+    ImGuiIO &io = ImGui::GetIO();
+    AddKeyModifiers(io, mods);
+
+    ImGuiKey imguiKey = ImGui_ImplGlfw_KeyToImGuiKey(key, scancode);
+    io.AddKeyEvent(imguiKey, action == GLFW_PRESS);
+    io.SetKeyEventNativeData(imguiKey, key, scancode);
 }
 
 void ae::Interface::SendOnCharEvent(unsigned int c) const
@@ -141,7 +195,19 @@ void ae::Interface::SendOnMouseButtonEvent(int button, int action, int mods) con
 {
     ImGui::SetCurrentContext(m_pContext);
 
-    ImGui_ImplGlfw_MouseButtonCallback(m_Window.GetWindow(), button, action, mods);
+    if (!m_Window.IsRenderThreadRunning())
+    {
+        ImGui_ImplGlfw_MouseButtonCallback(m_Window.GetWindow(), button, action, mods);
+        return;
+    }
+
+    ImGuiIO &io = ImGui::GetIO();
+    AddKeyModifiers(io, mods);
+
+    if (button >= 0 && button < ImGuiMouseButton_COUNT)
+    {
+        io.AddMouseButtonEvent(button, action == GLFW_PRESS);
+    }
 }
 
 void ae::Interface::SendOnMouseMovedEvent(double x, double y) const
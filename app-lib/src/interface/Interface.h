@@ -1,7 +1,5 @@
 #pragma once
 
-#include <functional>
-
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
@@ -11,6 +9,16 @@
 
 namespace ae
 {
+	// What the GLFW backend would query from the window each frame. GLFW only allows those queries on the main
+	// thread, so frames prepared on a render thread get them from the window instead.
+	struct InterfacePlatformInput
+	{
+		float width = 0.0f;
+		float height = 0.0f;
+		float framebufferScaleX = 1.0f;
+		float framebufferScaleY = 1.0f;
+	};
+
 	class Interface
 	{
 	public:
@@ -21,8 +29,10 @@ namespace ae
 
 		void Create();
 
+		// Uses the GLFW backend, so main thread only; the overload takes the platform input from the caller
 		void Prepare();
-		void Update();
+		void Prepare(const InterfacePlatformInput& input);
+		void Update(Delegate<void()>& onUpdate);
 		void Finish();
 
 		void Destroy();
@@ -43,8 +53,6 @@ namespace ae
 
 		void SendOnMonitorEvent(GLFWmonitor* pMonitor, int event) const;
 
-		inline void SetOnInterfaceUpdateCB(const std::function<void()>& cb) { m_OnInterfaceUpdate = cb; }
-		inline bool HasCallback() const { return static_cast<bool>(m_OnInterfaceUpdate); }
 	protected:
 		virtual bool CreateImpl() = 0;
 		virtual void DestroyImpl() = 0;
@@ -57,7 +65,7 @@ namespace ae
 	protected:
 		Window& m_Window;
 		ImGuiContext* m_pContext;
-		std::function<void()> m_OnInterfaceUpdate;
+		double m_Time;
 		bool m_Created;
 	private:
 		static constexpr std::array<std::string_view, 1> s_FontPaths =
@@ -25,7 +25,6 @@ void ae::OpenGLInterface::DestroyImpl()
 void ae::OpenGLInterface::PrepareImpl()
 {
     ImGui_ImplOpenGL3_NewFrame();
-    ImGui_ImplGlfw_NewFrame();
 }
 
 void ae::OpenGLInterface::FinishImpl()
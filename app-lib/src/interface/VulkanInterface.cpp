@@ -44,13 +44,29 @@ bool ae::VulkanInterface::CreateImpl()
     init_info.Device = VulkanManager::Get().GetDevice();
     init_info.QueueFamily = VulkanManager::Get().GetGraphicsQueueFamilyIndex();
     init_info.Queue = pVulkanContext->GetGraphicsQueue();
-    init_info.PipelineCache = VK_NULL_HANDLE;
+    init_info.PipelineCache = VulkanManager::Get().GetPipelineCache();
     init_info.DescriptorPool = m_DescriptorPool;
     init_info.Allocator = nullptr;
     init_info.MinImageCount = 2;
     init_info.ImageCount = static_cast<uint32_t>(pVulkanContext->GetSwapChainImages().size());
     init_info.CheckVkResultFn = nullptr;
-    init_info.PipelineInfoMain.RenderPass = pVulkanContext->GetImGuiStandaloneRenderPass();
+    init_info.ApiVersion = VK_API_VERSION_1_2;
+
+    // The backend deep-copies the format array, so pointing at a local is fine
+    VkFormat colorFormat = pVulkanContext->GetSwapChainImageFormat();
+
+    if (pVulkanContext->IsDynamicRenderingEnabled())
+    {
+        init_info.UseDynamicRendering = true;
+        init_info.PipelineInfoMain.PipelineRenderingCreateInfo.sType =
+            VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+        init_info.PipelineInfoMain.PipelineRenderingCreateInfo.colorAttachmentCount = 1;
+        init_info.PipelineInfoMain.PipelineRenderingCreateInfo.pColorAttachmentFormats = &colorFormat;
+    }
+    else
+    {
+        init_info.PipelineInfoMain.RenderPass = pVulkanContext->GetImGuiStandaloneRenderPass();
+    }
 
     ImGui_ImplVulkan_Init(&init_info);
 
@@ -59,7 +75,14 @@ bool ae::VulkanInterface::CreateImpl()
 
 void ae::VulkanInterface::DestroyImpl()
 {
-    vkDeviceWaitIdle(VulkanManager::Get().GetDevice());
+    // ImGui's objects are only used by this window's frames, and the context outlives the interface
+    std::shared_ptr<VulkanContext> pVulkanContext =
+        std::dynamic_pointer_cast<VulkanContext>(m_Window.GetContext().lock());
+
+    if (pVulkanContext)
+    {
+        pVulkanContext->WaitForSubmittedFrames();
+    }
 
     ImGui_ImplVulkan_Shutdown();
     ImGui_ImplGlfw_Shutdown();
@@ -70,7 +93,6 @@ void ae::VulkanInterface::DestroyImpl()
 void ae::VulkanInterface::PrepareImpl()
 {
     ImGui_ImplVulkan_NewFrame();
-    ImGui_ImplGlfw_NewFrame();
 }
 
 void ae::VulkanInterface::FinishImpl()
@@ -0,0 +1,154 @@
+#include "general/pch.h"
+
+#ifdef AE_VULKAN
+
+// The VMA implementation is compiled exactly once, here
+#define VMA_IMPLEMENTATION
+#include <vk_mem_alloc.h>
+
+#include "Vulkan.h"
+
+#include <atomic>
+
+namespace
+{
+
+struct CategoryCounters
+{
+    std::atomic<uint64_t> allocationCount{ 0 };
+    std::atomic<uint64_t> allocationBytes{ 0 };
+};
+
+std::array<CategoryCounters, static_cast<size_t>(ae::VulkanMemoryCategory::COUNT)> s_CategoryCounters;
+
+// The category is stored in the allocation's user data, offset by one so a null pointer means "untracked"
+void *EncodeCategory(ae::VulkanMemoryCategory category)
+{
+    return reinterpret_cast<void *>(static_cast<uintptr_t>(category) + 1);
+}
+
+void TrackAllocation(VmaAllocator allocator, VmaAllocation allocation, ae::VulkanMemoryCategory category)
+{
+    VmaAllocationInfo info;
+    vmaGetAllocationInfo(allocator, allocation, &info);
+
+    CategoryCounters &counters = s_CategoryCounters[static_cast<size_t>(category)];
+    counters.allocationCount.fetch_add(1, std::memory_order_relaxed);
+    counters.allocationBytes.fetch_add(info.size, std::memory_order_relaxed);
+}
+
+void UntrackAllocation(VmaAllocator allocator, VmaAllocation allocation)
+{
+    VmaAllocationInfo info;
+    vmaGetAllocationInfo(allocator, allocation, &info);
+
+    uintptr_t encoded = reinterpret_cast<uintptr_t>(info.pUserData);
+
+    if (encoded == 0 || encoded > static_cast<uintptr_t>(ae::VulkanMemoryCategory::COUNT))
+    {
+        return;
+    }
+
+    CategoryCounters &counters = s_CategoryCounters[encoded - 1];
+    counters.allocationCount.fetch_sub(1, std::memory_order_relaxed);
+    counters.allocationBytes.fetch_sub(info.size, std::memory_order_relaxed);
+}
+
+} // namespace
+
+VkResult ae::VulkanCreateBuffer(VmaAllocator allocator, const VkBufferCreateInfo &bufferInfo,
+                                const VmaAllocationCreateInfo &allocationInfo, VulkanMemoryCategory category,
+                                VkBuffer *pBuffer, VmaAllocation *pAllocation, VmaAllocationInfo *pAllocationInfo)
+{
+    VmaAllocationCreateInfo taggedInfo = allocationInfo;
+    taggedInfo.pUserData = EncodeCategory(category);
+
+    VkResult result = vmaCreateBuffer(allocator, &bufferInfo, &taggedInfo, pBuffer, pAllocation, pAllocationInfo);
+
+    if (result == VK_SUCCESS)
+    {
+        TrackAllocation(allocator, *pAllocation, category);
+    }
+
+    return result;
+}
+
+void ae::VulkanDestroyBuffer(VmaAllocator allocator, VkBuffer buffer, VmaAllocation allocation)
+{
+    if (allocation != VK_NULL_HANDLE)
+    {
+        UntrackAllocation(allocator, allocation);
+    }
+
+    vmaDestroyBuffer(allocator, buffer, allocation);
+}
+
+VkResult ae::VulkanCreateImage(VmaAllocator allocator, const VkImageCreateInfo &imageInfo,
+                               const VmaAllocationCreateInfo &allocationInfo, VulkanMemoryCategory category,
+                               VkImage *pImage, VmaAllocation *pAllocation, VmaAllocationInfo *pAllocationInfo)
+{
+    VmaAllocationCreateInfo taggedInfo = allocationInfo;
+    taggedInfo.pUserData = EncodeCategory(category);
+
+    VkResult result = vmaCreateImage(allocator, &imageInfo, &taggedInfo, pImage, pAllocation, pAllocationInfo);
+
+    if (result == VK_SUCCESS)
+    {
+        TrackAllocation(allocator, *pAllocation, category);
+    }
+
+    return result;
+}
+
+void ae::VulkanDestroyImage(VmaAllocator allocator, VkImage image, VmaAllocation allocation)
+{
+    if (allocation != VK_NULL_HANDLE)
+    {
+        UntrackAllocation(allocator, allocation);
+    }
+
+    vmaDestroyImage(allocator, image, allocation);
+}
+
+ae::VulkanMemoryStats ae::VulkanGetMemoryStats()
+{
+    VulkanMemoryStats stats{};
+
+    for (size_t i = 0; i < s_CategoryCounters.size(); i++)
+    {
+        stats.categories[i].allocationCount = s_CategoryCounters[i].allocationCount.load(std::memory_order_relaxed);
+        stats.categories[i].allocationBytes = s_CategoryCounters[i].allocationBytes.load(std::memory_order_relaxed);
+
+        stats.totalAllocationCount += stats.categories[i].allocationCount;
+        stats.totalAllocationBytes += stats.categories[i].allocationBytes;
+    }
+
+    return stats;
+}
+
+std::vector<ae::VulkanHeapBudget> ae::VulkanGetMemoryBudgets(VmaAllocator allocator)
+{
+    const VkPhysicalDeviceMemoryProperties *pMemoryProperties = nullptr;
+    vmaGetMemoryProperties(allocator, &pMemoryProperties);
+
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+    vmaGetHeapBudgets(allocator, budgets.data());
+
+    std::vector<VulkanHeapBudget> result(pMemoryProperties->memoryHeapCount);
+
+    for (uint32_t i = 0; i < pMemoryProperties->memoryHeapCount; i++)
+    {
+        result[i].heapIndex = i;
+        result[i].flags = pMemoryProperties->memoryHeaps[i].flags;
+        result[i].blockCount = budgets[i].statistics.blockCount;
+        result[i].allocationCount = budgets[i].statistics.allocationCount;
+        result[i].blockBytes = budgets[i].statistics.blockBytes;
+        result[i].allocationBytes = budgets[i].statistics.allocationBytes;
+        result[i].usage = budgets[i].usage;
+        result[i].budget = budgets[i].budget;
+    }
+
+    return result;
+}
+
+#endif // AE_VULKAN
@@ -1,12 +1,20 @@
 #include "general/pch.h"
 
+#include "Files.h"
 #include "Log.h"
 #include "OpenGL.h"
 #include "Vulkan.h"
 #include "Window.h"
 #include "graphics/Context.h"
+#include "graphics/FrameCapture.h"
 #include "graphics/OpenGLContext.h"
+#include "graphics/VulkanCommandAllocator.h"
 #include "graphics/VulkanContext.h"
+#include "graphics/VulkanDeletionQueue.h"
+#include "graphics/VulkanShaderRegistry.h"
+#include "graphics/VulkanUploadManager.h"
+#include "input/InputQueue.h"
+#include "input/InputReplay.h"
 #include "interface/Interface.h"
 #include "interface/OpenGLInterface.h"
 #include "interface/VulkanInterface.h"
@@ -138,6 +146,8 @@ void ae::Window::Create()
 #endif // AE_VULKAN
         }
 
+        m_pInputQueue = std::make_unique<InputQueue>();
+
         ae::WindowManager::Get().AddWindow(this);
 
         InitInput();
@@ -176,6 +186,19 @@ void ae::Window::Destroy()
     }
 #endif // AE_DEBUG
 
+    // Takes the context back from the render thread, if there is one
+    StopRenderThread();
+
+    if (m_pInputRecorder)
+    {
+        StopInputRecording();
+    }
+
+    m_pInputReplay.reset();
+
+    // Captures still in flight read from buffers owned by the context
+    FlushCaptures();
+
     if (m_Desc.graphicsAPI == GraphicsAPI::OPENGL)
     {
         DestroyOpenGL();
@@ -223,16 +246,22 @@ ae::FrameInfo ae::Window::BeginFrame()
 #endif // AE_DEBUG
 
     m_FrameInProgress = true;
+    m_FrameThread = std::this_thread::get_id();
 
-    // Update previous input state before processing new events
-    m_Keyboard.UpdatePreviousState();
-    m_Mouse.UpdatePreviousState();
-
-    if (m_Desc.type != WindowType::HEADLESS)
+    // With a render thread the main thread polls, also before it has entered the event loop
+    if (m_Desc.type != WindowType::HEADLESS && !IsRenderThreadRunning() &&
+        !ae::WindowManager::Get().IsEventLoopRunning())
     {
         glfwPollEvents();
     }
 
+    DispatchDeferredEvents();
+
+    if (m_Desc.inputDispatch == InputDispatch::BEGIN_FRAME)
+    {
+        DispatchInput();
+    }
+
     if (m_Desc.graphicsAPI == GraphicsAPI::OPENGL)
     {
         GL_CHECK(glClearColor(m_ClearColor[0], m_ClearColor[1], m_ClearColor[2], m_ClearColor[3]));
@@ -243,7 +272,7 @@ ae::FrameInfo ae::Window::BeginFrame()
 #ifdef AE_VULKAN
     if (m_Desc.graphicsAPI == GraphicsAPI::VULKAN)
     {
-        std::shared_ptr<ae::VulkanContext> pContext = std::dynamic_pointer_cast<ae::VulkanContext>(m_pContext);
+        VulkanContext *pContext = m_pVulkanContext;
 #ifdef AE_DEBUG
         if (!pContext)
         {
@@ -277,17 +306,88 @@ void ae::Window::EndFrame(std::initializer_list<VkCommandBuffer> commandBuffers)
     EndFrameVulkan(commandBuffers.begin(), static_cast<uint32_t>(commandBuffers.size()));
 }
 
-void ae::Window::SetOnSwapchainRecreatedCB(const std::function<void(const VulkanResources &)> &cb)
+void ae::Window::EndFrame(std::span<const VkCommandBuffer> commandBuffers)
+{
+    EndFrameVulkan(commandBuffers.data(), static_cast<uint32_t>(commandBuffers.size()));
+}
+#endif // AE_VULKAN
+
+uint32_t ae::Window::GetDefaultFramebuffer() const
+{
+    if (m_Desc.graphicsAPI != GraphicsAPI::OPENGL || !m_pContext)
+    {
+        return 0;
+    }
+
+    return static_cast<const OpenGLContext *>(m_pContext.get())->GetDefaultFramebuffer();
+}
+
+void ae::Window::CaptureFrame(const std::function<void(ImageFile<uint8_t> &, uint64_t)> &cb)
+{
+    GetFrameCapture().AddRequest({ .callback = cb, .path = {} });
+}
+
+void ae::Window::CaptureFrame(const std::string &path)
+{
+    GetFrameCapture().AddRequest({ .callback = nullptr, .path = path });
+}
+
+void ae::Window::StartCapture(const std::string &directory)
+{
+    GetFrameCapture().StartContinuous(directory);
+}
+
+void ae::Window::StopCapture()
+{
+    if (m_pFrameCapture)
+    {
+        m_pFrameCapture->StopContinuous();
+    }
+}
+
+bool ae::Window::IsCapturing() const
+{
+    return m_pFrameCapture && m_pFrameCapture->IsContinuous();
+}
+
+void ae::Window::FlushCaptures()
 {
-    m_OnSwapchainRecreated = cb;
+    if (!m_pFrameCapture)
+    {
+        return;
+    }
 
-    std::shared_ptr<ae::VulkanContext> pContext = std::dynamic_pointer_cast<ae::VulkanContext>(m_pContext);
-    if (pContext)
+    if (m_Desc.graphicsAPI == GraphicsAPI::OPENGL)
+    {
+        static_cast<OpenGLContext *>(m_pContext.get())->FlushCaptures(*m_pFrameCapture);
+    }
+#ifdef AE_VULKAN
+    else if (m_Desc.graphicsAPI == GraphicsAPI::VULKAN)
     {
-        pContext->SetOnSwapchainRecreatedCB(cb);
+        m_pVulkanContext->FlushCaptures();
     }
+#endif // AE_VULKAN
+
+    m_pFrameCapture->Flush();
 }
+
+ae::FrameCapture &ae::Window::GetFrameCapture()
+{
+    // Created on first use, since the worker threads are only worth having for apps that capture
+    if (!m_pFrameCapture)
+    {
+        m_pFrameCapture = std::make_unique<FrameCapture>();
+
+#ifdef AE_VULKAN
+        if (m_pVulkanContext)
+        {
+            m_pVulkanContext->SetFrameCapture(m_pFrameCapture.get());
+        }
 #endif // AE_VULKAN
+    }
+
+    return *m_pFrameCapture;
+}
 
 void ae::Window::EndFrameOpenGL()
 {
@@ -299,15 +399,22 @@ void ae::Window::EndFrameOpenGL()
     }
 #endif // AE_DEBUG
 
-    if (m_Desc.type != WindowType::HEADLESS)
+    if (m_Desc.type != WindowType::HEADLESS && !m_OnInterfaceUpdate.IsEmpty())
     {
-        if (m_pInterface->HasCallback())
-        {
-            m_pInterface->Prepare();
-            m_pInterface->Update();
-            m_pInterface->Finish();
-        }
+        PrepareInterface();
+        m_pInterface->Update(m_OnInterfaceUpdate);
+        m_pInterface->Finish();
+    }
+
+    // The back buffer is read before the swap, so the capture includes the interface
+    if (m_pFrameCapture)
+    {
+        // Numbered from 1 like Vulkan frames; the count is only incremented once the frame has ended
+        static_cast<OpenGLContext *>(m_pContext.get())->CaptureFrame(*m_pFrameCapture, m_TotalFrameCount + 1);
+    }
 
+    if (m_Desc.type != WindowType::HEADLESS)
+    {
         glfwSwapBuffers(m_pWindow);
     }
 
@@ -326,7 +433,7 @@ void ae::Window::EndFrameVulkan(const VkCommandBuffer *commandBuffers, uint32_t
     }
 #endif // AE_DEBUG
 
-    std::shared_ptr<ae::VulkanContext> pContext = std::dynamic_pointer_cast<ae::VulkanContext>(m_pContext);
+    VulkanContext *pContext = m_pVulkanContext;
 #ifdef AE_DEBUG
     if (!pContext)
     {
@@ -334,12 +441,12 @@ void ae::Window::EndFrameVulkan(const VkCommandBuffer *commandBuffers, uint32_t
     }
 #endif // AE_DEBUG
 
-    bool hasImGui = m_pInterface && m_pInterface->HasCallback();
+    bool hasImGui = m_pInterface && !m_OnInterfaceUpdate.IsEmpty();
 
     if (hasImGui)
     {
-        m_pInterface->Prepare();
-        m_pInterface->Update();
+        PrepareInterface();
+        m_pInterface->Update(m_OnInterfaceUpdate);
         m_pInterface->Finish();
     }
 
@@ -354,6 +461,11 @@ VkResult ae::Window::SubmitToQueue(const VkSubmitInfo &submitInfo, VkFence fence
     return VulkanManager::Get().SubmitToQueue(submitInfo, fence);
 }
 
+VkResult ae::Window::SubmitToQueue(VulkanQueueType type, const VkSubmitInfo &submitInfo, VkFence fence)
+{
+    return VulkanManager::Get().SubmitToQueue(type, submitInfo, fence);
+}
+
 VkResult ae::Window::PresentToQueue(const VkPresentInfoKHR &presentInfo)
 {
     return VulkanManager::Get().PresentToQueue(presentInfo);
@@ -363,6 +475,218 @@ void ae::Window::WaitQueueIdle()
 {
     VulkanManager::Get().WaitQueueIdle();
 }
+
+void ae::Window::WaitQueueIdle(VulkanQueueType type)
+{
+    VulkanManager::Get().WaitQueueIdle(type);
+}
+
+void ae::Window::UploadBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void *pData, VkDeviceSize size)
+{
+    VulkanManager::Get().GetUploadManager().UploadBuffer(dstBuffer, dstOffset, pData, size);
+}
+
+void ae::Window::UploadImage(VkImage dstImage, VkExtent3D extent, const void *pData, VkDeviceSize size,
+                             VkImageLayout finalLayout)
+{
+    VulkanManager::Get().GetUploadManager().UploadImage(dstImage, extent, pData, size, finalLayout);
+}
+
+void ae::Window::UploadImage(VkImage dstImage, const ImageFile<uint8_t> &image, VkImageLayout finalLayout)
+{
+    const std::vector<uint8_t> &data = image.GetData();
+    VkExtent3D extent = { image.GetWidth(), image.GetHeight(), 1 };
+
+    VulkanManager::Get().GetUploadManager().UploadImage(dstImage, extent, data.data(), data.size(), finalLayout);
+}
+
+uint64_t ae::Window::FlushUploads()
+{
+    return VulkanManager::Get().GetUploadManager().Flush();
+}
+
+bool ae::Window::IsUploadComplete(uint64_t value) const
+{
+    return VulkanManager::Get().GetUploadManager().IsComplete(value);
+}
+
+void ae::Window::WaitForUpload(uint64_t value) const
+{
+    VulkanManager::Get().GetUploadManager().Wait(value);
+}
+
+uint64_t ae::Window::GetCurrentFrameNumber() const
+{
+    VulkanContext *pContext = m_pVulkanContext;
+#ifdef AE_DEBUG
+    if (!pContext)
+    {
+        AE_THROW_RUNTIME_ERROR("Vulkan context is null in GetCurrentFrameNumber");
+    }
+#endif // AE_DEBUG
+
+    return pContext->GetCurrentFrameNumber();
+}
+
+uint64_t ae::Window::GetCompletedFrameNumber() const
+{
+    VulkanContext *pContext = m_pVulkanContext;
+#ifdef AE_DEBUG
+    if (!pContext)
+    {
+        AE_THROW_RUNTIME_ERROR("Vulkan context is null in GetCompletedFrameNumber");
+    }
+#endif // AE_DEBUG
+
+    return pContext->GetCompletedFrameNumber();
+}
+
+bool ae::Window::IsFrameComplete(uint64_t frameNumber) const
+{
+    VulkanContext *pContext = m_pVulkanContext;
+#ifdef AE_DEBUG
+    if (!pContext)
+    {
+        AE_THROW_RUNTIME_ERROR("Vulkan context is null in IsFrameComplete");
+    }
+#endif // AE_DEBUG
+
+    return pContext->IsFrameComplete(frameNumber);
+}
+
+void ae::Window::WaitForFrame(uint64_t frameNumber) const
+{
+    VulkanContext *pContext = m_pVulkanContext;
+#ifdef AE_DEBUG
+    if (!pContext)
+    {
+        AE_THROW_RUNTIME_ERROR("Vulkan context is null in WaitForFrame");
+    }
+#endif // AE_DEBUG
+
+    pContext->WaitForFrame(frameNumber);
+}
+
+void ae::Window::AddHostDependency(uint64_t value)
+{
+    VulkanContext *pContext = m_pVulkanContext;
+#ifdef AE_DEBUG
+    if (!pContext)
+    {
+        AE_THROW_RUNTIME_ERROR("Vulkan context is null in AddHostDependency");
+    }
+#endif // AE_DEBUG
+
+    pContext->AddHostDependency(value);
+}
+
+void ae::Window::SignalHost(uint64_t value)
+{
+    VulkanContext *pContext = m_pVulkanContext;
+#ifdef AE_DEBUG
+    if (!pContext)
+    {
+        AE_THROW_RUNTIME_ERROR("Vulkan context is null in SignalHost");
+    }
+#endif // AE_DEBUG
+
+    pContext->SignalHost(value);
+}
+
+ae::PresentMode ae::Window::GetPresentMode() const
+{
+    VulkanContext *pContext = m_pVulkanContext;
+#ifdef AE_DEBUG
+    if (!pContext)
+    {
+        AE_THROW_RUNTIME_ERROR("Vulkan context is null in GetPresentMode");
+    }
+#endif // AE_DEBUG
+
+    return pContext->GetPresentMode();
+}
+
+double ae::Window::GetPresentLatency() const
+{
+    VulkanContext *pContext = m_pVulkanContext;
+#ifdef AE_DEBUG
+    if (!pContext)
+    {
+        AE_THROW_RUNTIME_ERROR("Vulkan context is null in GetPresentLatency");
+    }
+#endif // AE_DEBUG
+
+    return pContext->GetPresentLatency();
+}
+
+VkCommandBuffer ae::Window::AllocateCommandBuffer(VkCommandBufferLevel level)
+{
+    VulkanContext *pContext = m_pVulkanContext;
+#ifdef AE_DEBUG
+    if (!pContext)
+    {
+        AE_THROW_RUNTIME_ERROR("Vulkan context is null in AllocateCommandBuffer");
+    }
+#endif // AE_DEBUG
+
+    return pContext->GetCommandAllocator().Allocate(level);
+}
+
+void ae::Window::RecordParallel(std::span<VkCommandBuffer> commandBuffers,
+                                const VkCommandBufferInheritanceInfo *pInheritance,
+                                const std::function<void(VkCommandBuffer, uint32_t)> &record)
+{
+    VulkanContext *pContext = m_pVulkanContext;
+#ifdef AE_DEBUG
+    if (!pContext)
+    {
+        AE_THROW_RUNTIME_ERROR("Vulkan context is null in RecordParallel");
+    }
+#endif // AE_DEBUG
+
+    pContext->GetCommandAllocator().RecordParallel(commandBuffers, pInheritance, record);
+}
+
+VkShaderModule ae::Window::AcquireShaderModule(const std::string &path)
+{
+    return VulkanManager::Get().GetShaderRegistry().Acquire(path);
+}
+
+void ae::Window::ReleaseShaderModule(const std::string &path)
+{
+    VulkanManager::Get().GetShaderRegistry().Release(path);
+}
+
+void ae::Window::ListenForShaderChanges()
+{
+    if (m_ShaderListenerId != 0)
+    {
+        return;
+    }
+
+    m_ShaderListenerId = VulkanManager::Get().GetShaderRegistry().AddListener(
+        [this](const std::string &path, VkShaderModule module) { m_OnShaderChanged.Invoke(path, module); });
+}
+
+void ae::Window::DestroyDeferred(VkBuffer buffer, VmaAllocation allocation)
+{
+    VulkanManager::Get().GetDeletionQueue().Enqueue(buffer, allocation);
+}
+
+void ae::Window::DestroyDeferred(VkImage image, VmaAllocation allocation)
+{
+    VulkanManager::Get().GetDeletionQueue().Enqueue(image, allocation);
+}
+
+void ae::Window::DestroyDeferred(VkObjectType type, uint64_t handle)
+{
+    VulkanManager::Get().GetDeletionQueue().Enqueue(type, handle);
+}
+
+void ae::Window::DestroyDeferred(std::function<void()> destroy)
+{
+    VulkanManager::Get().GetDeletionQueue().Enqueue(std::move(destroy));
+}
 #endif // AE_VULKAN
 
 void ae::Window::HandleFrameTiming()
@@ -371,10 +695,17 @@ void ae::Window::HandleFrameTiming()
     m_FrameTimeSum += m_FrameTime;
     m_TotalFrameCount++;
 
-    if (!m_Desc.vsync)
+    double targetTime = m_Desc.vsync ? 0.0 : 1.0 / static_cast<double>(m_Desc.fps);
+
+    // A replay paces itself to the recording; vsync, when enabled, still throttles presentation
+    if (m_pInputReplay)
+    {
+        targetTime = m_ReplayTiming == ReplayTiming::FIXED ? m_ReplayDeltaTime : 0.0;
+    }
+
+    if (targetTime > 0.0)
     {
         double elapsedTime = m_Timer.GetElapsedTime();
-        double targetTime = 1.0 / static_cast<double>(m_Desc.fps);
 
         if (elapsedTime < targetTime)
         {
@@ -675,6 +1006,20 @@ glm::vec2 ae::Window::GetContentScale() const
     return { xScale, yScale };
 }
 
+glm::ivec2 ae::Window::GetFramebufferSize() const
+{
+    // GLFW only allows the query on the main thread
+    if (std::this_thread::get_id() == m_RenderThread.get_id())
+    {
+        return { m_PlatformState.framebufferWidth, m_PlatformState.framebufferHeight };
+    }
+
+    int width = 0;
+    int height = 0;
+    glfwGetFramebufferSize(m_pWindow, &width, &height);
+    return { width, height };
+}
+
 glm::vec2 ae::Window::GetMonitorPhysicalSize() const
 {
     int widthMM = 0;
@@ -753,6 +1098,13 @@ void ae::Window::LockCursor()
 #endif // AE_DEBUG
 
     glfwSetInputMode(m_pWindow, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // Unaccelerated motion, which is what camera control wants
+    if (glfwRawMouseMotionSupported())
+    {
+        glfwSetInputMode(m_pWindow, GLFW_RAW_MOUSE_MOTION, GLFW_TRUE);
+    }
+
     m_CursorLocked = true;
 }
 
@@ -766,6 +1118,11 @@ void ae::Window::UnlockCursor()
     }
 #endif // AE_DEBUG
 
+    if (glfwRawMouseMotionSupported())
+    {
+        glfwSetInputMode(m_pWindow, GLFW_RAW_MOUSE_MOTION, GLFW_FALSE);
+    }
+
     glfwSetInputMode(m_pWindow, GLFW_CURSOR, m_CursorVisible ? GLFW_CURSOR_NORMAL : GLFW_CURSOR_HIDDEN);
     m_CursorLocked = false;
 }
@@ -780,7 +1137,8 @@ void ae::Window::CenterCursor()
     }
 #endif // AE_DEBUG
 
-    glfwSetCursorPos(m_pWindow, static_cast<double>(m_Desc.width) / 2.0, static_cast<double>(m_Desc.height) / 2.0);
+    // Through the mouse, so the cached position follows the warp and the next move is not measured from before it
+    m_Mouse.SetPosition(static_cast<float>(m_Desc.width) / 2.0f, static_cast<float>(m_Desc.height) / 2.0f);
 }
 
 void ae::Window::SetActive()
@@ -795,30 +1153,6 @@ void ae::Window::SetActive()
     m_pContext->Activate();
 }
 
-void ae::Window::SetOnInterfaceUpdateCB(const std::function<void()> &cb)
-{
-#ifdef AE_DEBUG
-    if (!m_Created)
-    {
-        AE_LOG(AE_WARNING, "Tried to set interface update callback but the Window is not created");
-        return;
-    }
-
-    if (m_Desc.type == WindowType::HEADLESS)
-    {
-        AE_LOG(AE_WARNING, "Tried to set interface update callback but this is not applicable to headless windows");
-        return;
-    }
-
-    if (!m_pInterface)
-    {
-        AE_LOG(AE_WARNING, "Tried to set interface update callback but the Interface for the Window is not created");
-        return;
-    }
-#endif // AE_DEBUG
-    m_pInterface->SetOnInterfaceUpdateCB(cb);
-}
-
 void ae::Window::AddChild(Window &child)
 {
     m_Children.push_back(&child);
@@ -978,7 +1312,10 @@ void ae::Window::CreateHeadless()
 {
     GLFWwindow *pShare = nullptr;
 
-    if (m_pParent)
+    // Surfaceless contexts are created through EGL, so the GLFW window has no context to share
+    bool hasWindowContext = m_Desc.graphicsAPI == GraphicsAPI::OPENGL && !UsesSurfacelessContext();
+
+    if (m_pParent && hasWindowContext)
     {
         pShare = m_pParent->m_pWindow;
     }
@@ -988,12 +1325,34 @@ void ae::Window::CreateHeadless()
                                  nullptr, pShare);
 }
 
-void ae::Window::InitOpenGL()
+bool ae::Window::UsesSurfacelessContext() const
 {
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    glfwWindowHint(GLFW_DOUBLEBUFFER, true);
+#ifdef AE_EGL
+    // A GLX or GLFW-made context cannot share objects with an EGL one
+    bool sharesWindowContext = m_pParent && m_pParent->m_Desc.graphicsAPI == GraphicsAPI::OPENGL &&
+                               !m_pParent->UsesSurfacelessContext();
+
+    return m_Desc.type == WindowType::HEADLESS && m_Desc.graphicsAPI == GraphicsAPI::OPENGL && !sharesWindowContext;
+#else  // AE_EGL
+    return false;
+#endif // AE_EGL
+}
+
+void ae::Window::InitOpenGL()
+{
+    // Surfaceless EGL contexts need no X11 or Wayland display; the GLFW window is only kept as a handle
+    if (UsesSurfacelessContext())
+    {
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+        return;
+    }
+
+    // Reset after a Vulkan window set GLFW_NO_API
+    glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_API);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_DOUBLEBUFFER, true);
 }
 
 #ifdef AE_VULKAN
@@ -1057,22 +1416,48 @@ void ae::Window::CreateOpenGL()
 #ifdef AE_VULKAN
 void ae::Window::CreateVulkan()
 {
-    if (!glfwVulkanSupported())
+    // Headless contexts never create a surface, so they work without GLFW's Vulkan support
+    if (m_Desc.type != WindowType::HEADLESS && !glfwVulkanSupported())
     {
         AE_THROW_RUNTIME_ERROR("Vulkan is not supported");
     }
 
-    m_pContext = std::make_shared<ae::VulkanContext>(*this);
+    std::shared_ptr<ae::VulkanContext> pContext = std::make_shared<ae::VulkanContext>(*this);
+    m_pContext = pContext;
     m_pContext->Create();
 
-    if (m_Desc.vsync)
+    // Cached so the per-frame path needs neither a dynamic cast nor a reference count
+    m_pVulkanContext = pContext.get();
+    pContext->SetOnSwapchainRecreatedCB([this](const VulkanResources &resources)
+                                        { m_OnSwapchainRecreated.Invoke(resources); });
+
+    // Subscriptions outlive the window being destroyed and created again; the registry listener does not
+    if (!m_OnShaderChanged.IsEmpty())
+    {
+        ListenForShaderChanges();
+    }
+
+    if (m_pFrameCapture)
+    {
+        pContext->SetFrameCapture(m_pFrameCapture.get());
+    }
+
+    // Nothing is presented, so there is no display to pace against
+    if (m_Desc.type == WindowType::HEADLESS)
     {
         m_Desc.vsync = false;
+    }
 
+    if (m_Desc.vsync)
+    {
         GLFWmonitor *pMonitor = GetTargetMonitor();
         const GLFWvidmode *pVideoMode = glfwGetVideoMode(pMonitor);
 
         m_Desc.fps = static_cast<uint32_t>(pVideoMode->refreshRate);
+
+        // FIFO modes are paced by the presentation engine; any other mode falls back to the frame limiter
+        PresentMode presentMode = pContext->GetPresentMode();
+        m_Desc.vsync = presentMode == PresentMode::FIFO || presentMode == PresentMode::FIFO_RELAXED;
     }
 
     if (m_Desc.fps == 0)
@@ -1111,7 +1496,16 @@ void ae::Window::DestroyVulkan()
         m_pInterface->Destroy();
     }
 
+    VulkanShaderRegistry *pShaders = VulkanManager::Get().FindShaderRegistry();
+
+    if (pShaders && m_ShaderListenerId != 0)
+    {
+        pShaders->RemoveListener(m_ShaderListenerId);
+        m_ShaderListenerId = 0;
+    }
+
     m_pContext->Destroy();
+    m_pVulkanContext = nullptr;
 }
 #endif // AE_VULKAN
 
@@ -1121,153 +1515,722 @@ void ae::Window::InitInput()
     {
         if (ae::Controller::IsConnected(controllerIndex))
         {
-            m_Controllers.emplace_back(controllerIndex);
+            m_Controllers.emplace_back(controllerIndex, m_ControllerSnapshot);
         }
     }
 
     AE_LOG(AE_TRACE, "Controllers connected: {}", m_Controllers.size());
+
+    // Seeds the cached position, which the cursor callbacks keep up to date from here on
+    double x;
+    double y;
+    glfwGetCursorPos(m_pWindow, &x, &y);
+    m_Mouse.SetCachedPosition(static_cast<float>(x), static_cast<float>(y));
 }
 
-void ae::Window::DispatchEvent(Event &event)
+void ae::Window::DispatchInput()
 {
-    event.Dispatch();
+#ifdef AE_DEBUG
+    if (m_FrameThread != std::thread::id() && std::this_thread::get_id() != m_FrameThread)
+    {
+        AE_LOG(AE_WARNING, "Tried to dispatch input from a thread other than the one running BeginFrame");
+        return;
+    }
+#endif // AE_DEBUG
+
+    BeginInputFrame();
+
+    InputRecord record;
+
+    while (m_pInputQueue->Pop(record))
+    {
+        // Live input would make the replay diverge from the recording
+        if (!m_pInputReplay)
+        {
+            DispatchRecord(record);
+        }
+    }
+
+    DispatchDeferredInput();
+
+    m_InputActions.Update(m_Keyboard, m_Mouse, m_ControllerSnapshot);
 }
 
-void ae::Window::OnKey(int key, int scancode, int action, int mods)
+void ae::Window::BeginInputFrame()
 {
-    m_pInterface->SendOnKeyEvent(key, scancode, action, mods);
+    // Previous input state rolls over before the frame's records are applied
+    m_Keyboard.UpdatePreviousState();
+    m_Mouse.UpdatePreviousState();
 
-    if (action == GLFW_PRESS || action == GLFW_REPEAT)
+    const InputFrame *pReplayFrame = m_pInputReplay ? ReplayInputFrame() : nullptr;
+
+    UpdateControllerSnapshot(pReplayFrame);
+
+    if (m_pInputRecorder)
     {
-        m_Keyboard.SetKeyPressed(static_cast<int32_t>(key), true);
+        m_pInputRecorder->BeginFrame(GetDeltaTime(), m_ControllerSnapshot.current);
+    }
 
-        KeyPressedEvent event(static_cast<int32_t>(key), action == GLFW_REPEAT);
-        DispatchEvent(event);
+    if (pReplayFrame)
+    {
+        for (const InputRecord &record : pReplayFrame->records)
+        {
+            DispatchRecord(record);
+        }
+    }
+}
+
+void ae::Window::DispatchRecord(const InputRecord &record)
+{
+    if (m_pInputRecorder)
+    {
+        m_pInputRecorder->Add(record);
+    }
+
+    m_InputTime = record.time;
+
+    switch (record.type)
+    {
+    case InputRecordType::KEY:
+        OnKey(record.a, record.b, record.action, record.mods);
+        break;
+    case InputRecordType::MOUSE_BUTTON:
+        OnMouseButton(record.a, record.action, record.mods);
+        break;
+    case InputRecordType::MOUSE_MOVED:
+        OnMouseMoved(record.x, record.y);
+        break;
+    case InputRecordType::MOUSE_SCROLLED:
+        OnMouseScrolled(record.x, record.y);
+        break;
+    case InputRecordType::MOUSE_ENTERED:
+        OnMouseEntered(record.a);
+        break;
+    case InputRecordType::CHAR:
+        OnChar(static_cast<unsigned int>(record.a));
+        break;
+    }
+
+    DeferInputEvent(record);
+}
+
+void ae::Window::DeferInputEvent(const InputRecord &record)
+{
+    // Runs of moves collapse into the last position and runs of scrolls into their sum. Only adjacent records
+    // merge, so the order relative to buttons and keys is kept; Mouse still holds every motion sample.
+    if (!m_DeferredInputEvents.empty() && m_DeferredInputEvents.back().type == record.type)
+    {
+        InputRecord &last = m_DeferredInputEvents.back();
+
+        if (record.type == InputRecordType::MOUSE_MOVED)
+        {
+            last.x = record.x;
+            last.y = record.y;
+            last.time = record.time;
+            return;
+        }
 
-        if (!event.IsConsumed() && m_OnKeyPressed)
+        if (record.type == InputRecordType::MOUSE_SCROLLED)
         {
-            m_OnKeyPressed(static_cast<int32_t>(key));
+            last.x += record.x;
+            last.y += record.y;
+            last.time = record.time;
+            return;
         }
     }
-    else if (action == GLFW_RELEASE)
+
+    m_DeferredInputEvents.push_back(record);
+}
+
+void ae::Window::DispatchDeferredInput()
+{
+    // Events dispatch themselves through the layer stack, which offers no pass over its layers for several events
+    // at once, so each one still goes through every layer before the next.
+    // Indexed, since a callback may dispatch input and queue more
+    for (size_t i = 0; i < m_DeferredInputEvents.size(); i++)
     {
-        m_Keyboard.SetKeyPressed(static_cast<int32_t>(key), false);
+        const InputRecord record = m_DeferredInputEvents[i];
+        m_InputTime = record.time;
+
+        switch (record.type)
+        {
+        case InputRecordType::KEY:
+            if (record.action == GLFW_PRESS || record.action == GLFW_REPEAT)
+            {
+                if (!DispatchLayerEvent<KeyPressedEvent>(record.a, record.action == GLFW_REPEAT))
+                {
+                    m_OnKeyPressed.Invoke(record.a);
+                }
+            }
+            else if (record.action == GLFW_RELEASE)
+            {
+                if (!DispatchLayerEvent<KeyReleasedEvent>(record.a))
+                {
+                    m_OnKeyReleased.Invoke(record.a);
+                }
+            }
+            break;
+        case InputRecordType::MOUSE_BUTTON:
+            if (record.action == GLFW_PRESS)
+            {
+                if (!DispatchLayerEvent<MouseButtonPressedEvent>(record.a))
+                {
+                    m_OnMouseButtonPressed.Invoke(record.a);
+                }
+            }
+            else if (record.action == GLFW_RELEASE)
+            {
+                if (!DispatchLayerEvent<MouseButtonReleasedEvent>(record.a))
+                {
+                    m_OnMouseButtonReleased.Invoke(record.a);
+                }
+            }
+            break;
+        case InputRecordType::MOUSE_MOVED:
+            if (!DispatchLayerEvent<MouseMovedEvent>(static_cast<float>(record.x), static_cast<float>(record.y)))
+            {
+                m_OnMouseMoved.Invoke(static_cast<float>(record.x), static_cast<float>(record.y));
+            }
+            break;
+        case InputRecordType::MOUSE_SCROLLED:
+            if (!DispatchLayerEvent<MouseScrolledEvent>(static_cast<float>(record.x), static_cast<float>(record.y)))
+            {
+                m_OnMouseScrolled.Invoke(static_cast<float>(record.x), static_cast<float>(record.y));
+            }
+            break;
+        case InputRecordType::MOUSE_ENTERED:
+            if (record.a)
+            {
+                if (!DispatchLayerEvent<MouseEnteredEvent>())
+                {
+                    m_OnMouseEntered.Invoke();
+                }
+            }
+            else if (!DispatchLayerEvent<MouseExitedEvent>())
+            {
+                m_OnMouseExited.Invoke();
+            }
+            break;
+        case InputRecordType::CHAR:
+            if (!DispatchLayerEvent<KeyTypedEvent>(static_cast<unsigned int>(record.a)))
+            {
+                m_OnKeyTyped.Invoke(record.a);
+            }
+            break;
+        }
+    }
+
+    // Keeps the capacity, so steady-state frames do not allocate
+    m_DeferredInputEvents.clear();
+}
+
+void ae::Window::StartInputRecording(const std::string &path)
+{
+#ifdef AE_DEBUG
+    if (m_pInputRecorder)
+    {
+        AE_LOG(AE_WARNING, "Tried to start input recording but one is already in progress");
+        return;
+    }
+#endif // AE_DEBUG
 
-        KeyReleasedEvent event(static_cast<int32_t>(key));
-        DispatchEvent(event);
+    InputStartState startState;
+    startState.cursorX = m_Mouse.m_X;
+    startState.cursorY = m_Mouse.m_Y;
 
-        if (!event.IsConsumed() && m_OnKeyReleased)
+    for (int32_t key = 0; key <= GLFW_KEY_LAST; key++)
+    {
+        if (m_Keyboard.m_Keys[key])
+        {
+            startState.keys.push_back(key);
+        }
+    }
+
+    for (int32_t button = 0; button <= GLFW_MOUSE_BUTTON_LAST; button++)
+    {
+        if (m_Mouse.m_Buttons[button])
         {
-            m_OnKeyReleased(static_cast<int32_t>(key));
+            startState.buttons |= static_cast<uint8_t>(1u << button);
         }
     }
+
+    m_pInputRecorder = std::make_unique<InputRecorder>(path, startState);
 }
 
-void ae::Window::OnChar(unsigned int c)
+void ae::Window::StopInputRecording()
+{
+#ifdef AE_DEBUG
+    if (!m_pInputRecorder)
+    {
+        AE_LOG(AE_WARNING, "Tried to stop input recording but none is in progress");
+        return;
+    }
+#endif // AE_DEBUG
+
+    std::unique_ptr<InputRecorder> pRecorder = std::move(m_pInputRecorder);
+    pRecorder->Save();
+}
+
+void ae::Window::StartInputReplay(const std::string &path, ReplayTiming timing)
 {
-    m_pInterface->SendOnCharEvent(c);
+#ifdef AE_DEBUG
+    if (m_pInputReplay)
+    {
+        AE_LOG(AE_WARNING, "Tried to start input replay but one is already in progress");
+        return;
+    }
+#endif // AE_DEBUG
 
-    m_Keyboard.SetKeyTyped(static_cast<int32_t>(c));
+    m_pInputReplay = std::make_unique<InputReplay>(path);
+    m_ReplayTiming = timing;
+    m_ReplayDeltaTime = 0.0;
 
-    KeyTypedEvent event(c);
-    DispatchEvent(event);
+    // Starts from the recorded state, so live keys stay up and the first deltas are measured from the recorded
+    // cursor position. Accumulated deltas and scrolls were never part of the recording.
+    const InputStartState &startState = m_pInputReplay->GetStartState();
+
+    m_Keyboard.m_Keys.reset();
 
-    if (!event.IsConsumed() && m_OnKeyTyped)
+    for (int32_t key : startState.keys)
     {
-        m_OnKeyTyped(static_cast<int32_t>(c));
+        m_Keyboard.SetKeyPressed(key, true);
     }
+
+    for (int32_t button = 0; button <= GLFW_MOUSE_BUTTON_LAST; button++)
+    {
+        m_Mouse.SetPressed(button, (startState.buttons & (1u << button)) != 0);
+    }
+
+    m_Mouse.SetCachedPosition(startState.cursorX, startState.cursorY);
+    m_Mouse.m_DeltaX = 0.0f;
+    m_Mouse.m_DeltaY = 0.0f;
+    m_Mouse.m_ScrollX = 0.0f;
+    m_Mouse.m_ScrollY = 0.0f;
 }
 
-void ae::Window::OnMouseButton(int button, int action, int mods)
+void ae::Window::StopInputReplay()
 {
-    m_pInterface->SendOnMouseButtonEvent(button, action, mods);
+    if (!m_pInputReplay)
+    {
+        return;
+    }
 
-    if (action == GLFW_PRESS)
+    m_pInputReplay.reset();
+
+    // Back to the controllers that are actually connected and the real cursor position
+    m_Controllers.clear();
+
+    if (std::this_thread::get_id() != m_RenderThread.get_id())
     {
-        m_Mouse.SetPressed(static_cast<int32_t>(button), true);
+        InitInput();
+        return;
+    }
 
-        MouseButtonPressedEvent event(static_cast<int32_t>(button));
-        DispatchEvent(event);
+    // GLFW only allows those queries on the main thread, so the render thread takes them from the event loop
+    const PlatformState &state = m_PlatformState;
 
-        if (!event.IsConsumed() && m_OnMouseButtonPressed)
+    for (uint32_t id = 0; id < AE_CONTROLLER_COUNT; id++)
+    {
+        if (state.controllers.connected & (1u << id))
         {
-            m_OnMouseButtonPressed(button);
+            m_Controllers.emplace_back(id, m_ControllerSnapshot);
         }
     }
-    else if (action == GLFW_RELEASE)
+
+    m_Mouse.SetCachedPosition(static_cast<float>(state.cursorX), static_cast<float>(state.cursorY));
+}
+
+const ae::InputFrame *ae::Window::ReplayInputFrame()
+{
+    const InputFrame *pFrame = m_pInputReplay->NextFrame();
+
+    if (!pFrame)
     {
-        m_Mouse.SetPressed(static_cast<int32_t>(button), false);
+        AE_LOG(AE_INFO, "Input replay finished after {} frames", m_pInputReplay->GetFrameCount());
+        StopInputReplay();
+        return nullptr;
+    }
+
+    m_ReplayDeltaTime = pFrame->deltaTime;
 
-        MouseButtonReleasedEvent event(static_cast<int32_t>(button));
-        DispatchEvent(event);
+    // Controllers that stay connected keep their settings, like the deadzone
+    std::erase_if(m_Controllers,
+                  [pFrame](const Controller &controller)
+                  {
+                      return std::none_of(pFrame->controllers.begin(), pFrame->controllers.end(),
+                                          [&controller](const ControllerRecord &record)
+                                          { return record.id == controller.GetId(); });
+                  });
 
-        if (!event.IsConsumed() && m_OnMouseButtonReleased)
+    for (const ControllerRecord &record : pFrame->controllers)
+    {
+        if (std::none_of(m_Controllers.begin(), m_Controllers.end(),
+                         [&record](const Controller &controller) { return controller.GetId() == record.id; }))
         {
-            m_OnMouseButtonReleased(button);
+            m_Controllers.emplace_back(record.id, m_ControllerSnapshot);
         }
     }
+
+    return pFrame;
 }
 
-void ae::Window::OnMouseMoved(double x, double y)
+void ae::Window::UpdateControllerSnapshot(const InputFrame *pReplayFrame)
 {
-    m_pInterface->SendOnMouseMovedEvent(x, y);
+    m_ControllerSnapshot.previous = m_ControllerSnapshot.current;
 
-    m_Mouse.SetMoved(static_cast<float>(x), static_cast<float>(y));
+    ControllerStates &current = m_ControllerSnapshot.current;
+    current.connected = 0;
 
-    MouseMovedEvent event(static_cast<float>(x), static_cast<float>(y));
-    DispatchEvent(event);
+    if (pReplayFrame)
+    {
+        for (const ControllerRecord &record : pReplayFrame->controllers)
+        {
+            if (record.id < AE_CONTROLLER_COUNT)
+            {
+                current.connected |= 1u << record.id;
+                current.buttons[record.id] = record.buttons;
+                current.axes[record.id] = record.axes;
+            }
+        }
+    }
+    else if (IsRenderThreadRunning())
+    {
+        // The event loop polled the pads on the main thread; this frame takes the tracked ones from its sample
+        // and asks for a fresh one for the next
+        const ControllerStates &sampled = m_PlatformState.controllers;
 
-    if (!event.IsConsumed() && m_OnMouseMoved)
+        for (const Controller &controller : m_Controllers)
+        {
+            uint32_t id = controller.GetId();
+
+            if (id < AE_CONTROLLER_COUNT && (sampled.connected & (1u << id)))
+            {
+                current.connected |= 1u << id;
+                current.buttons[id] = sampled.buttons[id];
+                current.axes[id] = sampled.axes[id];
+            }
+        }
+
+        if (!m_Controllers.empty())
+        {
+            glfwPostEmptyEvent();
+        }
+    }
+    else
+    {
+        // The only gamepad queries of the frame; every Controller reads from the snapshot
+        for (const Controller &controller : m_Controllers)
+        {
+            PollController(controller.GetId(), current);
+        }
+    }
+
+    // Disconnected slots read as idle, so the previous frame of a reconnected pad is at rest
+    for (uint32_t id = 0; id < AE_CONTROLLER_COUNT; id++)
+    {
+        if (!(current.connected & (1u << id)))
+        {
+            current.buttons[id] = 0;
+            current.axes[id] = {};
+        }
+    }
+
+    if (m_OnControllerButtonPressed.IsEmpty() && m_OnControllerButtonReleased.IsEmpty())
     {
-        m_OnMouseMoved(static_cast<float>(x), static_cast<float>(y));
+        return;
+    }
+
+    for (uint32_t id = 0; id < AE_CONTROLLER_COUNT; id++)
+    {
+        uint32_t changed = current.buttons[id] ^ m_ControllerSnapshot.previous.buttons[id];
+
+        for (int32_t button = 0; changed != 0; button++, changed >>= 1)
+        {
+            if (!(changed & 1u))
+            {
+                continue;
+            }
+
+            if (current.buttons[id] & (1u << button))
+            {
+                m_OnControllerButtonPressed.Invoke(static_cast<int32_t>(id), button);
+            }
+            else
+            {
+                m_OnControllerButtonReleased.Invoke(static_cast<int32_t>(id), button);
+            }
+        }
     }
 }
 
-void ae::Window::OnMouseScrolled(double x, double y)
+bool ae::Window::PollController(uint32_t id, ControllerStates &states)
 {
-    m_pInterface->SendOnMouseScrolledEvent(x, y);
+    GLFWgamepadstate state = {};
 
-    m_Mouse.SetScrolled(static_cast<float>(x), static_cast<float>(y));
+    if (id >= AE_CONTROLLER_COUNT || !glfwGetGamepadState(GLFW_JOYSTICK_1 + static_cast<int>(id), &state))
+    {
+        return false;
+    }
 
-    MouseScrolledEvent event(static_cast<float>(x), static_cast<float>(y));
-    DispatchEvent(event);
+    uint16_t buttons = 0;
 
-    if (!event.IsConsumed() && m_OnMouseScrolled)
+    for (int32_t button = 0; button <= AE_CONTROLLER_BUTTON_LAST; button++)
     {
-        m_OnMouseScrolled(static_cast<float>(x), static_cast<float>(y));
+        if (state.buttons[button] == GLFW_PRESS)
+        {
+            buttons |= static_cast<uint16_t>(1u << button);
+        }
     }
+
+    states.connected |= 1u << id;
+    states.buttons[id] = buttons;
+    std::copy(std::begin(state.axes), std::end(state.axes), states.axes[id].begin());
+
+    return true;
 }
 
-void ae::Window::OnMouseEntered(int entered)
+void ae::Window::PollControllers(ControllerStates &states)
 {
-    m_pInterface->SendOnCursorEnterEvent(entered);
+    for (uint32_t id = 0; id < AE_CONTROLLER_COUNT; id++)
+    {
+        PollController(id, states);
+    }
+}
 
-    m_Mouse.SetEntered(static_cast<bool>(entered));
+void ae::Window::StartRenderThread(const std::function<void(Window &)> &renderFrame)
+{
+#ifdef AE_DEBUG
+    if (!m_Created)
+    {
+        AE_LOG(AE_WARNING, "Tried to start render thread but window is not created");
+        return;
+    }
 
-    if (entered)
+    if (m_RenderThread.joinable())
     {
-        MouseEnteredEvent event;
-        DispatchEvent(event);
+        AE_LOG(AE_WARNING, "Tried to start render thread but one is already running");
+        return;
+    }
+#endif // AE_DEBUG
+
+    // The event loop keeps it up to date once it runs
+    ControllerStates controllers;
+    PollControllers(controllers);
+    SamplePlatformState(controllers);
+
+    // Captures may be requested from other threads while the render thread runs, so the capture state is created
+    // now rather than on first use, behind the render thread's back
+    GetFrameCapture();
+
+    // A context can only be current on one thread
+    Deactivate();
+
+    m_RenderThreadRunning.store(true, std::memory_order_release);
 
-        if (!event.IsConsumed() && m_OnMouseEntered)
+    m_RenderThread = std::jthread(
+        [this, renderFrame](std::stop_token stopToken)
         {
-            m_OnMouseEntered();
-        }
+            m_pContext->Activate();
+
+            try
+            {
+                while (!stopToken.stop_requested() && !ShouldClose())
+                {
+                    renderFrame(*this);
+                }
+            }
+
+            catch (const std::exception &e)
+            {
+                AE_LOG(AE_ERROR, "Render thread of window '{}' stopped: {}", m_Desc.title, e.what());
+            }
+
+            catch (...)
+            {
+                AE_LOG(AE_ERROR, "Unexpected error thrown in render thread of window '{}'", m_Desc.title);
+            }
+
+            m_pContext->Deactivate();
+            m_RenderThreadRunning.store(false, std::memory_order_release);
 
-        glfwSetCursor(m_pWindow, m_CurrentCursor.GetCursor());
+            // Wakes the event loop so it notices right away
+            glfwPostEmptyEvent();
+        });
+}
+
+void ae::Window::StopRenderThread()
+{
+    if (!m_RenderThread.joinable())
+    {
+        return;
     }
-    else
+
+    m_RenderThread.request_stop();
+    m_RenderThread.join();
+    m_RenderThread = std::jthread();
+
+    m_pContext->Activate();
+    m_Active = true;
+}
+
+void ae::Window::RunEventLoop()
+{
+    ae::WindowManager::Get().RunEventLoop();
+}
+
+void ae::Window::SamplePlatformState(const ControllerStates &controllers)
+{
+    PlatformState state;
+    glfwGetWindowSize(m_pWindow, &state.windowWidth, &state.windowHeight);
+    glfwGetFramebufferSize(m_pWindow, &state.framebufferWidth, &state.framebufferHeight);
+    glfwGetCursorPos(m_pWindow, &state.cursorX, &state.cursorY);
+    state.controllers = controllers;
+
+    std::scoped_lock lock(m_DeferredEventMutex);
+    m_SampledPlatformState = state;
+}
+
+void ae::Window::PrepareInterface()
+{
+    if (!IsRenderThreadRunning())
     {
-        MouseExitedEvent event;
-        DispatchEvent(event);
+        m_pInterface->Prepare();
+        return;
+    }
 
-        if (!event.IsConsumed() && m_OnMouseExited)
+    // The GLFW backend would query the window itself, which the render thread may not do
+    const PlatformState &state = m_PlatformState;
+    InterfacePlatformInput input;
+    input.width = static_cast<float>(state.windowWidth);
+    input.height = static_cast<float>(state.windowHeight);
+
+    if (state.windowWidth > 0 && state.windowHeight > 0)
+    {
+        input.framebufferScaleX = static_cast<float>(state.framebufferWidth) / input.width;
+        input.framebufferScaleY = static_cast<float>(state.framebufferHeight) / input.height;
+    }
+
+    m_pInterface->Prepare(input);
+}
+
+void ae::Window::DispatchDeferredEvents()
+{
+    std::vector<std::function<void(Window &)>> events;
+
+    {
+        std::scoped_lock lock(m_DeferredEventMutex);
+
+        m_PlatformState = m_SampledPlatformState;
+
+        if (m_DeferredEvents.empty())
         {
-            m_OnMouseExited();
+            return;
         }
+
+        events.swap(m_DeferredEvents);
+    }
+
+    for (std::function<void(Window &)> &event : events)
+    {
+        event(*this);
     }
 }
 
+void ae::Window::DispatchEvent(Event &event)
+{
+    event.Dispatch();
+}
+
+template <typename E, typename... EventArgs> bool ae::Window::DispatchLayerEvent(EventArgs &&...args)
+{
+    // Events only reach layers, so without a layer stack there is nothing to build
+    if (!m_pLayerStack)
+    {
+        return false;
+    }
+
+    E event(std::forward<EventArgs>(args)...);
+    DispatchEvent(event);
+
+    return event.IsConsumed();
+}
+
+void ae::Window::OnKey(int key, int scancode, int action, int mods)
+{
+    // Headless windows have no interface but still receive replayed input
+    if (m_pInterface)
+    {
+        m_pInterface->SendOnKeyEvent(key, scancode, action, mods);
+    }
+
+    if (action == GLFW_PRESS || action == GLFW_REPEAT)
+    {
+        m_Keyboard.SetKeyPressed(static_cast<int32_t>(key), true);
+    }
+    else if (action == GLFW_RELEASE)
+    {
+        m_Keyboard.SetKeyPressed(static_cast<int32_t>(key), false);
+    }
+}
+
+void ae::Window::OnChar(unsigned int c)
+{
+    if (m_pInterface)
+    {
+        m_pInterface->SendOnCharEvent(c);
+    }
+
+    m_Keyboard.SetKeyTyped(static_cast<char32_t>(c));
+}
+
+void ae::Window::OnMouseButton(int button, int action, int mods)
+{
+    if (m_pInterface)
+    {
+        m_pInterface->SendOnMouseButtonEvent(button, action, mods);
+    }
+
+    if (action == GLFW_PRESS)
+    {
+        m_Mouse.SetPressed(static_cast<int32_t>(button), true);
+    }
+    else if (action == GLFW_RELEASE)
+    {
+        m_Mouse.SetPressed(static_cast<int32_t>(button), false);
+    }
+}
+
+void ae::Window::OnMouseMoved(double x, double y)
+{
+    if (m_pInterface)
+    {
+        m_pInterface->SendOnMouseMovedEvent(x, y);
+    }
+
+    m_Mouse.SetMoved(static_cast<float>(x), static_cast<float>(y), m_InputTime);
+}
+
+void ae::Window::OnMouseScrolled(double x, double y)
+{
+    if (m_pInterface)
+    {
+        m_pInterface->SendOnMouseScrolledEvent(x, y);
+    }
+
+    m_Mouse.SetScrolled(static_cast<float>(x), static_cast<float>(y));
+}
+
+void ae::Window::OnMouseEntered(int entered)
+{
+    if (m_pInterface)
+    {
+        m_pInterface->SendOnCursorEnterEvent(entered);
+    }
+
+    // The cursor itself is restored by the WindowManager, on the main thread
+    m_Mouse.SetEntered(static_cast<bool>(entered));
+}
+
 void ae::Window::OnWindowResize(uint32_t width, uint32_t height)
 {
     m_Desc.width = width;
@@ -1278,12 +2241,9 @@ void ae::Window::OnWindowResize(uint32_t width, uint32_t height)
         m_pContext->OnResize(width, height);
     }
 
-    WindowResizeEvent event(width, height);
-    DispatchEvent(event);
-
-    if (!event.IsConsumed() && m_OnWindowResize)
+    if (!DispatchLayerEvent<WindowResizeEvent>(width, height))
     {
-        m_OnWindowResize(width, height);
+        m_OnWindowResize.Invoke(width, height);
     }
 }
 
@@ -1292,12 +2252,9 @@ void ae::Window::OnWindowMinimalized()
     m_Minimized = true;
     m_Maximized = false;
 
-    WindowMinimizedEvent event;
-    DispatchEvent(event);
-
-    if (!event.IsConsumed() && m_OnWindowMinimized)
+    if (!DispatchLayerEvent<WindowMinimizedEvent>())
     {
-        m_OnWindowMinimized();
+        m_OnWindowMinimized.Invoke();
     }
 }
 
@@ -1306,12 +2263,9 @@ void ae::Window::OnWindowMaximalized()
     m_Maximized = true;
     m_Minimized = false;
 
-    WindowMaximizedEvent event;
-    DispatchEvent(event);
-
-    if (!event.IsConsumed() && m_OnWindowMaximized)
+    if (!DispatchLayerEvent<WindowMaximizedEvent>())
     {
-        m_OnWindowMaximized();
+        m_OnWindowMaximized.Invoke();
     }
 }
 
@@ -1320,38 +2274,32 @@ void ae::Window::OnWindowRestored()
     m_Minimized = false;
     m_Maximized = false;
 
-    WindowRestoredEvent event;
-    DispatchEvent(event);
-
-    if (!event.IsConsumed() && m_OnWindowRestored)
+    if (!DispatchLayerEvent<WindowRestoredEvent>())
     {
-        m_OnWindowRestored();
+        m_OnWindowRestored.Invoke();
     }
 }
 
 void ae::Window::OnWindowMoved(uint32_t x, uint32_t y)
 {
-    WindowMovedEvent event(static_cast<int32_t>(x), static_cast<int32_t>(y));
-    DispatchEvent(event);
-
-    if (!event.IsConsumed() && m_OnWindowMoved)
+    if (!DispatchLayerEvent<WindowMovedEvent>(static_cast<int32_t>(x), static_cast<int32_t>(y)))
     {
-        m_OnWindowMoved(x, y);
+        m_OnWindowMoved.Invoke(x, y);
     }
 }
 
 void ae::Window::OnWindowFocused(int focused)
 {
-    m_pInterface->SendOnWindowFocusEvent(focused);
+    if (m_pInterface)
+    {
+        m_pInterface->SendOnWindowFocusEvent(focused);
+    }
 
     m_Focused = static_cast<bool>(focused);
 
-    WindowFocusedEvent event(static_cast<bool>(focused));
-    DispatchEvent(event);
-
-    if (!event.IsConsumed() && m_OnWindowFocused)
+    if (!DispatchLayerEvent<WindowFocusedEvent>(static_cast<bool>(focused)))
     {
-        m_OnWindowFocused(focused);
+        m_OnWindowFocused.Invoke(focused);
     }
 }
 
@@ -1362,31 +2310,22 @@ void ae::Window::OnMonitor(GLFWmonitor *pMonitor, int event)
         m_pInterface->SendOnMonitorEvent(pMonitor, event);
     }
 
-    if (m_OnMonitorConnected)
-    {
-        m_OnMonitorConnected();
-    }
+    m_OnMonitorConnected.Invoke();
 }
 
 void ae::Window::OnFramebufferResize(uint32_t width, uint32_t height)
 {
-    FramebufferResizeEvent event(width, height);
-    DispatchEvent(event);
-
-    if (!event.IsConsumed() && m_OnFramebufferResize)
+    if (!DispatchLayerEvent<FramebufferResizeEvent>(width, height))
     {
-        m_OnFramebufferResize(width, height);
+        m_OnFramebufferResize.Invoke(width, height);
     }
 }
 
 void ae::Window::OnContentScaleChanged(float xScale, float yScale)
 {
-    ContentScaleChangedEvent event(xScale, yScale);
-    DispatchEvent(event);
-
-    if (!event.IsConsumed() && m_OnContentScaleChanged)
+    if (!DispatchLayerEvent<ContentScaleChangedEvent>(xScale, yScale))
     {
-        m_OnContentScaleChanged(xScale, yScale);
+        m_OnContentScaleChanged.Invoke(xScale, yScale);
     }
 }
 
@@ -1400,40 +2339,35 @@ void ae::Window::OnFileDrop(int count, const char **paths)
         pathList.emplace_back(paths[i]);
     }
 
+    if (!m_pLayerStack)
+    {
+        m_OnFileDrop.Invoke(pathList);
+        return;
+    }
+
     FileDropEvent event(std::move(pathList));
     DispatchEvent(event);
 
-    if (!event.IsConsumed() && m_OnFileDrop)
+    if (!event.IsConsumed())
     {
-        m_OnFileDrop(event.GetPaths());
+        m_OnFileDrop.Invoke(event.GetPaths());
     }
 }
 
 void ae::Window::OnWindowClose()
 {
-    WindowCloseEvent event;
-    DispatchEvent(event);
-
-    // If event was consumed by layer stack, prevent closing
-    if (event.IsConsumed())
-    {
-        glfwSetWindowShouldClose(m_pWindow, GLFW_FALSE);
-        return;
-    }
-
-    // If callback returns false, prevent closing
-    if (m_OnWindowClose && !m_OnWindowClose())
-    {
-        glfwSetWindowShouldClose(m_pWindow, GLFW_FALSE);
-    }
+    // Closing is prevented if the layer stack consumed the event or any callback returned false. The flag is set
+    // either way, since a deferred close arrives with it cleared.
+    bool allowed = !DispatchLayerEvent<WindowCloseEvent>() && m_OnWindowClose.InvokeAll();
+    glfwSetWindowShouldClose(m_pWindow, allowed ? GLFW_TRUE : GLFW_FALSE);
 }
 
-void ae::Window::OnControllerConnected(int controllerId)
+void ae::Window::OnControllerConnected(int controllerId, bool isGamepad)
 {
     const uint32_t id = static_cast<uint32_t>(controllerId);
 
-    // Only track gamepads (IsConnected requires a gamepad mapping), and only once.
-    if (Controller::IsConnected(id))
+    // Only track gamepads (the event loop checked for a gamepad mapping), and only once.
+    if (isGamepad)
     {
         bool present = false;
         for (const Controller &controller : m_Controllers)
@@ -1447,16 +2381,13 @@ void ae::Window::OnControllerConnected(int controllerId)
 
         if (!present)
         {
-            m_Controllers.emplace_back(id);
+            m_Controllers.emplace_back(id, m_ControllerSnapshot);
         }
     }
 
-    ControllerConnectedEvent event(static_cast<int32_t>(controllerId));
-    DispatchEvent(event);
-
-    if (!event.IsConsumed() && m_OnControllerConnected)
+    if (!DispatchLayerEvent<ControllerConnectedEvent>(static_cast<int32_t>(controllerId)))
     {
-        m_OnControllerConnected(static_cast<int32_t>(controllerId));
+        m_OnControllerConnected.Invoke(static_cast<int32_t>(controllerId));
     }
 }
 
@@ -1465,12 +2396,9 @@ void ae::Window::OnControllerDisconnected(int controllerId)
     const uint32_t id = static_cast<uint32_t>(controllerId);
     std::erase_if(m_Controllers, [id](const Controller &controller) { return controller.GetId() == id; });
 
-    ControllerDisconnectedEvent event(static_cast<int32_t>(controllerId));
-    DispatchEvent(event);
-
-    if (!event.IsConsumed() && m_OnControllerDisconnected)
+    if (!DispatchLayerEvent<ControllerDisconnectedEvent>(static_cast<int32_t>(controllerId)))
     {
-        m_OnControllerDisconnected(static_cast<int32_t>(controllerId));
+        m_OnControllerDisconnected.Invoke(static_cast<int32_t>(controllerId));
     }
 }
 
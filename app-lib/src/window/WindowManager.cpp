@@ -4,6 +4,8 @@
 #include "window/WindowManager.h"
 
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <utility>
 
 static void GLFWErrorCallback(int error, const char *description)
 {
@@ -15,6 +17,11 @@ static void GLFWKeyCallback(GLFWwindow *pWindow, int key, int scancode, int acti
     ae::WindowManager::Get().RecordKey(pWindow, key, scancode, action, mods);
 }
 
+static void GLFWCharCallback(GLFWwindow *pWindow, unsigned int c)
+{
+    ae::WindowManager::Get().RecordChar(pWindow, c);
+}
+
 static void GLFWMouseButtonCallback(GLFWwindow *pWindow, int button, int action, int mods)
 {
     ae::WindowManager::Get().RecordMouseButton(pWindow, button, action, mods);
@@ -134,12 +141,24 @@ ae::WindowManager::~WindowManager()
 
 void ae::WindowManager::AddWindow(Window *window)
 {
-    m_WindowMap[window->GetWindow()] = static_cast<uint32_t>(m_Windows.size());
-    m_Windows.push_back(window);
+    if (m_FreeSlots.empty())
+    {
+        window->m_ManagerSlot = static_cast<uint32_t>(m_Windows.size());
+        m_Windows.push_back(window);
+    }
+    else
+    {
+        window->m_ManagerSlot = m_FreeSlots.back();
+        m_FreeSlots.pop_back();
+        m_Windows[window->m_ManagerSlot] = window;
+    }
+
+    glfwSetWindowUserPointer(window->GetWindow(), window);
 
     if (window->GetDesc().type != WindowType::HEADLESS)
     {
         glfwSetKeyCallback(window->GetWindow(), GLFWKeyCallback);
+        glfwSetCharCallback(window->GetWindow(), GLFWCharCallback);
 
         glfwSetMouseButtonCallback(window->GetWindow(), GLFWMouseButtonCallback);
         glfwSetCursorPosCallback(window->GetWindow(), GLFWMouseMovedCallback);
@@ -169,6 +188,7 @@ void ae::WindowManager::RemoveWindow(Window *window)
     if (window->GetDesc().type != WindowType::HEADLESS)
     {
         glfwSetKeyCallback(window->GetWindow(), nullptr);
+        glfwSetCharCallback(window->GetWindow(), nullptr);
 
         glfwSetMouseButtonCallback(window->GetWindow(), nullptr);
         glfwSetCursorPosCallback(window->GetWindow(), nullptr);
@@ -187,20 +207,10 @@ void ae::WindowManager::RemoveWindow(Window *window)
         glfwSetWindowCloseCallback(window->GetWindow(), nullptr);
     }
 
-    uint32_t index = m_WindowMap[window->GetWindow()];
-
-    for (auto &pair : m_WindowMap)
-    {
-        // Shift the index of all windows that have higher index than the removed window
-        if (pair.second > index)
-        {
-            pair.second--;
-        }
-    }
-
-    m_Windows.erase(m_Windows.begin() + index);
+    glfwSetWindowUserPointer(window->GetWindow(), nullptr);
 
-    m_WindowMap.erase(window->GetWindow());
+    m_Windows[window->m_ManagerSlot] = nullptr;
+    m_FreeSlots.push_back(window->m_ManagerSlot);
 
     AE_LOG(AE_TRACE, "Window removed from manager");
 }
@@ -209,7 +219,16 @@ void ae::WindowManager::Init()
 {
     if (!glfwInit())
     {
-        AE_THROW_RUNTIME_ERROR("Failed to initialize GLFW");
+        // No display server (CI, render farms). GLFW's null platform still provides window handles, timing
+        // and a virtual monitor, which is all headless windows need.
+        AE_LOG(AE_WARNING, "Failed to initialize GLFW with a display, falling back to the null platform");
+
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+
+        if (!glfwInit())
+        {
+            AE_THROW_RUNTIME_ERROR("Failed to initialize GLFW");
+        }
     }
 
     glfwSetErrorCallback(GLFWErrorCallback);
@@ -230,199 +249,156 @@ void ae::WindowManager::EnsureInitialized()
     }
 }
 
-void ae::WindowManager::RecordKey(GLFWwindow *pWindow, int key, int scancode, int action, int mods)
+void ae::WindowManager::QueueInput(GLFWwindow *pWindow, InputRecord record)
 {
-#ifdef AE_DEBUG
-    if (!m_WindowMap.contains(pWindow))
+    Window *pTarget = FindWindow(pWindow);
+
+    if (!pTarget)
     {
-        AE_LOG(AE_WARNING, "Tried to record event but Window was not found in WindowManager");
         return;
     }
-#endif // AE_DEBUG
-    m_Windows[m_WindowMap[pWindow]]->OnKey(key, scancode, action, mods);
+
+    record.time = glfwGetTime();
+
+    InputQueue &queue = *pTarget->m_pInputQueue;
+
+    if (!queue.Push(record) && queue.GetDroppedCount() == 1)
+    {
+        AE_LOG(AE_WARNING, "Input queue is full, dropping input until the window dispatches it");
+    }
+}
+
+void ae::WindowManager::RecordKey(GLFWwindow *pWindow, int key, int scancode, int action, int mods)
+{
+    QueueInput(pWindow, { .a = key, .b = scancode, .action = action, .mods = mods, .type = InputRecordType::KEY });
+}
+
+void ae::WindowManager::RecordChar(GLFWwindow *pWindow, unsigned int c)
+{
+    QueueInput(pWindow, { .a = static_cast<int32_t>(c), .type = InputRecordType::CHAR });
 }
 
 void ae::WindowManager::RecordMouseButton(GLFWwindow *pWindow, int button, int action, int mods)
 {
-#ifdef AE_DEBUG
-    if (!m_WindowMap.contains(pWindow))
-    {
-        AE_LOG(AE_WARNING, "Tried to record event but Window was not found in WindowManager");
-        return;
-    }
-#endif // AE_DEBUG
-    m_Windows[m_WindowMap[pWindow]]->OnMouseButton(button, action, mods);
+    QueueInput(pWindow, { .a = button, .action = action, .mods = mods, .type = InputRecordType::MOUSE_BUTTON });
 }
 
 void ae::WindowManager::RecordMouseMoved(GLFWwindow *pWindow, double x, double y)
 {
-#ifdef AE_DEBUG
-    if (!m_WindowMap.contains(pWindow))
-    {
-        AE_LOG(AE_WARNING, "Tried to record event but Window was not found in WindowManager");
-        return;
-    }
-#endif // AE_DEBUG
-    m_Windows[m_WindowMap[pWindow]]->OnMouseMoved(x, y);
+    QueueInput(pWindow, { .x = x, .y = y, .type = InputRecordType::MOUSE_MOVED });
 }
 
 void ae::WindowManager::RecordMouseScrolled(GLFWwindow *pWindow, double x, double y)
 {
-#ifdef AE_DEBUG
-    if (!m_WindowMap.contains(pWindow))
-    {
-        AE_LOG(AE_WARNING, "Tried to record event but Window was not found in WindowManager");
-        return;
-    }
-#endif // AE_DEBUG
-    m_Windows[m_WindowMap[pWindow]]->OnMouseScrolled(x, y);
+    QueueInput(pWindow, { .x = x, .y = y, .type = InputRecordType::MOUSE_SCROLLED });
 }
 
 void ae::WindowManager::RecordMouseEntered(GLFWwindow *pWindow, int entered)
 {
-#ifdef AE_DEBUG
-    if (!m_WindowMap.contains(pWindow))
+    Window *pTarget = FindWindow(pWindow);
+
+    // Restored here, as GLFW only allows it on the main thread and the record may be dispatched elsewhere
+    if (pTarget && entered)
     {
-        AE_LOG(AE_WARNING, "Tried to record event but Window was not found in WindowManager");
-        return;
+        glfwSetCursor(pWindow, pTarget->m_CurrentCursor.GetCursor());
     }
-#endif // AE_DEBUG
-    m_Windows[m_WindowMap[pWindow]]->OnMouseEntered(entered);
+
+    QueueInput(pWindow, { .a = entered, .type = InputRecordType::MOUSE_ENTERED });
 }
 
 void ae::WindowManager::RecordWindowResize(GLFWwindow *pWindow, uint32_t width, uint32_t height)
 {
-#ifdef AE_DEBUG
-    if (!m_WindowMap.contains(pWindow))
-    {
-        AE_LOG(AE_WARNING, "Tried to record event but Window was not found in WindowManager");
-        return;
-    }
-#endif // AE_DEBUG
-    m_Windows[m_WindowMap[pWindow]]->OnWindowResize(width, height);
+    Forward(pWindow, [=](Window &window) { window.OnWindowResize(width, height); });
 }
 
 void ae::WindowManager::RecordWindowFocused(GLFWwindow *pWindow, int focused)
 {
-#ifdef AE_DEBUG
-    if (!m_WindowMap.contains(pWindow))
-    {
-        AE_LOG(AE_WARNING, "Tried to record event but Window was not found in WindowManager");
-        return;
-    }
-#endif // AE_DEBUG
-    m_Windows[m_WindowMap[pWindow]]->OnWindowFocused(focused);
+    Forward(pWindow, [=](Window &window) { window.OnWindowFocused(focused); });
 }
 
 void ae::WindowManager::RecordWindowMinimalized(GLFWwindow *pWindow)
 {
-#ifdef AE_DEBUG
-    if (!m_WindowMap.contains(pWindow))
-    {
-        AE_LOG(AE_WARNING, "Tried to record event but Window was not found in WindowManager");
-        return;
-    }
-#endif // AE_DEBUG
-    m_Windows[m_WindowMap[pWindow]]->OnWindowMinimalized();
+    Forward(pWindow, [](Window &window) { window.OnWindowMinimalized(); });
 }
 
 void ae::WindowManager::RecordWindowMaximalized(GLFWwindow *pWindow)
 {
-#ifdef AE_DEBUG
-    if (!m_WindowMap.contains(pWindow))
-    {
-        AE_LOG(AE_WARNING, "Tried to record event but Window was not found in WindowManager");
-        return;
-    }
-#endif // AE_DEBUG
-    m_Windows[m_WindowMap[pWindow]]->OnWindowMaximalized();
+    Forward(pWindow, [](Window &window) { window.OnWindowMaximalized(); });
 }
 
 void ae::WindowManager::RecordWindowRestored(GLFWwindow *pWindow)
 {
-#ifdef AE_DEBUG
-    if (!m_WindowMap.contains(pWindow))
-    {
-        AE_LOG(AE_WARNING, "Tried to record event but Window was not found in WindowManager");
-        return;
-    }
-#endif // AE_DEBUG
-    m_Windows[m_WindowMap[pWindow]]->OnWindowRestored();
+    Forward(pWindow, [](Window &window) { window.OnWindowRestored(); });
 }
 
 void ae::WindowManager::RecordWindowMoved(GLFWwindow *pWindow, uint32_t x, uint32_t y)
 {
-#ifdef AE_DEBUG
-    if (!m_WindowMap.contains(pWindow))
-    {
-        AE_LOG(AE_WARNING, "Tried to record event but Window was not found in WindowManager");
-        return;
-    }
-#endif // AE_DEBUG
-    m_Windows[m_WindowMap[pWindow]]->OnWindowMoved(x, y);
+    Forward(pWindow, [=](Window &window) { window.OnWindowMoved(x, y); });
 }
 
 void ae::WindowManager::RecordMonitor(GLFWmonitor *pMonitor, int event)
 {
     for (Window *pWindow : m_Windows)
     {
-        pWindow->OnMonitor(pMonitor, event);
+        if (pWindow)
+        {
+            Forward(pWindow, [=](Window &window) { window.OnMonitor(pMonitor, event); });
+        }
     }
 }
 
 void ae::WindowManager::RecordFramebufferResize(GLFWwindow *pWindow, uint32_t width, uint32_t height)
 {
-#ifdef AE_DEBUG
-    if (!m_WindowMap.contains(pWindow))
-    {
-        AE_LOG(AE_WARNING, "Tried to record event but Window was not found in WindowManager");
-        return;
-    }
-#endif // AE_DEBUG
-    m_Windows[m_WindowMap[pWindow]]->OnFramebufferResize(width, height);
+    Forward(pWindow, [=](Window &window) { window.OnFramebufferResize(width, height); });
 }
 
 void ae::WindowManager::RecordContentScaleChanged(GLFWwindow *pWindow, float xScale, float yScale)
 {
-#ifdef AE_DEBUG
-    if (!m_WindowMap.contains(pWindow))
-    {
-        AE_LOG(AE_WARNING, "Tried to record event but Window was not found in WindowManager");
-        return;
-    }
-#endif // AE_DEBUG
-    m_Windows[m_WindowMap[pWindow]]->OnContentScaleChanged(xScale, yScale);
+    Forward(pWindow, [=](Window &window) { window.OnContentScaleChanged(xScale, yScale); });
 }
 
 void ae::WindowManager::RecordFileDrop(GLFWwindow *pWindow, int count, const char **paths)
 {
-#ifdef AE_DEBUG
-    if (!m_WindowMap.contains(pWindow))
-    {
-        AE_LOG(AE_WARNING, "Tried to record event but Window was not found in WindowManager");
-        return;
-    }
-#endif // AE_DEBUG
-    m_Windows[m_WindowMap[pWindow]]->OnFileDrop(count, paths);
+    // The paths are only valid during the callback
+    std::vector<std::string> pathList(paths, paths + count);
+
+    Forward(pWindow, [pathList = std::move(pathList)](Window &window)
+            {
+                std::vector<const char *> pathPointers;
+                pathPointers.reserve(pathList.size());
+
+                for (const std::string &path : pathList)
+                {
+                    pathPointers.push_back(path.c_str());
+                }
+
+                window.OnFileDrop(static_cast<int>(pathPointers.size()), pathPointers.data());
+            });
 }
 
 void ae::WindowManager::RecordWindowClose(GLFWwindow *pWindow)
 {
-#ifdef AE_DEBUG
-    if (!m_WindowMap.contains(pWindow))
+    // GLFW sets should-close before calling back. A render thread would see it and stop before the close is
+    // dispatched, so the flag is cleared until the window's layers and callbacks have allowed the close.
+    if (IsEventLoopRunning())
     {
-        AE_LOG(AE_WARNING, "Tried to record event but Window was not found in WindowManager");
-        return;
+        glfwSetWindowShouldClose(pWindow, GLFW_FALSE);
     }
-#endif // AE_DEBUG
-    m_Windows[m_WindowMap[pWindow]]->OnWindowClose();
+
+    Forward(pWindow, [](Window &window) { window.OnWindowClose(); });
 }
 
 void ae::WindowManager::RecordControllerConnected(int controllerId)
 {
+    // Gamepad mappings are main-thread-only queries, so windows only get the result
+    bool isGamepad = Controller::IsConnected(static_cast<uint32_t>(controllerId));
+
     for (Window *pWindow : m_Windows)
     {
-        pWindow->OnControllerConnected(controllerId);
+        if (pWindow)
+        {
+            Forward(pWindow, [=](Window &window) { window.OnControllerConnected(controllerId, isGamepad); });
+        }
     }
 }
 
@@ -430,14 +406,72 @@ void ae::WindowManager::RecordControllerDisconnected(int controllerId)
 {
     for (Window *pWindow : m_Windows)
     {
-        pWindow->OnControllerDisconnected(controllerId);
+        if (pWindow)
+        {
+            Forward(pWindow, [=](Window &window) { window.OnControllerDisconnected(controllerId); });
+        }
     }
 }
 
-void ae::WindowManager::DeactivateAllWindows()
+void ae::WindowManager::RunEventLoop()
 {
-    for (Window *pWindow : m_Windows)
+    m_EventLoopRunning.store(true, std::memory_order_release);
+
+    // Events are handled as soon as they arrive; the timeout only bounds how late the loop notices that the
+    // last render thread has stopped when nothing wakes it
+    while (std::any_of(m_Windows.begin(), m_Windows.end(),
+                       [](const Window *pWindow) { return pWindow && pWindow->IsRenderThreadRunning(); }))
     {
-        pWindow->Deactivate();
+        glfwWaitEventsTimeout(s_EventLoopTimeout);
+
+        // Every pad once for all windows; render threads wake the loop each frame they need a fresh sample
+        ControllerStates controllers;
+        Window::PollControllers(controllers);
+
+        for (Window *pWindow : m_Windows)
+        {
+            if (pWindow && pWindow->IsRenderThreadRunning())
+            {
+                pWindow->SamplePlatformState(controllers);
+            }
+        }
     }
+
+    m_EventLoopRunning.store(false, std::memory_order_release);
+}
+
+void ae::WindowManager::Forward(GLFWwindow *pWindow, std::function<void(Window &)> event)
+{
+    Window *pTarget = FindWindow(pWindow);
+
+    if (pTarget)
+    {
+        Forward(pTarget, std::move(event));
+    }
+}
+
+ae::Window *ae::WindowManager::FindWindow(GLFWwindow *pWindow)
+{
+    Window *pTarget = static_cast<Window *>(glfwGetWindowUserPointer(pWindow));
+
+#ifdef AE_DEBUG
+    if (!pTarget)
+    {
+        AE_LOG(AE_WARNING, "Tried to record event but Window was not found in WindowManager");
+    }
+#endif // AE_DEBUG
+
+    return pTarget;
+}
+
+void ae::WindowManager::Forward(Window *pWindow, std::function<void(Window &)> event)
+{
+    if (!IsEventLoopRunning())
+    {
+        event(*pWindow);
+        return;
+    }
+
+    std::scoped_lock lock(pWindow->m_DeferredEventMutex);
+    pWindow->m_DeferredEvents.push_back(std::move(event));
 }
@@ -2,11 +2,13 @@
 
 #include "Log.h"
 #include "Window.h"
+#include "input/InputQueue.h"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include <atomic>
+#include <functional>
 #include <stdint.h>
-#include <unordered_map>
 #include <vector>
 
 namespace ae
@@ -52,7 +54,13 @@ class WindowManager
     void RecordControllerConnected(int controllerId);
     void RecordControllerDisconnected(int controllerId);
 
-    void DeactivateAllWindows();
+    // Threaded event mode (see Window::RunEventLoop). While the loop runs, windows do not poll in BeginFrame and
+    // window events are deferred to their render threads instead of being dispatched from the callbacks.
+    void RunEventLoop();
+    [[nodiscard]] inline bool IsEventLoopRunning() const
+    {
+        return m_EventLoopRunning.load(std::memory_order_acquire);
+    }
 
     void EnsureInitialized();
 
@@ -60,9 +68,22 @@ class WindowManager
     void Init();
     void Terminate();
 
+    // Input callbacks only timestamp and queue; the window dispatches the records later (see InputDispatch)
+    void QueueInput(GLFWwindow *pWindow, InputRecord record);
+    // Window events are dispatched right away, or deferred to the window's next BeginFrame while the loop runs
+    void Forward(GLFWwindow *pWindow, std::function<void(Window &)> event);
+    void Forward(Window *pWindow, std::function<void(Window &)> event);
+
+    // Callbacks reach their window through the GLFW user pointer, set by AddWindow
+    static Window *FindWindow(GLFWwindow *pWindow);
+
   private:
     bool m_Initialized;
+    std::atomic<bool> m_EventLoopRunning = false;
+
+    static constexpr double s_EventLoopTimeout = 0.1;
+    // Slot map: a window keeps its slot until it is removed, and removed windows leave a null slot for reuse
     std::vector<Window *> m_Windows;
-    std::unordered_map<GLFWwindow *, uint32_t> m_WindowMap;
+    std::vector<uint32_t> m_FreeSlots;
 };
 } // namespace ae
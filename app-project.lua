@@ -38,6 +38,30 @@ if vulkanAvailable then
 	end
 end
 
+newoption({
+	trigger = "egl",
+	description = "Create headless OpenGL windows on surfaceless EGL contexts (Linux, Mesa's EGL_MESA_platform_surfaceless)",
+})
+
+-- Surfaceless EGL is opt-in, since it moves every headless OpenGL window off the display even when one exists
+local function detect_egl()
+	if not _OPTIONS["egl"] then
+		return false
+	end
+	if os.target() == "linux" and os.isfile("/usr/include/EGL/egl.h") then
+		return true
+	end
+	print(">> --egl given but EGL headers were not found, headless OpenGL windows keep using GLFW")
+	return false
+end
+
+local eglAvailable = detect_egl()
+AE_EGL_AVAILABLE = eglAvailable -- Export as global for parent projects
+
+if eglAvailable then
+	print(">> Surfaceless EGL enabled")
+end
+
 include(log_lib_dir .. "/log-project.lua")
 include(event_lib_dir .. "/event-project.lua")
 
@@ -296,5 +320,10 @@ if vulkanAvailable then
 	filter({})
 end
 
+if eglAvailable then
+	defines({ "AE_EGL" })
+	links({ "EGL" })
+end
+
 pchheader(path.getabsolute(app_lib_src .. "/src/general/pch.h"))
 pchsource(app_lib_src .. "/src/general/pch.cpp")
@@ -201,6 +201,12 @@ if AE_VULKAN_AVAILABLE then
 	filter({})
 end
 
+-- Use the global AE_EGL_AVAILABLE set by app-project.lua
+if AE_EGL_AVAILABLE then
+	defines({ "AE_EGL" })
+	links({ "EGL" })
+end
+
 pchheader(path.getabsolute("sandbox/src/general/pch.h"))
 pchsource("sandbox/src/general/pch.cpp")
 
@@ -314,7 +320,7 @@ newaction({
 	trigger = "gmake-gcc",
 	description = "Generate GNU Makefiles (gmake) using GCC on *nix",
 	execute = function()
-		os.execute("premake5 gmake --cc=gcc")
+		os.execute("premake5 gmake --cc=gcc" .. (_OPTIONS["egl"] and " --egl" or ""))
 	end,
 })
 
@@ -322,6 +328,6 @@ newaction({
 	trigger = "gmake-clang",
 	description = "Generate GNU Makefiles (gmake) using Clang on *nix",
 	execute = function()
-		os.execute("premake5 gmake --cc=clang")
+		os.execute("premake5 gmake --cc=clang" .. (_OPTIONS["egl"] and " --egl" or ""))
 	end,
 })
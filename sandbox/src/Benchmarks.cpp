@@ -0,0 +1,224 @@
+#include "general/pch.h"
+
+#include "Benchmarks.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "Window.h"
+
+namespace
+{
+
+// Every allocation through the global operator new, for the steady-state frame check. Over-aligned allocations
+// keep the default operators and are not counted.
+constinit std::atomic<uint64_t> s_AllocationCount = 0;
+
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    s_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (void *pMemory = std::malloc(size == 0 ? 1 : size))
+    {
+        return pMemory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pMemory) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete(void *pMemory, std::size_t) noexcept
+{
+    std::free(pMemory);
+}
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double NanosecondsPer(Clock::duration duration, uint64_t count)
+{
+    return std::chrono::duration<double, std::nano>(duration).count() / static_cast<double>(count);
+}
+
+// Only shown windows get GLFW input callbacks, so the input benchmarks use small windowed ones, created minimized
+ae::WindowDesc InputBenchmarkDesc()
+{
+    ae::WindowDesc windowDesc;
+    windowDesc.title = "Sandbox Benchmark";
+    windowDesc.width = 320;
+    windowDesc.height = 240;
+    windowDesc.minimized = true;
+    windowDesc.vsync = false;
+    windowDesc.type = ae::WindowType::WINDOWED;
+    windowDesc.graphicsAPI = ae::GraphicsAPI::OPENGL;
+
+    return windowDesc;
+}
+
+// The callback GLFW calls on cursor motion, taken back out of GLFW so the benchmarks can call it directly
+GLFWcursorposfun GetCursorPosCallback(GLFWwindow *pWindow)
+{
+    GLFWcursorposfun callback = glfwSetCursorPosCallback(pWindow, nullptr);
+    glfwSetCursorPosCallback(pWindow, callback);
+
+    return callback;
+}
+
+// Cost of a GLFW input callback up to the queued record, which includes finding the Window of the GLFWwindow.
+// The callbacks cycle through the windows, so more windows do not hit the same one every time.
+void BenchmarkCallbackLookup(uint32_t windowCount)
+{
+    constexpr uint32_t s_Iterations = 1u << 20;
+    constexpr uint32_t s_Batch = 512; // Below the input queue's capacity, so no record is dropped
+
+    std::vector<std::unique_ptr<ae::Window>> windows;
+
+    for (uint32_t i = 0; i < windowCount; i++)
+    {
+        windows.push_back(std::make_unique<ae::Window>(InputBenchmarkDesc()));
+        windows.back()->Create();
+    }
+
+    GLFWcursorposfun callback = GetCursorPosCallback(windows.front()->GetWindow());
+    Clock::duration elapsed{};
+
+    for (uint32_t done = 0; done < s_Iterations; done += s_Batch)
+    {
+        Clock::time_point start = Clock::now();
+
+        for (uint32_t i = 0; i < s_Batch; i++)
+        {
+            callback(windows[i % windowCount]->GetWindow(), static_cast<double>(i), static_cast<double>(done));
+        }
+
+        elapsed += Clock::now() - start;
+
+        // Drained outside the timing, so every queue has room for the next batch
+        for (std::unique_ptr<ae::Window> &pWindow : windows)
+        {
+            pWindow->DispatchInput();
+        }
+    }
+
+    AE_LOG(AE_INFO, "GLFW callback to queued input record with {} window(s): {:.1f} ns per callback", windowCount,
+           NanosecondsPer(elapsed, s_Iterations));
+
+    for (std::unique_ptr<ae::Window> &pWindow : windows)
+    {
+        pWindow->Destroy();
+    }
+}
+
+// Throughput of mouse moves from the GLFW callback to a subscribed Window callback. Each move gets its own
+// DispatchInput, since moves queued together are coalesced into one. Without a layer stack no event object is
+// built; attaching one, even an empty one, adds building and dispatching the events, as every dispatch did before.
+void BenchmarkMouseMoveDispatch(ae::LayerStack *pLayerStack)
+{
+    constexpr uint32_t s_Iterations = 1u << 18;
+
+    ae::Window window(InputBenchmarkDesc());
+    window.Create();
+    window.SetLayerStack(pLayerStack);
+
+    uint64_t moves = 0;
+    window.SetOnMouseMovedCB([&moves](float, float) { moves++; });
+
+    GLFWcursorposfun callback = GetCursorPosCallback(window.GetWindow());
+
+    Clock::time_point start = Clock::now();
+
+    for (uint32_t i = 0; i < s_Iterations; i++)
+    {
+        callback(window.GetWindow(), static_cast<double>(i & 1023), static_cast<double>(i >> 10));
+        window.DispatchInput();
+    }
+
+    Clock::duration elapsed = Clock::now() - start;
+
+    AE_LOG(AE_INFO, "Mouse move dispatch {}: {:.1f} ns per move, {} callbacks invoked",
+           pLayerStack ? "with a layer stack" : "to callbacks only", NanosecondsPer(elapsed, s_Iterations), moves);
+
+    window.SetLayerStack(nullptr);
+    window.Destroy();
+}
+
+// The per-frame Vulkan path must not allocate once it is warmed up: a headless window renders frames and any
+// operator new between them fails the check. Allocations made by the driver through malloc are not counted.
+bool CheckSteadyStateAllocations()
+{
+    constexpr uint32_t s_WarmUpFrames = 64;
+    constexpr uint32_t s_CheckedFrames = 256;
+
+    ae::WindowDesc windowDesc;
+    windowDesc.title = "Sandbox Allocation Check";
+    windowDesc.width = 320;
+    windowDesc.height = 240;
+    windowDesc.fps = 1000; // Headless windows are paced by the frame limiter only
+    windowDesc.type = ae::WindowType::HEADLESS;
+    windowDesc.graphicsAPI = ae::GraphicsAPI::VULKAN;
+
+    ae::Window window(windowDesc);
+    window.Create();
+
+    uint64_t allocations = 0;
+
+    for (uint32_t frame = 0; frame < s_WarmUpFrames + s_CheckedFrames; frame++)
+    {
+        uint64_t before = s_AllocationCount.load(std::memory_order_relaxed);
+
+        window.SetActive();
+        window.BeginFrame();
+        window.EndFrame();
+
+        if (frame >= s_WarmUpFrames)
+        {
+            allocations += s_AllocationCount.load(std::memory_order_relaxed) - before;
+        }
+    }
+
+    window.Destroy();
+
+    if (allocations != 0)
+    {
+        AE_LOG(AE_ERROR, "Steady-state frames allocated {} times over {} frames", allocations, s_CheckedFrames);
+        return false;
+    }
+
+    AE_LOG(AE_INFO, "Steady-state frames made no allocations over {} frames", s_CheckedFrames);
+    return true;
+}
+
+} // namespace
+
+bool RunBenchmarks()
+{
+    try
+    {
+        BenchmarkCallbackLookup(1);
+        BenchmarkCallbackLookup(16);
+
+        ae::LayerStack layerStack;
+        BenchmarkMouseMoveDispatch(nullptr);
+        BenchmarkMouseMoveDispatch(&layerStack);
+
+        return CheckSteadyStateAllocations();
+    }
+
+    catch (const std::exception &e)
+    {
+        AE_LOG(AE_ERROR, "{}", e.what());
+        return false;
+    }
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+// Microbenchmarks and checks for the library's per-frame paths, run with "Sandbox --bench" instead of the demo.
+// Every result is logged; returns false if a check failed.
+bool RunBenchmarks();
@@ -7,6 +7,10 @@
 // this library can be used to create a basic graphics application.
 
 #include <fstream>
+#include <string_view>
+
+// Benchmarks of the library's per-frame paths, run with "Sandbox --bench"
+#include "Benchmarks.h"
 
 // All headers included in the library
 #include "DearImGui.h"
@@ -20,6 +24,9 @@
 // Static pointer so the ImGui interface can access the Window
 static ae::Window *s_pWindow = nullptr;
 
+// Input of the demo window is recorded here and replayed on a headless window afterwards
+static const char *s_pRecordingPath = "sandbox.aeir";
+
 static void OnInterfaceUpdate()
 {
     // This function is called every frame as the ImGui interface is updated
@@ -65,12 +72,44 @@ static void OnInterfaceUpdate()
     ImGui::End();
 }
 
-static void Demo()
+static void ReplayHeadless()
 {
-    // Configure log sinks so we can see output
-    ae::Logger::Get().AddConsoleSink("Console", ae::LogSinkConsoleKind::STDOUT, AE_TRACE, AE_WARNING);
-    ae::Logger::Get().AddConsoleSink("Errors", ae::LogSinkConsoleKind::STDERR, AE_ERROR);
+    // Headless windows are never shown, but they still receive replayed input
+    ae::WindowDesc windowDesc;
+    windowDesc.title = "Sandbox Replay";
+    windowDesc.width = 1280;
+    windowDesc.height = 720;
+    windowDesc.type = ae::WindowType::HEADLESS;
+    windowDesc.graphicsAPI = ae::GraphicsAPI::VULKAN;
+
+    ae::Window window(windowDesc);
+    window.Create();
+
+    uint32_t escapeCount = 0;
+
+    // The replay stops by itself after the last recorded frame
+    window.StartInputReplay(s_pRecordingPath, ae::ReplayTiming::AS_FAST_AS_POSSIBLE);
+
+    while (window.IsReplayingInput())
+    {
+        window.SetActive();
+        window.BeginFrame();
+
+        if (window.GetKeyboard().IsKeyPressed(ae::Key::ESCAPE))
+        {
+            escapeCount++;
+        }
+
+        window.EndFrame();
+    }
+
+    AE_LOG(AE_INFO, "Replayed escape on {} frames", escapeCount);
+
+    window.Destroy();
+}
 
+static void Demo()
+{
     // We wrap the code in a try-catch block to catch any exceptions that might be thrown
     try
     {
@@ -112,6 +151,9 @@ static void Demo()
         // The function from before must also be specified to be called every frame
         window.SetOnInterfaceUpdateCB(OnInterfaceUpdate);
 
+        // Everything the window receives as input is recorded and written out when the window is destroyed
+        window.StartInputRecording(s_pRecordingPath);
+
         // Update loop
         while (!window.ShouldClose())
         {
@@ -136,6 +178,9 @@ static void Demo()
         window.ResetCursor();
         window.ResetIconSet();
         window.Destroy();
+
+        // The recording can then be replayed deterministically, here without showing a window
+        ReplayHeadless();
     }
 
     // If any exceptions are thrown, we catch them here
@@ -146,10 +191,19 @@ static void Demo()
     }
 }
 
-int main()
+int main(int argc, char **argv)
 {
     try
     {
+        // Configure log sinks so we can see output
+        ae::Logger::Get().AddConsoleSink("Console", ae::LogSinkConsoleKind::STDOUT, AE_TRACE, AE_WARNING);
+        ae::Logger::Get().AddConsoleSink("Errors", ae::LogSinkConsoleKind::STDERR, AE_ERROR);
+
+        if (argc > 1 && std::string_view(argv[1]) == "--bench")
+        {
+            return RunBenchmarks() ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+
         Demo();
         return EXIT_SUCCESS;
     }